@@ -0,0 +1,274 @@
+#include "re_actuator.h"
+#include "response_executor.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+
+typedef struct {
+    bool configured;
+    re_controller_config_t config;
+
+    pthread_mutex_t lock;
+    pthread_cond_t batch_done;
+
+    // 令牌桶
+    double tokens;
+    uint64_t last_refill_ns;
+
+    // 命令合并：提交者把区域并入 pending，由一个 leader 线程按批发送
+    uint32_t pending[RE_ACT_OP_COUNT];
+    uint32_t failed[RE_ACT_OP_COUNT];
+    uint64_t superseded[RE_ACT_OP_COUNT][32];  // 各区域该操作被更高优先级操作取代时所在的批次号
+    uint64_t next_batch;              // 最近开始发送的批次号
+    uint64_t done_batch;              // 最近完成的批次号
+    bool leader_active;
+    bool session_open;                // 驱动会话已预先打开
+} controller_t;
+
+// === 控制器状态 ===
+static struct {
+    controller_t controllers[RE_ACTUATOR_MAX_CONTROLLERS];
+    uint32_t mapped_zones;            // 已分配给控制器的区域
+    pthread_rwlock_t map_lock;
+    pthread_once_t once;
+} actuator_state = { .map_lock = PTHREAD_RWLOCK_INITIALIZER, .once = PTHREAD_ONCE_INIT };
+
+static const char* const op_names[RE_ACT_OP_COUNT] = { "锁定", "解锁", "恢复" };
+
+// 同一批次内冲突操作的优先级：解锁（疏散）高于锁定，锁定高于恢复
+static const int op_priority[RE_ACT_OP_COUNT] = { 1, 2, 0 };
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void actuator_init_once(void) {
+    for (int i = 0; i < RE_ACTUATOR_MAX_CONTROLLERS; i++) {
+        pthread_mutex_init(&actuator_state.controllers[i].lock, NULL);
+        pthread_cond_init(&actuator_state.controllers[i].batch_done, NULL);
+    }
+}
+
+// 内置驱动存根
+static int stub_driver(uint16_t controller, re_actuator_op_t op, uint32_t zones, void* user) {
+    (void)user;
+    printf("[HARDWARE] 控制器 %d %s门禁，区域: 0x%08X\n", controller, op_names[op], zones);
+    return 0;
+}
+
+// 取得一个令牌，必要时睡眠等待补充，调用者持有 ctrl->lock
+static void controller_take_token_locked(controller_t* ctrl) {
+    uint16_t rate = ctrl->config.max_commands_per_sec;
+    if (rate == 0) return;
+
+    double burst = ctrl->config.burst ? ctrl->config.burst : 1;
+    for (;;) {
+        uint64_t now = monotonic_ns();
+        ctrl->tokens += (double)(now - ctrl->last_refill_ns) * rate / 1e9;
+        if (ctrl->tokens > burst) ctrl->tokens = burst;
+        ctrl->last_refill_ns = now;
+
+        if (ctrl->tokens >= 1.0) {
+            ctrl->tokens -= 1.0;
+            return;
+        }
+
+        uint64_t wait_ns = (uint64_t)((1.0 - ctrl->tokens) * 1e9 / rate) + 1;
+        struct timespec ts = { .tv_sec = (time_t)(wait_ns / 1000000000ull),
+                               .tv_nsec = (long)(wait_ns % 1000000000ull) };
+        pthread_mutex_unlock(&ctrl->lock);
+        while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {}
+        pthread_mutex_lock(&ctrl->lock);
+    }
+}
+
+// 发送一批命令，调用者持有 ctrl->lock 且为 leader
+static void controller_run_batch_locked(controller_t* ctrl, uint16_t id) {
+    uint32_t batch[RE_ACT_OP_COUNT];
+    memcpy(batch, ctrl->pending, sizeof(batch));
+    memset(ctrl->pending, 0, sizeof(ctrl->pending));
+    uint64_t batch_id = ++ctrl->next_batch;
+
+    re_actuator_driver_fn driver = ctrl->config.driver ? ctrl->config.driver : stub_driver;
+    void* driver_ctx = ctrl->config.driver_ctx;
+    bool multi_door = ctrl->config.multi_door;
+
+    for (int op = 0; op < RE_ACT_OP_COUNT; op++) {
+        uint32_t zones = batch[op];
+        while (zones) {
+            uint32_t cmd_zones = multi_door ? zones : (zones & -zones);
+            zones &= ~cmd_zones;
+
+            controller_take_token_locked(ctrl);
+            pthread_mutex_unlock(&ctrl->lock);
+            int rc = driver(id, (re_actuator_op_t)op, cmd_zones, driver_ctx);
+            pthread_mutex_lock(&ctrl->lock);
+
+            if (rc == 0) {
+                ctrl->failed[op] &= ~cmd_zones;
+            } else {
+                ctrl->failed[op] |= cmd_zones;
+                printf("[HARDWARE] 控制器 %d 命令失败，区域: 0x%08X\n", id, cmd_zones);
+            }
+        }
+    }
+
+    ctrl->done_batch = batch_id;
+    pthread_cond_broadcast(&ctrl->batch_done);
+}
+
+static int controller_submit(uint16_t id, re_actuator_op_t op, uint32_t zones) {
+    controller_t* ctrl = &actuator_state.controllers[id];
+
+    pthread_mutex_lock(&ctrl->lock);
+
+    // 同一区域在同一批次内按优先级取舍，被取代的提交者会收到冲突错误
+    uint64_t my_batch = ctrl->next_batch + 1;  // 下一批发送时包含本次区域
+    uint32_t accepted = zones;
+    for (int other = 0; other < RE_ACT_OP_COUNT; other++) {
+        if (other == (int)op) continue;
+        uint32_t overlap = ctrl->pending[other] & zones;
+        if (!overlap) continue;
+        if (op_priority[other] > op_priority[op]) {
+            accepted &= ~overlap;
+        } else {
+            ctrl->pending[other] &= ~overlap;
+            for (uint32_t rest = overlap; rest; rest &= rest - 1) {
+                ctrl->superseded[other][__builtin_ctz(rest)] = my_batch;
+            }
+        }
+    }
+    for (uint32_t rest = zones & ~accepted; rest; rest &= rest - 1) {
+        ctrl->superseded[op][__builtin_ctz(rest)] = my_batch;
+    }
+    ctrl->pending[op] |= accepted;
+
+    while (ctrl->done_batch < my_batch) {
+        if (ctrl->leader_active) {
+            pthread_cond_wait(&ctrl->batch_done, &ctrl->lock);
+            continue;
+        }
+
+        // 成为 leader，持续发送直到没有排队命令
+        ctrl->leader_active = true;
+        for (;;) {
+            bool any = false;
+            for (int i = 0; i < RE_ACT_OP_COUNT; i++) any |= ctrl->pending[i] != 0;
+            if (!any) break;
+            controller_run_batch_locked(ctrl, id);
+        }
+        ctrl->leader_active = false;
+        pthread_cond_broadcast(&ctrl->batch_done);
+    }
+
+    int result = (ctrl->failed[op] & accepted) ? RESPONSE_ERROR_HARDWARE_UNAVAILABLE : 0;
+    for (uint32_t rest = zones; rest && result == 0; rest &= rest - 1) {
+        if (ctrl->superseded[op][__builtin_ctz(rest)] == my_batch) result = RESPONSE_ERROR_CONFLICT;
+    }
+    pthread_mutex_unlock(&ctrl->lock);
+    return result;
+}
+
+// === 公开API实现 ===
+
+int32_t re_controller_configure(uint16_t id, const re_controller_config_t* config) {
+    if (id >= RE_ACTUATOR_MAX_CONTROLLERS || !config || config->zones == 0) {
+        return RESPONSE_ERROR_INVALID_PARAM;
+    }
+    pthread_once(&actuator_state.once, actuator_init_once);
+
+    pthread_rwlock_wrlock(&actuator_state.map_lock);
+    for (int i = 0; i < RE_ACTUATOR_MAX_CONTROLLERS; i++) {
+        controller_t* other = &actuator_state.controllers[i];
+        if (i != id && other->configured) {
+            pthread_mutex_lock(&other->lock);
+            other->config.zones &= ~config->zones;
+            other->configured = other->config.zones != 0;
+            pthread_mutex_unlock(&other->lock);
+        }
+    }
+
+    controller_t* ctrl = &actuator_state.controllers[id];
+    pthread_mutex_lock(&ctrl->lock);
+    if (ctrl->session_open && ctrl->config.session != config->session) {
+        // 替换驱动前关闭旧驱动预先打开的会话
+        ctrl->config.session(id, false, ctrl->config.driver_ctx);
+        ctrl->session_open = false;
+    }
+    ctrl->config = *config;
+    ctrl->configured = true;
+    ctrl->tokens = config->burst ? config->burst : 1;
+    ctrl->last_refill_ns = monotonic_ns();
+    pthread_mutex_unlock(&ctrl->lock);
+
+    actuator_state.mapped_zones = 0;
+    for (int i = 0; i < RE_ACTUATOR_MAX_CONTROLLERS; i++) {
+        if (actuator_state.controllers[i].configured) {
+            actuator_state.mapped_zones |= actuator_state.controllers[i].config.zones;
+        }
+    }
+    pthread_rwlock_unlock(&actuator_state.map_lock);
+
+    printf("[HARDWARE] 控制器 %d 已配置，区域: 0x%08X，速率: %d 条/秒%s\n", id, config->zones,
+           config->max_commands_per_sec, config->multi_door ? "，支持多门命令" : "");
+    return RESPONSE_SUCCESS;
+}
+
+int32_t re_actuator_command(re_actuator_op_t op, uint32_t zones) {
+    if (op >= RE_ACT_OP_COUNT) return RESPONSE_ERROR_INVALID_PARAM;
+    if (zones == 0) return RESPONSE_SUCCESS;
+    pthread_once(&actuator_state.once, actuator_init_once);
+
+    int32_t result = RESPONSE_SUCCESS;
+
+    pthread_rwlock_rdlock(&actuator_state.map_lock);
+    uint32_t unmapped = zones & ~actuator_state.mapped_zones;
+    if (unmapped) {
+        printf("[HARDWARE] %s门禁（未配置控制器），区域: 0x%08X\n", op_names[op], unmapped);
+    }
+
+    for (uint16_t id = 0; id < RE_ACTUATOR_MAX_CONTROLLERS; id++) {
+        controller_t* ctrl = &actuator_state.controllers[id];
+        uint32_t ctrl_zones = ctrl->configured ? (zones & ctrl->config.zones) : 0;
+        int rc = ctrl_zones ? controller_submit(id, op, ctrl_zones) : 0;
+        if (rc != 0 && result != RESPONSE_ERROR_HARDWARE_UNAVAILABLE) {
+            result = rc;
+        }
+    }
+    pthread_rwlock_unlock(&actuator_state.map_lock);
+
+    return result;
+}
+
+int32_t re_actuator_prepare(bool open) {
+    pthread_once(&actuator_state.once, actuator_init_once);
+    int32_t result = RESPONSE_SUCCESS;
+    uint32_t changed = 0;
+
+    pthread_rwlock_rdlock(&actuator_state.map_lock);
+    for (uint16_t id = 0; id < RE_ACTUATOR_MAX_CONTROLLERS; id++) {
+        controller_t* ctrl = &actuator_state.controllers[id];
+        pthread_mutex_lock(&ctrl->lock);
+        if (ctrl->configured && ctrl->config.session && ctrl->session_open != open) {
+            // 建立连接可能较慢，期间持有控制器锁，命令会在会话就绪后发送
+            if (ctrl->config.session(id, open, ctrl->config.driver_ctx) == 0) {
+                ctrl->session_open = open;
+                changed++;
+            } else if (open) {
+                result = RESPONSE_ERROR_HARDWARE_UNAVAILABLE;
+                printf("[HARDWARE] 控制器 %d 预先建立会话失败\n", id);
+            } else {
+                ctrl->session_open = false;
+            }
+        }
+        pthread_mutex_unlock(&ctrl->lock);
+    }
+    pthread_rwlock_unlock(&actuator_state.map_lock);
+
+    if (changed) printf("[HARDWARE] 已%s %u 个控制器会话\n", open ? "预先建立" : "关闭", changed);
+    return result;
+}
@@ -0,0 +1,103 @@
+#ifndef RE_ACTUATOR_H
+#define RE_ACTUATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @file re_actuator.h
+ * @brief Rate-limited command path to physical access controllers
+ *
+ * Each controller serves a set of zones and has a token-bucket limiter
+ * sized to what the device can sustain. Commands for a controller that
+ * arrive while it is throttled are coalesced: the next command sent
+ * carries every zone queued in the meantime, using the controller's
+ * multi-door command when it supports one.
+ */
+
+#define RE_ACTUATOR_MAX_CONTROLLERS  32
+
+// Actuator operation enumeration
+typedef enum {
+    RE_ACT_DOOR_LOCK = 0,             // Lock doors
+    RE_ACT_DOOR_UNLOCK,               // Unlock doors (evacuation routes)
+    RE_ACT_DOOR_RESTORE,              // Return doors to normal access schedule
+    RE_ACT_OP_COUNT
+} re_actuator_op_t;
+
+/**
+ * @brief Controller driver callback
+ *
+ * Sends one command to the device. For controllers without multi-door
+ * support `zones` always has exactly one bit set.
+ *
+ * @return 0 on success, negative on failure
+ */
+typedef int (*re_actuator_driver_fn)(uint16_t controller, re_actuator_op_t op,
+                                     uint32_t zones, void* user);
+
+/**
+ * @brief Controller session callback
+ *
+ * Called with `open` true when an escalation is likely, so the driver can
+ * connect to the device before the first command is needed, and with
+ * `open` false when the staged session is no longer wanted. Must not
+ * operate any door.
+ *
+ * @return 0 on success, negative on failure
+ */
+typedef int (*re_actuator_session_fn)(uint16_t controller, bool open, void* user);
+
+// Controller configuration structure
+typedef struct {
+    uint32_t zones;                   // Bitmask of zones served by this controller
+    uint16_t max_commands_per_sec;    // Sustained command rate (0 = unlimited)
+    uint16_t burst;                   // Bucket depth (0 = 1)
+    bool multi_door;                  // Controller accepts one command for many doors
+    re_actuator_driver_fn driver;     // Driver callback, NULL for the built-in stub
+    void* driver_ctx;                 // Passed to the driver and session callbacks
+    re_actuator_session_fn session;   // Session pre-open callback, NULL if the driver has none
+} re_controller_config_t;
+
+/**
+ * @brief Configure (or reconfigure) a physical access controller
+ *
+ * Zones claimed by this controller are released from any other controller.
+ *
+ * @param id Controller identifier (0 .. RE_ACTUATOR_MAX_CONTROLLERS-1)
+ * @param config Controller configuration
+ * @return RESPONSE_SUCCESS on success, error code on failure
+ */
+int32_t re_controller_configure(uint16_t id, const re_controller_config_t* config);
+
+/**
+ * @brief Send an actuator command to every controller serving the zones
+ *
+ * Blocks until the command has been sent (possibly merged with others)
+ * to all affected controllers, waiting for tokens where required. Zones
+ * not served by a configured controller go straight to the stub driver.
+ * If another caller targets the same zone with a different operation
+ * before the command is sent, the higher-priority operation is sent
+ * (unlock over lock over restore) and the other caller gets a conflict.
+ *
+ * @param op Operation to perform
+ * @param zones Bitmask of target zones
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_HARDWARE_UNAVAILABLE
+ *         if any controller command failed, RESPONSE_ERROR_CONFLICT if a
+ *         higher-priority operation superseded it for some zone
+ */
+int32_t re_actuator_command(re_actuator_op_t op, uint32_t zones);
+
+/**
+ * @brief Open or close driver sessions ahead of use
+ *
+ * Calls the session callback of every configured controller whose session
+ * is not already in the requested state.
+ *
+ * @param open true to open sessions, false to close staged ones
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_HARDWARE_UNAVAILABLE
+ *         if a session could not be opened
+ */
+int32_t re_actuator_prepare(bool open);
+
+#endif // RE_ACTUATOR_H
@@ -0,0 +1,469 @@
+#include "re_aio.h"
+#include "response_executor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <stdatomic.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+#define AIO_MAX_WRITE      (1u << 30)
+#define AIO_SYNC_TAG       1ull          // user_data 低位：链接的 fsync
+#define AIO_STOP_TAG       0ull          // 停止完成线程的 NOP
+#define AIO_RETRY_MS       1             // 内核暂时拒绝提交时的重试间隔
+
+// 一次写请求；数据随请求复制，调用者无需保留缓冲区
+typedef struct aio_req {
+    struct aio_req* next;             // 提交失败时串成待完成链表
+    re_aio_done_fn done;
+    void* user;
+    int result;
+    uint32_t pending;                 // 尚未完成的 CQE 数
+    uint32_t len;
+    uint8_t data[];
+} aio_req_t;
+
+// === io_uring 状态 ===
+static struct {
+    int ring_fd;                      // -1 表示同步回退
+    bool tried;                       // 已尝试建立 ring
+    unsigned sq_entries;
+    unsigned cq_entries;
+    _Atomic unsigned* sq_head;
+    _Atomic unsigned* sq_tail;
+    unsigned sq_mask;
+    unsigned* sq_array;
+    struct io_uring_sqe* sqes;
+    _Atomic unsigned* cq_head;
+    _Atomic unsigned* cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe* cqes;
+    void* sq_map;
+    size_t sq_map_len;
+    void* cq_map;
+    size_t cq_map_len;
+    size_t sqes_len;
+    unsigned queued;                  // 已放入 SQ 尚未提交的条目
+    bool submitting;                  // 有线程正在 io_uring_enter 中提交
+    uint32_t inflight;                // 已排队未完成的请求
+    uint32_t failures;
+    pthread_t reaper;
+    pthread_mutex_t lock;             // 保护 SQ 与计数
+    pthread_cond_t changed;
+} aio_state = { .ring_fd = -1, .lock = PTHREAD_MUTEX_INITIALIZER, .changed = PTHREAD_COND_INITIALIZER };
+
+static int sys_io_uring_setup(unsigned entries, struct io_uring_params* params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+// === 同步回退 ===
+
+static int sync_write(int fd, const void* buf, size_t len, off_t offset, uint32_t flags) {
+    const uint8_t* p = buf;
+    size_t left = len;
+    while (left > 0) {
+        ssize_t n = pwrite(fd, p, left, offset);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -errno;
+        }
+        p += n;
+        left -= (size_t)n;
+        offset += n;
+    }
+    if ((flags & RE_AIO_FSYNC) && fsync(fd) != 0) return -errno;
+    if ((flags & RE_AIO_DATASYNC) && !(flags & RE_AIO_FSYNC) && fdatasync(fd) != 0) return -errno;
+    return (int)len;
+}
+
+// 在调用线程上同步完成一次请求，失败同样计入 re_aio_flush 的返回值
+static int32_t sync_fallback(int fd, const void* buf, size_t len, off_t offset, uint32_t flags,
+                             re_aio_done_fn done, void* user) {
+    int result = sync_write(fd, buf, len, offset, flags);
+    if (done) done(result, user);
+    if (result >= 0) return RESPONSE_SUCCESS;
+
+    pthread_mutex_lock(&aio_state.lock);
+    aio_state.failures++;
+    pthread_mutex_unlock(&aio_state.lock);
+    return RESPONSE_ERROR_CRITICAL_FAILURE;
+}
+
+// === 完成处理 ===
+
+static void req_complete(aio_req_t* req) {
+    if (req->done) req->done(req->result, req->user);
+
+    pthread_mutex_lock(&aio_state.lock);
+    aio_state.inflight--;
+    if (req->result < 0) aio_state.failures++;
+    pthread_cond_broadcast(&aio_state.changed);
+    pthread_mutex_unlock(&aio_state.lock);
+    free(req);
+}
+
+// 记录一个 CQE 的结果，请求的全部 CQE 到齐时返回该请求；调用者持有 lock
+static aio_req_t* reap_cqe_locked(const struct io_uring_cqe* cqe) {
+    aio_req_t* req = (aio_req_t*)(uintptr_t)(cqe->user_data & ~AIO_SYNC_TAG);
+    bool is_sync = cqe->user_data & AIO_SYNC_TAG;
+    if (!is_sync) {
+        // 短写会断开链接，后面的 fsync 以 -ECANCELED 结束
+        if (cqe->res < 0) req->result = cqe->res;
+        else if ((uint32_t)cqe->res != req->len) req->result = -EIO;
+        else req->result = cqe->res;
+    } else if (cqe->res < 0 && req->result >= 0) {
+        req->result = cqe->res;
+    }
+    return --req->pending == 0 ? req : NULL;
+}
+
+static void* reaper_thread(void* arg) {
+    (void)arg;
+    bool stop = false;
+
+    while (!stop) {
+        int ret = sys_io_uring_enter(aio_state.ring_fd, 0, 1, IORING_ENTER_GETEVENTS);
+        if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            printf("[AIO] 等待完成事件失败: %s\n", strerror(errno));
+            break;
+        }
+
+        unsigned head = atomic_load_explicit(aio_state.cq_head, memory_order_relaxed);
+        unsigned tail = atomic_load_explicit(aio_state.cq_tail, memory_order_acquire);
+        while (head != tail) {
+            const struct io_uring_cqe* cqe = &aio_state.cqes[head & aio_state.cq_mask];
+            aio_req_t* done = NULL;
+            if (cqe->user_data == AIO_STOP_TAG) {
+                stop = true;
+            } else {
+                // 请求字段由提交线程在 lock 内写入，这里同样在 lock 内读取
+                pthread_mutex_lock(&aio_state.lock);
+                done = reap_cqe_locked(cqe);
+                pthread_mutex_unlock(&aio_state.lock);
+            }
+            head++;
+            atomic_store_explicit(aio_state.cq_head, head, memory_order_release);
+            // 回调在锁外执行
+            if (done) req_complete(done);
+        }
+    }
+    return NULL;
+}
+
+// === 提交 ===
+
+static unsigned sq_free_locked(void) {
+    unsigned tail = atomic_load_explicit(aio_state.sq_tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(aio_state.sq_head, memory_order_acquire);
+    return aio_state.sq_entries - (tail - head);
+}
+
+// 取下一个空闲 SQE，调用者持有 lock 且已用 sq_reserve_locked 确认空间
+static struct io_uring_sqe* sqe_get_locked(void) {
+    unsigned tail = atomic_load_explicit(aio_state.sq_tail, memory_order_relaxed);
+    unsigned idx = tail & aio_state.sq_mask;
+    struct io_uring_sqe* sqe = &aio_state.sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    aio_state.sq_array[idx] = idx;
+    return sqe;
+}
+
+static void sqe_publish_locked(unsigned count) {
+    unsigned tail = atomic_load_explicit(aio_state.sq_tail, memory_order_relaxed);
+    atomic_store_explicit(aio_state.sq_tail, tail + count, memory_order_release);
+    aio_state.queued += count;
+}
+
+// 撤回尚未被内核取走的条目，按 -err 结束其请求；返回全部条目都已撤回的请求
+static aio_req_t* sq_retract_locked(int err) {
+    aio_req_t* failed = NULL;
+    unsigned tail = atomic_load_explicit(aio_state.sq_tail, memory_order_relaxed);
+    for (unsigned i = aio_state.queued; i > 0; i--) {
+        const struct io_uring_sqe* sqe = &aio_state.sqes[(tail - i) & aio_state.sq_mask];
+        if (sqe->user_data == AIO_STOP_TAG) continue;
+        struct io_uring_cqe cqe = { .user_data = sqe->user_data, .res = -err };
+        aio_req_t* done = reap_cqe_locked(&cqe);
+        if (done) {
+            done->next = failed;
+            failed = done;
+        }
+    }
+    atomic_store_explicit(aio_state.sq_tail, tail - aio_state.queued, memory_order_release);
+    aio_state.queued = 0;
+    return failed;
+}
+
+/*
+ * 提交已排队的条目，调用者持有 lock。
+ * 同一时刻只有一个线程进入 io_uring_enter；其他线程排队后直接返回，
+ * 它们的条目由正在提交的线程在下一轮一并提交，形成批量提交。
+ * 提交出错时撤回条目并以错误结束请求；内核暂时无法接收时保留条目，
+ * 由等待者定时重试。
+ */
+static void submit_queued_locked(void) {
+    if (aio_state.submitting) return;
+    aio_state.submitting = true;
+
+    while (aio_state.queued > 0) {
+        unsigned count = aio_state.queued;
+        pthread_mutex_unlock(&aio_state.lock);
+        int ret = sys_io_uring_enter(aio_state.ring_fd, count, 0, 0);
+        int err = errno;
+        pthread_mutex_lock(&aio_state.lock);
+
+        if (ret > 0) {
+            aio_state.queued -= (unsigned)ret;
+        } else if (ret < 0 && err != EINTR && err != EAGAIN && err != EBUSY) {
+            printf("[AIO] 提交失败: %s\n", strerror(err));
+            aio_req_t* failed = sq_retract_locked(err);
+            // 回调在锁外执行
+            pthread_mutex_unlock(&aio_state.lock);
+            while (failed) {
+                aio_req_t* next = failed->next;
+                req_complete(failed);
+                failed = next;
+            }
+            pthread_mutex_lock(&aio_state.lock);
+            break;
+        } else if (ret == 0 || err != EINTR) {
+            // 内核暂时无法接收，留给下一次提交
+            break;
+        }
+    }
+    aio_state.submitting = false;
+    pthread_cond_broadcast(&aio_state.changed);
+}
+
+// 等待状态变化；仍有未提交条目时定时醒来重试，避免无人唤醒
+static void aio_wait_locked(void) {
+    if (aio_state.queued == 0 || aio_state.submitting) {
+        pthread_cond_wait(&aio_state.changed, &aio_state.lock);
+        return;
+    }
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_nsec += AIO_RETRY_MS * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(&aio_state.changed, &aio_state.lock, &ts);
+}
+
+// 等待 SQ 中有 count 个空位；提交后内核立即消费条目，空位随之释放
+static void sq_reserve_locked(unsigned count) {
+    while (sq_free_locked() < count) {
+        if (aio_state.submitting) {
+            pthread_cond_wait(&aio_state.changed, &aio_state.lock);
+            continue;
+        }
+        submit_queued_locked();
+        if (sq_free_locked() < count) aio_wait_locked();
+    }
+}
+
+static int ring_setup(unsigned entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = sys_io_uring_setup(entries, &params);
+    if (fd < 0) return -errno;
+    if (!(params.features & IORING_FEAT_NODROP)) {
+        close(fd);
+        return -ENOTSUP;
+    }
+
+    size_t sq_len = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_len = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single && cq_len > sq_len) sq_len = cq_len;
+
+    void* sq_map = mmap(NULL, sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (sq_map == MAP_FAILED) {
+        close(fd);
+        return -ENOMEM;
+    }
+    void* cq_map = sq_map;
+    if (!single) {
+        cq_map = mmap(NULL, cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (cq_map == MAP_FAILED) {
+            munmap(sq_map, sq_len);
+            close(fd);
+            return -ENOMEM;
+        }
+    }
+    size_t sqes_len = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = mmap(NULL, sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        if (!single) munmap(cq_map, cq_len);
+        munmap(sq_map, sq_len);
+        close(fd);
+        return -ENOMEM;
+    }
+
+    uint8_t* sq = sq_map;
+    uint8_t* cq = cq_map;
+    aio_state.sq_head = (_Atomic unsigned*)(sq + params.sq_off.head);
+    aio_state.sq_tail = (_Atomic unsigned*)(sq + params.sq_off.tail);
+    aio_state.sq_mask = *(unsigned*)(sq + params.sq_off.ring_mask);
+    aio_state.sq_array = (unsigned*)(sq + params.sq_off.array);
+    aio_state.cq_head = (_Atomic unsigned*)(cq + params.cq_off.head);
+    aio_state.cq_tail = (_Atomic unsigned*)(cq + params.cq_off.tail);
+    aio_state.cq_mask = *(unsigned*)(cq + params.cq_off.ring_mask);
+    aio_state.cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    aio_state.sqes = sqes;
+    aio_state.sq_entries = params.sq_entries;
+    aio_state.cq_entries = params.cq_entries;
+    aio_state.sq_map = sq_map;
+    aio_state.sq_map_len = sq_len;
+    aio_state.cq_map = single ? NULL : cq_map;
+    aio_state.cq_map_len = cq_len;
+    aio_state.sqes_len = sqes_len;
+    aio_state.ring_fd = fd;
+    return 0;
+}
+
+static void ring_unmap(void) {
+    munmap(aio_state.sqes, aio_state.sqes_len);
+    if (aio_state.cq_map) munmap(aio_state.cq_map, aio_state.cq_map_len);
+    munmap(aio_state.sq_map, aio_state.sq_map_len);
+    close(aio_state.ring_fd);
+    aio_state.ring_fd = -1;
+}
+
+// === 公开API实现 ===
+
+int32_t re_aio_init(unsigned entries) {
+    pthread_mutex_lock(&aio_state.lock);
+    if (aio_state.tried) {
+        bool active = aio_state.ring_fd >= 0;
+        pthread_mutex_unlock(&aio_state.lock);
+        return active ? RESPONSE_SUCCESS : RESPONSE_ERROR_HARDWARE_UNAVAILABLE;
+    }
+    aio_state.tried = true;
+
+    int rc = ring_setup(entries ? entries : RE_AIO_DEFAULT_ENTRIES);
+    if (rc == 0 && pthread_create(&aio_state.reaper, NULL, reaper_thread, NULL) != 0) {
+        ring_unmap();
+        rc = -EAGAIN;
+    }
+    pthread_mutex_unlock(&aio_state.lock);
+
+    if (rc != 0) {
+        printf("[AIO] io_uring 不可用（%s），使用同步写入\n", strerror(-rc));
+        return RESPONSE_ERROR_HARDWARE_UNAVAILABLE;
+    }
+    printf("[AIO] io_uring 已启用，队列深度 %u\n", aio_state.sq_entries);
+    return RESPONSE_SUCCESS;
+}
+
+int32_t re_aio_write(int fd, const void* buf, size_t len, off_t offset, uint32_t flags,
+                     re_aio_done_fn done, void* user) {
+    if (fd < 0 || offset < 0 || (len > 0 && !buf) || len > AIO_MAX_WRITE) return RESPONSE_ERROR_INVALID_PARAM;
+
+    pthread_mutex_lock(&aio_state.lock);
+    bool tried = aio_state.tried;
+    pthread_mutex_unlock(&aio_state.lock);
+    if (!tried) re_aio_init(0);
+
+    aio_req_t* req = re_aio_active() ? malloc(sizeof(*req) + len) : NULL;
+    if (!req) return sync_fallback(fd, buf, len, offset, flags, done, user);
+    memcpy(req->data, buf, len);
+    req->done = done;
+    req->user = user;
+    req->result = 0;
+    req->len = (uint32_t)len;
+    bool sync = flags & (RE_AIO_DATASYNC | RE_AIO_FSYNC);
+    req->pending = sync ? 2 : 1;
+
+    pthread_mutex_lock(&aio_state.lock);
+    // 每个请求最多占两个 CQE，在途请求数受完成队列容量限制
+    while (aio_state.ring_fd >= 0 && aio_state.inflight >= aio_state.cq_entries / 2) {
+        pthread_cond_wait(&aio_state.changed, &aio_state.lock);
+    }
+    if (aio_state.ring_fd < 0) {
+        // ring 已被关闭，改为同步写入
+        pthread_mutex_unlock(&aio_state.lock);
+        free(req);
+        return sync_fallback(fd, buf, len, offset, flags, done, user);
+    }
+    sq_reserve_locked(sync ? 2 : 1);
+
+    // 写入直接交给内核工作线程，缓冲写不会在提交线程上阻塞；
+    // 各请求可能并发完成，因此总是使用显式偏移
+    struct io_uring_sqe* sqe = sqe_get_locked();
+    sqe->opcode = IORING_OP_WRITE;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t)(uintptr_t)req->data;
+    sqe->len = req->len;
+    sqe->off = (uint64_t)offset;
+    sqe->flags = IOSQE_ASYNC | (sync ? IOSQE_IO_LINK : 0);
+    sqe->user_data = (uint64_t)(uintptr_t)req;
+    sqe_publish_locked(1);
+
+    if (sync) {
+        sqe = sqe_get_locked();
+        sqe->opcode = IORING_OP_FSYNC;
+        sqe->fd = fd;
+        sqe->fsync_flags = (flags & RE_AIO_FSYNC) ? 0 : IORING_FSYNC_DATASYNC;
+        sqe->user_data = (uint64_t)(uintptr_t)req | AIO_SYNC_TAG;
+        sqe_publish_locked(1);
+    }
+    aio_state.inflight++;
+    submit_queued_locked();
+    pthread_mutex_unlock(&aio_state.lock);
+    return RESPONSE_SUCCESS;
+}
+
+uint32_t re_aio_flush(void) {
+    pthread_mutex_lock(&aio_state.lock);
+    while (aio_state.inflight > 0) {
+        // 排队未提交的条目在这里补交
+        submit_queued_locked();
+        if (aio_state.inflight > 0) aio_wait_locked();
+    }
+    uint32_t failures = aio_state.failures;
+    aio_state.failures = 0;
+    pthread_mutex_unlock(&aio_state.lock);
+    return failures;
+}
+
+bool re_aio_active(void) {
+    pthread_mutex_lock(&aio_state.lock);
+    bool active = aio_state.ring_fd >= 0;
+    pthread_mutex_unlock(&aio_state.lock);
+    return active;
+}
+
+void re_aio_shutdown(void) {
+    re_aio_flush();
+
+    pthread_mutex_lock(&aio_state.lock);
+    if (aio_state.ring_fd < 0) {
+        aio_state.tried = false;
+        pthread_mutex_unlock(&aio_state.lock);
+        return;
+    }
+    sq_reserve_locked(1);
+    struct io_uring_sqe* sqe = sqe_get_locked();
+    sqe->opcode = IORING_OP_NOP;
+    sqe->user_data = AIO_STOP_TAG;
+    sqe_publish_locked(1);
+    submit_queued_locked();
+    pthread_mutex_unlock(&aio_state.lock);
+
+    pthread_join(aio_state.reaper, NULL);
+
+    pthread_mutex_lock(&aio_state.lock);
+    ring_unmap();
+    aio_state.tried = false;
+    pthread_mutex_unlock(&aio_state.lock);
+}
@@ -0,0 +1,98 @@
+#ifndef RE_AIO_H
+#define RE_AIO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+/**
+ * @file re_aio.h
+ * @brief Asynchronous durable writes through io_uring
+ *
+ * Journal, event log and archive writers hand their data to this layer
+ * instead of calling write()/fdatasync() themselves. The data is copied,
+ * queued as an io_uring write with an optional linked fsync, and the call
+ * returns immediately; a completion thread reaps the results and runs the
+ * callbacks. Requests queued by concurrent callers are submitted together
+ * in one io_uring_enter() call.
+ *
+ * Writes are always executed by the kernel's worker pool so a buffered
+ * write never stalls the submitting thread. Requests may complete in any
+ * order, so every write carries an explicit file offset; appenders keep
+ * their own end-of-file position. A linked fsync starts only after its
+ * write completed.
+ *
+ * When io_uring is unavailable (old kernel, disabled by sysctl or seccomp)
+ * the same calls fall back to synchronous pwrite()/fdatasync() on the
+ * calling thread, with the callback run before the call returns.
+ */
+
+#define RE_AIO_DEFAULT_ENTRIES   256
+
+#define RE_AIO_DATASYNC          0x01           // fdatasync() after the write
+#define RE_AIO_FSYNC             0x02           // fsync() after the write
+
+/**
+ * @brief Completion callback, runs on the completion thread
+ *
+ * Must not queue new writes or call re_aio_flush().
+ *
+ * @param result Bytes written, or -errno of the first failing step
+ * @param user Value passed with the request
+ */
+typedef void (*re_aio_done_fn)(int result, void* user);
+
+/**
+ * @brief Set up the ring and the completion thread
+ *
+ * Called implicitly by the first write; calling it again has no effect.
+ *
+ * @param entries Submission queue size (0 = RE_AIO_DEFAULT_ENTRIES)
+ * @return RESPONSE_SUCCESS when io_uring is in use,
+ *         RESPONSE_ERROR_HARDWARE_UNAVAILABLE when falling back to
+ *         synchronous writes
+ */
+int32_t re_aio_init(unsigned entries);
+
+/**
+ * @brief Queue a write, optionally followed by a linked sync
+ *
+ * The buffer is copied and may be reused as soon as the call returns.
+ * The file descriptor must stay open until the request completes.
+ *
+ * @param fd Destination file
+ * @param buf Data to write
+ * @param len Number of bytes
+ * @param offset File offset
+ * @param flags RE_AIO_DATASYNC / RE_AIO_FSYNC
+ * @param done Completion callback (may be NULL)
+ * @param user Passed to the callback
+ * @return RESPONSE_SUCCESS if queued (or written synchronously in fallback
+ *         mode), error code on failure
+ */
+int32_t re_aio_write(int fd, const void* buf, size_t len, off_t offset, uint32_t flags,
+                     re_aio_done_fn done, void* user);
+
+/**
+ * @brief Wait until every queued request has completed
+ *
+ * Entries the kernel temporarily refuses (EAGAIN/EBUSY) are resubmitted
+ * periodically; if submission fails outright, the requests complete with
+ * the negated errno.
+ *
+ * @return Number of requests that failed since the previous call
+ */
+uint32_t re_aio_flush(void);
+
+/**
+ * @brief Whether writes go through io_uring
+ */
+bool re_aio_active(void);
+
+/**
+ * @brief Complete outstanding requests, stop the completion thread and close the ring
+ */
+void re_aio_shutdown(void);
+
+#endif // RE_AIO_H
@@ -0,0 +1,438 @@
+#define _GNU_SOURCE
+#include "re_backup.h"
+#include "response_executor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <linux/fs.h>
+#include <linux/magic.h>
+#include <linux/btrfs.h>
+
+#define BTRFS_SUBVOL_ROOT_INO   256       // 子卷根目录的固定 inode 号
+#define COPY_CHUNK              (16u << 20)
+
+static const char* const method_names[] = { "无", "LVM", "btrfs", "reflink", "copy_file_range" };
+
+// === 卷注册表 ===
+static struct {
+    re_backup_volume_t volumes[RE_BACKUP_MAX_VOLUMES];
+    int count;
+    _Atomic uint32_t snapshot_seq;
+    pthread_mutex_t lock;
+} backup_state = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+// 单个卷的快照任务
+typedef struct {
+    re_backup_volume_t volume;
+    char snap_name[RE_BACKUP_NAME_MAX + 48];
+    re_snapshot_method_t method;
+    int result;
+    size_t files;
+    uint64_t elapsed_ms;
+    pthread_t thread;
+} snapshot_job_t;
+
+// 目录树复制任务：先遍历建立目录结构，再由多个线程并行复制文件
+typedef struct {
+    int src_root;
+    int dst_root;
+    char** files;
+    size_t count;
+    size_t cap;
+    _Atomic size_t next;
+    _Atomic bool no_reflink;          // 文件系统不支持 FICLONE，后续文件直接复制
+    _Atomic size_t reflinked;
+    _Atomic int failures;
+} copy_job_t;
+
+static uint64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000ull + (uint64_t)ts.tv_nsec / 1000000ull;
+}
+
+static int copy_job_push(copy_job_t* job, const char* rel) {
+    if (job->count == job->cap) {
+        size_t cap = job->cap ? job->cap * 2 : 256;
+        char** files = realloc(job->files, cap * sizeof(*files));
+        if (!files) return -ENOMEM;
+        job->files = files;
+        job->cap = cap;
+    }
+    job->files[job->count] = strdup(rel);
+    if (!job->files[job->count]) return -ENOMEM;
+    job->count++;
+    return 0;
+}
+
+// 递归复制目录结构与符号链接，普通文件加入待复制列表
+static int copy_walk(copy_job_t* job, const char* rel) {
+    int fd = openat(job->src_root, rel, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) return -errno;
+    DIR* dir = fdopendir(fd);
+    if (!dir) {
+        int err = errno;
+        close(fd);
+        return -err;
+    }
+
+    int rc = 0;
+    struct dirent* ent;
+    while (rc == 0 && (ent = readdir(dir)) != NULL) {
+        if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) continue;
+
+        char child[PATH_MAX];
+        if (snprintf(child, sizeof(child), "%s/%s", rel, ent->d_name) >= (int)sizeof(child)) {
+            rc = -ENAMETOOLONG;
+            break;
+        }
+        struct stat st;
+        if (fstatat(job->src_root, child, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+            rc = -errno;
+            break;
+        }
+
+        if (S_ISDIR(st.st_mode)) {
+            if (mkdirat(job->dst_root, child, st.st_mode & 07777) != 0) rc = -errno;
+            else rc = copy_walk(job, child);
+        } else if (S_ISREG(st.st_mode)) {
+            rc = copy_job_push(job, child);
+        } else if (S_ISLNK(st.st_mode)) {
+            char target[PATH_MAX];
+            ssize_t n = readlinkat(job->src_root, child, target, sizeof(target) - 1);
+            if (n < 0) {
+                rc = -errno;
+            } else {
+                target[n] = '\0';
+                if (symlinkat(target, job->dst_root, child) != 0) rc = -errno;
+            }
+        }
+        // 设备文件、套接字等不属于数据目录内容，跳过
+    }
+    closedir(dir);
+    return rc;
+}
+
+// 源与目标跨文件系统类型时 copy_file_range 不可用，退回普通读写
+static int copy_file_rw(int in, int out, off_t offset, off_t remaining) {
+    char* buf = malloc(1u << 20);
+    if (!buf) return -ENOMEM;
+    int rc = 0;
+    while (remaining > 0) {
+        ssize_t n = pread(in, buf, remaining > (1 << 20) ? (1u << 20) : (size_t)remaining, offset);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            rc = n < 0 ? -errno : 0;
+            break;
+        }
+        for (ssize_t done = 0; done < n; ) {
+            ssize_t w = pwrite(out, buf + done, (size_t)(n - done), offset + done);
+            if (w < 0 && errno == EINTR) continue;
+            if (w < 0) {
+                rc = -errno;
+                break;
+            }
+            done += w;
+        }
+        if (rc != 0) break;
+        offset += n;
+        remaining -= n;
+    }
+    free(buf);
+    return rc;
+}
+
+static int copy_file_data(int in, int out, off_t size) {
+    off_t remaining = size;
+    while (remaining > 0) {
+        ssize_t n = copy_file_range(in, NULL, out, NULL,
+                                    remaining > COPY_CHUNK ? COPY_CHUNK : (size_t)remaining, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EXDEV || errno == EOPNOTSUPP || errno == ENOSYS || errno == EINVAL) {
+                return copy_file_rw(in, out, size - remaining, remaining);
+            }
+            return -errno;
+        }
+        if (n == 0) break;            // 文件在复制期间被截短
+        remaining -= n;
+    }
+    return 0;
+}
+
+static int copy_one(copy_job_t* job, const char* rel) {
+    int in = openat(job->src_root, rel, O_RDONLY | O_CLOEXEC);
+    if (in < 0) return -errno;
+
+    struct stat st;
+    if (fstat(in, &st) != 0) {
+        int err = errno;
+        close(in);
+        return -err;
+    }
+    int out = openat(job->dst_root, rel, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, st.st_mode & 07777);
+    if (out < 0) {
+        int err = errno;
+        close(in);
+        return -err;
+    }
+
+    int rc = 0;
+    bool cloned = false;
+    if (!atomic_load_explicit(&job->no_reflink, memory_order_relaxed)) {
+        if (ioctl(out, FICLONE, in) == 0) {
+            cloned = true;
+            atomic_fetch_add_explicit(&job->reflinked, 1, memory_order_relaxed);
+        } else if (errno == EOPNOTSUPP || errno == EXDEV || errno == EINVAL || errno == ENOTTY) {
+            atomic_store_explicit(&job->no_reflink, true, memory_order_relaxed);
+        } else {
+            rc = -errno;
+        }
+    }
+    if (!cloned && rc == 0) rc = copy_file_data(in, out, st.st_size);
+
+    close(in);
+    close(out);
+    return rc;
+}
+
+static void* copy_worker(void* arg) {
+    copy_job_t* job = arg;
+    for (;;) {
+        size_t i = atomic_fetch_add_explicit(&job->next, 1, memory_order_relaxed);
+        if (i >= job->count) break;
+        int rc = copy_one(job, job->files[i]);
+        if (rc != 0) {
+            printf("[BACKUP] 复制 %s 失败: %s\n", job->files[i], strerror(-rc));
+            atomic_fetch_add(&job->failures, 1);
+        }
+    }
+    return NULL;
+}
+
+// reflink 优先、逐文件并行复制兜底
+static int snapshot_tree(snapshot_job_t* snap, int src_fd, int snapdir_fd) {
+    if (mkdirat(snapdir_fd, snap->snap_name, 0700) != 0) return -errno;
+
+    copy_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.src_root = src_fd;
+    job.dst_root = openat(snapdir_fd, snap->snap_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (job.dst_root < 0) return -errno;
+
+    int rc = copy_walk(&job, ".");
+    if (rc == 0) {
+        pthread_t workers[RE_BACKUP_COPY_WORKERS];
+        int started = 0;
+        int nworkers = job.count < RE_BACKUP_COPY_WORKERS ? (int)job.count : RE_BACKUP_COPY_WORKERS;
+        for (int i = 1; i < nworkers; i++) {
+            if (pthread_create(&workers[started], NULL, copy_worker, &job) == 0) started++;
+        }
+        copy_worker(&job);
+        for (int i = 0; i < started; i++) pthread_join(workers[i], NULL);
+
+        if (atomic_load(&job.failures) > 0) rc = -EIO;
+        else if (syncfs(job.dst_root) != 0) rc = -errno;
+    }
+
+    snap->files = job.count;
+    snap->method = job.count > 0 && atomic_load(&job.reflinked) == job.count
+                   ? RE_SNAPSHOT_REFLINK : RE_SNAPSHOT_COPY;
+    for (size_t i = 0; i < job.count; i++) free(job.files[i]);
+    free(job.files);
+    close(job.dst_root);
+    return rc;
+}
+
+static int snapshot_btrfs(snapshot_job_t* snap, int src_fd, int snapdir_fd) {
+    struct btrfs_ioctl_vol_args_v2 args;
+    memset(&args, 0, sizeof(args));
+    args.fd = src_fd;
+    args.flags = BTRFS_SUBVOL_RDONLY;
+    snprintf(args.name, sizeof(args.name), "%s", snap->snap_name);
+    return ioctl(snapdir_fd, BTRFS_IOC_SNAP_CREATE_V2, &args) == 0 ? 0 : -errno;
+}
+
+static int snapshot_lvm(snapshot_job_t* snap) {
+    char command[RE_BACKUP_NAME_MAX * 3 + 64];
+    snprintf(command, sizeof(command), "lvcreate -q -s -n %s %s", snap->snap_name, snap->volume.lvm_volume);
+    return system(command) == 0 ? 0 : -EIO;
+}
+
+static void* snapshot_volume(void* arg) {
+    snapshot_job_t* snap = arg;
+    const re_backup_volume_t* vol = &snap->volume;
+    uint64_t start = monotonic_ms();
+    int rc = 0;
+
+    int src_fd = open(vol->source, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (src_fd < 0) {
+        rc = -errno;
+    } else {
+        // 先落盘脏页，块级快照才能看到已提交的数据
+        syncfs(src_fd);
+
+        struct statfs sfs;
+        struct stat st;
+        bool btrfs_subvol = fstatfs(src_fd, &sfs) == 0 && sfs.f_type == BTRFS_SUPER_MAGIC &&
+                            fstat(src_fd, &st) == 0 && st.st_ino == BTRFS_SUBVOL_ROOT_INO;
+
+        if (vol->lvm_volume[0]) {
+            snap->method = RE_SNAPSHOT_LVM;
+            rc = snapshot_lvm(snap);
+        } else {
+            int snapdir_fd = open(vol->snapshot_dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (snapdir_fd < 0) {
+                rc = -errno;
+            } else if (btrfs_subvol) {
+                snap->method = RE_SNAPSHOT_BTRFS;
+                rc = snapshot_btrfs(snap, src_fd, snapdir_fd);
+            } else {
+                rc = snapshot_tree(snap, src_fd, snapdir_fd);
+            }
+            if (snapdir_fd >= 0) close(snapdir_fd);
+        }
+        close(src_fd);
+    }
+
+    snap->result = rc;
+    snap->elapsed_ms = monotonic_ms() - start;
+    return NULL;
+}
+
+// === 公开API实现 ===
+
+// 卷名与 LVM 卷会拼入 lvcreate 命令并用作快照名，只允许 LVM 名称字符；
+// vg_lv 时要求 "vg/lv" 形式。超长部分与注册时一样截断后再检查
+static bool lvm_name_valid(const char* name, size_t size, bool vg_lv) {
+    size_t len = strnlen(name, size - 1);
+    if (len == 0) return false;
+
+    size_t component = 0;
+    int slashes = 0;
+    for (size_t i = 0; i <= len; i++) {
+        char c = i < len ? name[i] : '/';
+        if (c == '/') {
+            // 各段非空、不以 '-' 开头，且不是 "." 或 ".."
+            const char* seg = name + i - component;
+            if (component == 0 || seg[0] == '-' ||
+                (seg[0] == '.' && (component == 1 || (component == 2 && seg[1] == '.')))) {
+                return false;
+            }
+            if (i < len) slashes++;
+            component = 0;
+            continue;
+        }
+        if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+              c == '+' || c == '_' || c == '.' || c == '-')) {
+            return false;
+        }
+        component++;
+    }
+    return slashes == (vg_lv ? 1 : 0);
+}
+
+int32_t re_backup_register_volume(const re_backup_volume_t* volume) {
+    if (!volume || volume->name[0] == '\0' || volume->source[0] == '\0' || volume->min_severity > 10 ||
+        (volume->lvm_volume[0] == '\0' && volume->snapshot_dir[0] == '\0')) {
+        return RESPONSE_ERROR_INVALID_PARAM;
+    }
+    if (!lvm_name_valid(volume->name, sizeof(volume->name), false) ||
+        (volume->lvm_volume[0] && !lvm_name_valid(volume->lvm_volume, sizeof(volume->lvm_volume), true))) {
+        printf("[BACKUP] 数据卷名称含非法字符: %.*s\n", RE_BACKUP_NAME_MAX - 1, volume->name);
+        return RESPONSE_ERROR_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&backup_state.lock);
+    int slot = backup_state.count;
+    for (int i = 0; i < backup_state.count; i++) {
+        if (strcmp(backup_state.volumes[i].name, volume->name) == 0) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot == RE_BACKUP_MAX_VOLUMES) {
+        pthread_mutex_unlock(&backup_state.lock);
+        return RESPONSE_ERROR_INVALID_PARAM;   // 卷表已满
+    }
+    backup_state.volumes[slot] = *volume;
+    backup_state.volumes[slot].name[RE_BACKUP_NAME_MAX - 1] = '\0';
+    backup_state.volumes[slot].source[RE_BACKUP_PATH_MAX - 1] = '\0';
+    backup_state.volumes[slot].snapshot_dir[RE_BACKUP_PATH_MAX - 1] = '\0';
+    backup_state.volumes[slot].lvm_volume[RE_BACKUP_NAME_MAX - 1] = '\0';
+    if (slot == backup_state.count) backup_state.count++;
+    pthread_mutex_unlock(&backup_state.lock);
+
+    printf("[BACKUP] 注册数据卷 %s: %s (级别 >= %d)\n", volume->name, volume->source, volume->min_severity);
+    return RESPONSE_SUCCESS;
+}
+
+void re_backup_clear_volumes(void) {
+    pthread_mutex_lock(&backup_state.lock);
+    backup_state.count = 0;
+    pthread_mutex_unlock(&backup_state.lock);
+}
+
+int32_t re_backup_snapshot(uint8_t severity) {
+    snapshot_job_t jobs[RE_BACKUP_MAX_VOLUMES];
+    int njobs = 0;
+
+    // 快照名：<卷名>-<时间>-<序号>
+    char stamp[32];
+    time_t now = time(NULL);
+    struct tm tm;
+    localtime_r(&now, &tm);
+    strftime(stamp, sizeof(stamp), "%Y%m%dT%H%M%S", &tm);
+    uint32_t seq = atomic_fetch_add(&backup_state.snapshot_seq, 1);
+
+    pthread_mutex_lock(&backup_state.lock);
+    for (int i = 0; i < backup_state.count; i++) {
+        if (backup_state.volumes[i].min_severity > severity) continue;
+        snapshot_job_t* snap = &jobs[njobs++];
+        memset(snap, 0, sizeof(*snap));
+        snap->volume = backup_state.volumes[i];
+        snprintf(snap->snap_name, sizeof(snap->snap_name), "%s-%s-%u", backup_state.volumes[i].name, stamp, seq);
+    }
+    pthread_mutex_unlock(&backup_state.lock);
+
+    if (njobs == 0) {
+        printf("[BACKUP] 级别 %d 无需快照的数据卷\n", severity);
+        return RESPONSE_SUCCESS;
+    }
+
+    // 各卷并行快照；线程创建失败时在当前线程执行
+    uint64_t start = monotonic_ms();
+    bool threaded[RE_BACKUP_MAX_VOLUMES];
+    for (int i = 0; i < njobs; i++) {
+        threaded[i] = pthread_create(&jobs[i].thread, NULL, snapshot_volume, &jobs[i]) == 0;
+        if (!threaded[i]) snapshot_volume(&jobs[i]);
+    }
+
+    int failures = 0;
+    for (int i = 0; i < njobs; i++) {
+        if (threaded[i]) pthread_join(jobs[i].thread, NULL);
+        snapshot_job_t* snap = &jobs[i];
+        if (snap->result == 0) {
+            printf("[BACKUP] 卷 %s 快照 %s 完成（方式: %s，%zu 个文件，耗时 %llums）\n",
+                   snap->volume.name, snap->snap_name, method_names[snap->method], snap->files,
+                   (unsigned long long)snap->elapsed_ms);
+        } else {
+            failures++;
+            printf("[BACKUP] 卷 %s 快照失败: %s\n", snap->volume.name, strerror(-snap->result));
+        }
+    }
+
+    printf("[BACKUP] %d 个数据卷快照完成，失败 %d 个，总耗时 %llums\n", njobs - failures, failures,
+           (unsigned long long)(monotonic_ms() - start));
+    return failures ? RESPONSE_ERROR_HARDWARE_UNAVAILABLE : RESPONSE_SUCCESS;
+}
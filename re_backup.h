@@ -0,0 +1,70 @@
+#ifndef RE_BACKUP_H
+#define RE_BACKUP_H
+
+#include <stdint.h>
+
+/**
+ * @file re_backup.h
+ * @brief Copy-on-write snapshots of configured data volumes
+ *
+ * RESPONSE_BACKUP_ACTIVATE snapshots every registered volume whose
+ * min_severity is at or below the response severity, one thread per
+ * volume. Each volume uses the cheapest consistent method available:
+ *
+ *  1. LVM thin snapshot (lvcreate -s) when lvm_volume is set
+ *  2. btrfs read-only subvolume snapshot when source is a subvolume
+ *  3. Per-file reflink (FICLONE) into snapshot_dir on XFS/btrfs/bcachefs
+ *  4. Parallel copy_file_range as a last resort
+ *
+ * Methods 1-3 complete in time independent of the data size; only the
+ * copy fallback scales with the amount of data.
+ */
+
+#define RE_BACKUP_MAX_VOLUMES   16
+#define RE_BACKUP_NAME_MAX      64
+#define RE_BACKUP_PATH_MAX      256
+#define RE_BACKUP_COPY_WORKERS  4
+
+typedef enum {
+    RE_SNAPSHOT_NONE = 0,
+    RE_SNAPSHOT_LVM,
+    RE_SNAPSHOT_BTRFS,
+    RE_SNAPSHOT_REFLINK,
+    RE_SNAPSHOT_COPY
+} re_snapshot_method_t;
+
+typedef struct {
+    char name[RE_BACKUP_NAME_MAX];            // Volume name, prefix of snapshot names
+    char source[RE_BACKUP_PATH_MAX];          // Data directory to snapshot
+    char snapshot_dir[RE_BACKUP_PATH_MAX];    // Directory receiving snapshots (same filesystem for CoW)
+    char lvm_volume[RE_BACKUP_NAME_MAX];      // Optional "vg/lv" thin volume backing source
+    uint8_t min_severity;                     // Snapshot when response severity >= this (1-10)
+} re_backup_volume_t;
+
+/**
+ * @brief Register a data volume or replace the entry with the same name
+ *
+ * `name` may only contain LVM name characters ([A-Za-z0-9+_.-]) and
+ * `lvm_volume`, when set, must be "vg/lv" in the same characters; neither
+ * may start a component with '-' or be "." or "..".
+ *
+ * @param volume Volume configuration
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_INVALID_PARAM if the
+ *         configuration or a name is invalid or the table is full
+ */
+int32_t re_backup_register_volume(const re_backup_volume_t* volume);
+
+/**
+ * @brief Remove every registered volume
+ */
+void re_backup_clear_volumes(void);
+
+/**
+ * @brief Snapshot all volumes in scope for a severity, in parallel
+ *
+ * @param severity Response severity (1-10)
+ * @return RESPONSE_SUCCESS if every snapshot succeeded, error code otherwise
+ */
+int32_t re_backup_snapshot(uint8_t severity);
+
+#endif // RE_BACKUP_H
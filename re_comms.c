@@ -0,0 +1,299 @@
+#include "re_comms.h"
+#include "re_netlink.h"
+#include "response_executor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <errno.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <linux/rtnetlink.h>
+#include <linux/pkt_sched.h>
+#include <linux/pkt_cls.h>
+#include <linux/if_ether.h>
+
+#define COMMS_QDISC_HANDLE   TC_H_MAKE(1u << 16, 0)     // 1:
+#define COMMS_CLASS_ROOT     TC_H_MAKE(1u << 16, 0x1)   // 1:1  整条链路
+#define COMMS_CLASS_HIGH     TC_H_MAKE(1u << 16, 0x10)  // 1:10 应急通信
+#define COMMS_CLASS_NORMAL   TC_H_MAKE(1u << 16, 0x20)  // 1:20 其余流量（默认）
+#define COMMS_HIGH_SHARE     80                         // 应急通信保证带宽百分比
+#define COMMS_FILTER_PRIO    1
+#define COMMS_FILTER_HTID    0x800                      // u32 默认哈希表
+#define COMMS_DEFAULT_KBIT   1000000                    // 1Gbit
+#define PSCHED_SHIFT         6                          // 内核 psched tick = 64ns
+
+// IPv4 头中源/目的地址的偏移
+#define IPV4_SRC_OFFSET      12
+#define IPV4_DST_OFFSET      16
+
+// === 通信优先级状态 ===
+static struct {
+    char ifname[IF_NAMESIZE];
+    int ifindex;
+    uint64_t link_bytes;              // 链路速率（字节/秒）
+    uint32_t zones;                   // 已安装过滤器的区域
+    bool qdisc_installed;
+    pthread_mutex_t lock;
+} comms_state = { .ifname = RE_COMMS_DEFAULT_IFACE, .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static void comms_add_htb_class(re_nl_batch_t* batch, int ifindex, uint32_t parent, uint32_t handle,
+                                uint32_t prio, uint64_t rate, uint64_t ceil) {
+    struct tcmsg tcm = {
+        .tcm_family = AF_UNSPEC,
+        .tcm_ifindex = ifindex,
+        .tcm_handle = handle,
+        .tcm_parent = parent,
+    };
+    // 突发量取 10ms 的流量，至少容纳若干个满长报文
+    uint64_t burst = rate / 100 > 16000 ? rate / 100 : 16000;
+    uint64_t cburst = ceil / 100 > 16000 ? ceil / 100 : 16000;
+    struct tc_htb_opt opt = {
+        .rate = { .rate = rate > UINT32_MAX ? UINT32_MAX : (uint32_t)rate },
+        .ceil = { .rate = ceil > UINT32_MAX ? UINT32_MAX : (uint32_t)ceil },
+        .buffer = (uint32_t)((burst * 1000000000ull / rate) >> PSCHED_SHIFT),
+        .cbuffer = (uint32_t)((cburst * 1000000000ull / ceil) >> PSCHED_SHIFT),
+        .prio = prio,
+    };
+
+    re_nl_msg_begin(batch, RTM_NEWTCLASS, NLM_F_CREATE | NLM_F_REPLACE, &tcm, sizeof(tcm));
+    re_nl_attr_put_str(batch, TCA_KIND, "htb");
+    size_t opts = re_nl_nest_begin(batch, TCA_OPTIONS);
+    re_nl_attr_put(batch, TCA_HTB_PARMS, &opt, sizeof(opt));
+    if (rate > UINT32_MAX) re_nl_attr_put(batch, TCA_HTB_RATE64, &rate, sizeof(rate));
+    if (ceil > UINT32_MAX) re_nl_attr_put(batch, TCA_HTB_CEIL64, &ceil, sizeof(ceil));
+    re_nl_nest_end(batch, opts);
+    re_nl_msg_end(batch);
+}
+
+// HTB 根队列：应急类保证大部分带宽且优先借用空闲带宽，未匹配流量进入默认类
+static void comms_add_qdisc(re_nl_batch_t* batch, int ifindex, uint64_t link) {
+    struct tcmsg tcm = {
+        .tcm_family = AF_UNSPEC,
+        .tcm_ifindex = ifindex,
+        .tcm_handle = COMMS_QDISC_HANDLE,
+        .tcm_parent = TC_H_ROOT,
+    };
+    struct tc_htb_glob glob = {
+        .version = 3,
+        .rate2quantum = 10,
+        .defcls = TC_H_MIN(COMMS_CLASS_NORMAL),
+    };
+
+    re_nl_msg_begin(batch, RTM_NEWQDISC, NLM_F_CREATE | NLM_F_REPLACE, &tcm, sizeof(tcm));
+    re_nl_attr_put_str(batch, TCA_KIND, "htb");
+    size_t opts = re_nl_nest_begin(batch, TCA_OPTIONS);
+    re_nl_attr_put(batch, TCA_HTB_INIT, &glob, sizeof(glob));
+    re_nl_nest_end(batch, opts);
+    re_nl_msg_end(batch);
+
+    uint64_t high = link * COMMS_HIGH_SHARE / 100;
+    comms_add_htb_class(batch, ifindex, COMMS_QDISC_HANDLE, COMMS_CLASS_ROOT, 0, link, link);
+    comms_add_htb_class(batch, ifindex, COMMS_CLASS_ROOT, COMMS_CLASS_HIGH, 0, high, link);
+    comms_add_htb_class(batch, ifindex, COMMS_CLASS_ROOT, COMMS_CLASS_NORMAL, 1, link - high, link);
+}
+
+// 每个区域的源/目的过滤器使用固定句柄，回退时可单独删除
+static uint32_t comms_filter_handle(int zone, uint16_t offset) {
+    uint32_t node = (uint32_t)zone * 2 + (offset == IPV4_DST_OFFSET) + 1;
+    return ((uint32_t)COMMS_FILTER_HTID << 20) | node;
+}
+
+// u32 过滤器：匹配 10.0.<zone>.0/24 的源或目的地址，送入应急通信类
+static void comms_add_filter(re_nl_batch_t* batch, int ifindex, int zone, uint16_t offset) {
+    struct tcmsg tcm = {
+        .tcm_family = AF_UNSPEC,
+        .tcm_ifindex = ifindex,
+        .tcm_handle = comms_filter_handle(zone, offset),
+        .tcm_parent = COMMS_QDISC_HANDLE,
+        .tcm_info = TC_H_MAKE((uint32_t)COMMS_FILTER_PRIO << 16, htons(ETH_P_IP)),
+    };
+    struct {
+        struct tc_u32_sel sel;
+        struct tc_u32_key key;
+    } selector;
+    memset(&selector, 0, sizeof(selector));
+    selector.sel.flags = TC_U32_TERMINAL;
+    selector.sel.nkeys = 1;
+    selector.key.mask = htonl(0xFFFFFF00u);
+    selector.key.val = htonl(0x0A000000u | ((uint32_t)zone << 8));
+    selector.key.off = offset;
+
+    re_nl_msg_begin(batch, RTM_NEWTFILTER, NLM_F_CREATE | NLM_F_REPLACE, &tcm, sizeof(tcm));
+    re_nl_attr_put_str(batch, TCA_KIND, "u32");
+    size_t opts = re_nl_nest_begin(batch, TCA_OPTIONS);
+    re_nl_attr_put_u32(batch, TCA_U32_CLASSID, COMMS_CLASS_HIGH);
+    re_nl_attr_put(batch, TCA_U32_SEL, &selector, sizeof(selector));
+    re_nl_nest_end(batch, opts);
+    re_nl_msg_end(batch);
+}
+
+static void comms_del_filter(re_nl_batch_t* batch, int ifindex, int zone, uint16_t offset) {
+    struct tcmsg tcm = {
+        .tcm_family = AF_UNSPEC,
+        .tcm_ifindex = ifindex,
+        .tcm_handle = comms_filter_handle(zone, offset),
+        .tcm_parent = COMMS_QDISC_HANDLE,
+        .tcm_info = TC_H_MAKE((uint32_t)COMMS_FILTER_PRIO << 16, htons(ETH_P_IP)),
+    };
+
+    re_nl_msg_begin(batch, RTM_DELTFILTER, 0, &tcm, sizeof(tcm));
+    re_nl_attr_put_str(batch, TCA_KIND, "u32");
+    re_nl_msg_end(batch);
+}
+
+// 删除本批次新增区域的过滤器，已生效区域的过滤器与队列保持不变
+static int comms_rollback_filters(int ifindex, uint32_t zones) {
+    int fd = re_nl_open(NETLINK_ROUTE);
+    if (fd < 0) return fd;
+
+    re_nl_batch_t batch;
+    re_nl_batch_init(&batch);
+    for (int zone = 0; zone < 32; zone++) {
+        if (zones & (1u << zone)) {
+            comms_del_filter(&batch, ifindex, zone, IPV4_SRC_OFFSET);
+            comms_del_filter(&batch, ifindex, zone, IPV4_DST_OFFSET);
+        }
+    }
+    int rc = re_nl_batch_send(fd, &batch);
+    re_nl_batch_free(&batch);
+    close(fd);
+    // 未创建成功的过滤器本就不存在
+    return rc == -ENOENT ? 0 : rc;
+}
+
+static int comms_delete_qdisc(int ifindex) {
+    int fd = re_nl_open(NETLINK_ROUTE);
+    if (fd < 0) return fd;
+
+    re_nl_batch_t batch;
+    re_nl_batch_init(&batch);
+    struct tcmsg tcm = {
+        .tcm_family = AF_UNSPEC,
+        .tcm_ifindex = ifindex,
+        .tcm_handle = COMMS_QDISC_HANDLE,
+        .tcm_parent = TC_H_ROOT,
+    };
+    re_nl_msg_begin(&batch, RTM_DELQDISC, 0, &tcm, sizeof(tcm));
+    re_nl_msg_end(&batch);
+    int rc = re_nl_batch_send(fd, &batch);
+    re_nl_batch_free(&batch);
+    close(fd);
+    return rc;
+}
+
+static void comms_clear_locked(void) {
+    if (comms_state.qdisc_installed) {
+        int rc = comms_delete_qdisc(comms_state.ifindex);
+        if (rc != 0) {
+            printf("[COMMS] 移除 %s 的优先级队列失败: %s\n", comms_state.ifname, strerror(-rc));
+        }
+    }
+    comms_state.qdisc_installed = false;
+    comms_state.zones = 0;
+}
+
+// === 公开API实现 ===
+
+int32_t re_comms_set_interface(const char* ifname, uint32_t link_kbit) {
+    if (!ifname || strlen(ifname) >= IF_NAMESIZE) return RESPONSE_ERROR_INVALID_PARAM;
+
+    uint64_t link_bytes = (uint64_t)(link_kbit ? link_kbit : COMMS_DEFAULT_KBIT) * 1000 / 8;
+
+    pthread_mutex_lock(&comms_state.lock);
+    if (strcmp(comms_state.ifname, ifname) != 0 || comms_state.link_bytes != link_bytes) {
+        comms_clear_locked();
+        snprintf(comms_state.ifname, sizeof(comms_state.ifname), "%s", ifname);
+        comms_state.ifindex = 0;
+        comms_state.link_bytes = link_bytes;
+    }
+    pthread_mutex_unlock(&comms_state.lock);
+    return RESPONSE_SUCCESS;
+}
+
+int32_t re_comms_prioritize(uint32_t zones) {
+    pthread_mutex_lock(&comms_state.lock);
+
+    uint32_t new_zones = zones & ~comms_state.zones;
+    if (new_zones == 0) {
+        pthread_mutex_unlock(&comms_state.lock);
+        return RESPONSE_SUCCESS;
+    }
+
+    int ifindex = (int)if_nametoindex(comms_state.ifname);
+    if (ifindex == 0) {
+        printf("[COMMS] 接口 %s 不存在\n", comms_state.ifname);
+        pthread_mutex_unlock(&comms_state.lock);
+        return RESPONSE_ERROR_NETWORK_FAILURE;
+    }
+    if (ifindex != comms_state.ifindex) {
+        // 接口被重建过，原有过滤器已随之消失
+        comms_state.qdisc_installed = false;
+        comms_state.zones = 0;
+        comms_state.ifindex = ifindex;
+        new_zones = zones;
+    }
+
+    int fd = re_nl_open(NETLINK_ROUTE);
+    if (fd < 0) {
+        pthread_mutex_unlock(&comms_state.lock);
+        return RESPONSE_ERROR_NETWORK_FAILURE;
+    }
+
+    // 队列与全部过滤器在同一批次中提交
+    re_nl_batch_t batch;
+    re_nl_batch_init(&batch);
+    bool qdisc_added = !comms_state.qdisc_installed;
+    if (qdisc_added) {
+        if (comms_state.link_bytes == 0) comms_state.link_bytes = (uint64_t)COMMS_DEFAULT_KBIT * 1000 / 8;
+        comms_add_qdisc(&batch, ifindex, comms_state.link_bytes);
+    }
+    for (int zone = 0; zone < 32; zone++) {
+        if (new_zones & (1u << zone)) {
+            comms_add_filter(&batch, ifindex, zone, IPV4_SRC_OFFSET);
+            comms_add_filter(&batch, ifindex, zone, IPV4_DST_OFFSET);
+        }
+    }
+
+    int rc = re_nl_batch_send(fd, &batch);
+    uint32_t messages = batch.count;
+    re_nl_batch_free(&batch);
+    close(fd);
+
+    int32_t result = RESPONSE_SUCCESS;
+    if (rc == 0) {
+        comms_state.qdisc_installed = true;
+        comms_state.zones |= new_zones;
+        printf("[COMMS] 应急通信优先级已生效，接口: %s，区域: 0x%08X (%u 条 netlink 消息)\n",
+               comms_state.ifname, new_zones, messages);
+    } else if (qdisc_added) {
+        // 队列由本批次新建，尚无其他区域依赖，整体移除
+        printf("[COMMS] 流量整形配置失败: %s\n", strerror(-rc));
+        comms_state.qdisc_installed = true;
+        comms_clear_locked();
+        result = RESPONSE_ERROR_NETWORK_FAILURE;
+    } else {
+        // 只撤销本批次的过滤器，其他区域的优先级在事件期间保持生效
+        printf("[COMMS] 区域 0x%08X 的过滤器配置失败: %s\n", new_zones, strerror(-rc));
+        int rrc = comms_rollback_filters(ifindex, new_zones);
+        if (rrc != 0) printf("[COMMS] 回退区域 0x%08X 的过滤器失败: %s\n", new_zones, strerror(-rrc));
+        result = RESPONSE_ERROR_NETWORK_FAILURE;
+    }
+
+    pthread_mutex_unlock(&comms_state.lock);
+    return result;
+}
+
+void re_comms_clear(void) {
+    pthread_mutex_lock(&comms_state.lock);
+    comms_clear_locked();
+    pthread_mutex_unlock(&comms_state.lock);
+}
+
+uint32_t re_comms_active_zones(void) {
+    pthread_mutex_lock(&comms_state.lock);
+    uint32_t zones = comms_state.zones;
+    pthread_mutex_unlock(&comms_state.lock);
+    return zones;
+}
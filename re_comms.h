@@ -0,0 +1,52 @@
+#ifndef RE_COMMS_H
+#define RE_COMMS_H
+
+#include <stdint.h>
+
+/**
+ * @file re_comms.h
+ * @brief Emergency communication priority via kernel traffic shaping
+ *
+ * RESPONSE_COMMS_PRIORITY installs an HTB root qdisc on the configured
+ * interface with an emergency class (guaranteed 80% of the link, first to
+ * borrow idle bandwidth) and a default class for everything else. u32
+ * filters steer traffic from and to the targeted zones' subnets
+ * (10.0.<zone>.0/24) into the emergency class. All qdisc, class and
+ * filter changes of one response are sent as a single rtnetlink batch.
+ */
+
+#define RE_COMMS_DEFAULT_IFACE  "eth0"
+
+/**
+ * @brief Select the interface that emergency traffic leaves through
+ *
+ * Changing the interface or rate removes shaping installed so far.
+ *
+ * @param ifname Interface name (e.g. one end of a veth pair in a test netns)
+ * @param link_kbit Link rate in kbit/s used to size the classes (0 = 1Gbit)
+ * @return RESPONSE_SUCCESS on success, error code on failure
+ */
+int32_t re_comms_set_interface(const char* ifname, uint32_t link_kbit);
+
+/**
+ * @brief Prioritize emergency traffic for the given zones
+ *
+ * Only zones not already prioritized get new filters.
+ *
+ * @param zones Bitmask of target zones
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_NETWORK_FAILURE if
+ *         the kernel rejected the batch
+ */
+int32_t re_comms_prioritize(uint32_t zones);
+
+/**
+ * @brief Remove the priority qdisc and all its filters
+ */
+void re_comms_clear(void);
+
+/**
+ * @brief Bitmask of zones whose traffic is currently prioritized
+ */
+uint32_t re_comms_active_zones(void);
+
+#endif // RE_COMMS_H
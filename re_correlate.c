@@ -0,0 +1,348 @@
+#include "re_correlate.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#define CORR_FIRED_SLOTS   4096              // 冷却表，直接映射，冲突时覆盖
+
+// 被跟踪的键：每个条件一个时间片环
+typedef struct {
+    uint64_t key;
+    uint64_t epoch;                   // 最近更新的时间片编号
+    bool used;
+    uint32_t counts[RE_CORR_MAX_CONDITIONS][RE_CORR_SLICES];
+} corr_key_t;
+
+typedef struct {
+    re_correlate_rule_t rule;
+    uint32_t condition_count;
+    uint64_t event_hash[RE_CORR_MAX_CONDITIONS];
+    uint64_t slice_ms;
+    corr_key_t* keys;                 // RE_CORR_TRACKED_KEYS 项，按组相联
+} corr_rule_slot_t;
+
+typedef struct {
+    uint64_t key;
+    uint64_t until_ms;
+    uint32_t rule;
+    uint32_t generation;              // 0 表示空
+} corr_fired_t;
+
+// === 关联状态 ===
+static struct {
+    bool running;
+    re_ctx_t* ctx;
+    pthread_t dispatcher;
+    // 规则、冷却表与执行队列（受 lock 保护）
+    corr_rule_slot_t rules[RE_CORR_MAX_RULES];
+    uint32_t rule_count;
+    uint32_t generation;
+    corr_fired_t fired[CORR_FIRED_SLOTS];
+    integrated_response_t queue[RE_CORR_QUEUE];
+    uint32_t queue_head;
+    uint32_t queue_len;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    // 计数器
+    _Atomic uint64_t observed;
+    _Atomic uint64_t fired_count;
+    _Atomic uint64_t suppressed;
+    _Atomic uint64_t dropped;
+    _Atomic uint64_t failed;
+    _Atomic uint64_t evicted;
+    pthread_mutex_t start_lock;       // 串行化启动与停止
+} corr_state = { .generation = 1, .lock = PTHREAD_MUTEX_INITIALIZER,
+                 .ready = PTHREAD_COND_INITIALIZER, .start_lock = PTHREAD_MUTEX_INITIALIZER };
+
+static uint64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+static uint64_t name_hash(const char* s) {
+    uint64_t h = 0xcbf29ce484222325ull;              // FNV-1a
+    while (*s) {
+        h ^= (uint8_t)*s++;
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+static uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;                                    // splitmix64 终混
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+// === 滑动窗口计数 ===
+
+// 时间前进时清空移出窗口的时间片
+static void key_advance(corr_key_t* entry, uint64_t epoch) {
+    if (epoch <= entry->epoch) return;
+    uint64_t steps = epoch - entry->epoch;
+    if (steps > RE_CORR_SLICES) steps = RE_CORR_SLICES;
+    for (uint64_t k = 1; k <= steps; k++) {
+        size_t slice = (size_t)((entry->epoch + k) % RE_CORR_SLICES);
+        for (uint32_t c = 0; c < RE_CORR_MAX_CONDITIONS; c++) entry->counts[c][slice] = 0;
+    }
+    entry->epoch = epoch;
+}
+
+static uint64_t key_total(const corr_key_t* entry, uint32_t condition) {
+    uint64_t total = 0;
+    for (uint32_t slice = 0; slice < RE_CORR_SLICES; slice++) total += entry->counts[condition][slice];
+    return total;
+}
+
+// 在键所属的组内查找或分配表项：优先空位，其次窗口内计数最少的表项
+static corr_key_t* key_lookup(corr_rule_slot_t* slot, uint64_t key, uint64_t epoch) {
+    size_t set = (size_t)(mix64(key) & (RE_CORR_TRACKED_KEYS / RE_CORR_WAYS - 1));
+    corr_key_t* ways = &slot->keys[set * RE_CORR_WAYS];
+    corr_key_t* victim = NULL;
+    uint64_t victim_total = UINT64_MAX;
+
+    for (uint32_t w = 0; w < RE_CORR_WAYS; w++) {
+        corr_key_t* entry = &ways[w];
+        if (!entry->used) {                          // 组内按顺序填充，空位之后没有已用表项
+            victim = entry;
+            victim_total = 0;
+            break;
+        }
+        key_advance(entry, epoch);
+        if (entry->key == key) return entry;
+        uint64_t total = 0;
+        for (uint32_t c = 0; c < slot->condition_count; c++) total += key_total(entry, c);
+        if (total < victim_total) {
+            victim = entry;
+            victim_total = total;
+        }
+    }
+
+    if (victim->used && victim_total > 0) atomic_fetch_add(&corr_state.evicted, 1);
+    memset(victim, 0, sizeof(*victim));
+    victim->used = true;
+    victim->key = key;
+    victim->epoch = epoch;
+    return victim;
+}
+
+// === 触发 ===
+
+// 调用者持有 lock；返回是否已排队
+static bool rule_fire(uint32_t index, uint64_t key, uint32_t zones, uint64_t now_ms) {
+    const corr_rule_slot_t* slot = &corr_state.rules[index];
+    corr_fired_t* fired = &corr_state.fired[mix64(key ^ ((uint64_t)index << 56)) % CORR_FIRED_SLOTS];
+    if (fired->generation == corr_state.generation && fired->rule == index &&
+        fired->key == key && now_ms < fired->until_ms) {
+        atomic_fetch_add(&corr_state.suppressed, 1);
+        return false;
+    }
+    if (corr_state.queue_len == RE_CORR_QUEUE) {
+        atomic_fetch_add(&corr_state.dropped, 1);
+        printf("[CORR] 执行队列已满，丢弃规则 %u 的响应\n", index);
+        return false;
+    }
+
+    integrated_response_t* response = &corr_state.queue[(corr_state.queue_head + corr_state.queue_len) % RE_CORR_QUEUE];
+    *response = slot->rule.response;
+    if (response->target_zones == 0) response->target_zones = zones;
+    response->timestamp = (uint64_t)time(NULL);
+    snprintf(response->trigger_event, sizeof(response->trigger_event), "corr:%.31s:%llx",
+             slot->rule.conditions[0].event, (unsigned long long)key);
+    corr_state.queue_len++;
+    pthread_cond_signal(&corr_state.ready);
+
+    *fired = (corr_fired_t){ .key = key, .until_ms = now_ms + (uint64_t)slot->rule.window_seconds * 1000,
+                             .rule = index, .generation = corr_state.generation };
+    atomic_fetch_add(&corr_state.fired_count, 1);
+    printf("[CORR] 规则 %u 条件满足 (键 %llx)，响应类型 %d 已排队\n",
+           index, (unsigned long long)key, response->type);
+    return true;
+}
+
+static void* dispatcher_thread(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&corr_state.lock);
+    for (;;) {
+        while (corr_state.running && corr_state.queue_len == 0) {
+            pthread_cond_wait(&corr_state.ready, &corr_state.lock);
+        }
+        if (!corr_state.running) break;
+
+        integrated_response_t response = corr_state.queue[corr_state.queue_head];
+        corr_state.queue_head = (corr_state.queue_head + 1) % RE_CORR_QUEUE;
+        corr_state.queue_len--;
+        pthread_mutex_unlock(&corr_state.lock);
+
+        int32_t result = re_ctx_execute(corr_state.ctx, &response);
+        if (result != RESPONSE_SUCCESS) {
+            atomic_fetch_add(&corr_state.failed, 1);
+            printf("[CORR] 关联响应执行失败 (%s): %d\n", response.trigger_event, result);
+        }
+
+        pthread_mutex_lock(&corr_state.lock);
+    }
+    pthread_mutex_unlock(&corr_state.lock);
+    return NULL;
+}
+
+// === 公共接口 ===
+
+int32_t re_correlate_add_rule(const re_correlate_rule_t* rule) {
+    if (!rule || rule->window_seconds == 0 || rule->window_seconds > RE_CORR_MAX_WINDOW) {
+        return RESPONSE_ERROR_INVALID_PARAM;
+    }
+
+    corr_rule_slot_t slot = { .rule = *rule };
+    for (uint32_t c = 0; c < RE_CORR_MAX_CONDITIONS; c++) {
+        const re_correlate_condition_t* cond = &rule->conditions[c];
+        size_t len = strnlen(cond->event, RE_CORR_EVENT_MAX);
+        if (len == 0) continue;
+        if (len == RE_CORR_EVENT_MAX || cond->threshold == 0) return RESPONSE_ERROR_INVALID_PARAM;
+        // 已用条件紧凑存放，第一个条件名用于 trigger_event
+        slot.rule.conditions[slot.condition_count] = *cond;
+        slot.event_hash[slot.condition_count] = name_hash(cond->event);
+        slot.condition_count++;
+    }
+    if (slot.condition_count == 0) return RESPONSE_ERROR_INVALID_PARAM;
+    for (uint32_t c = slot.condition_count; c < RE_CORR_MAX_CONDITIONS; c++) {
+        memset(&slot.rule.conditions[c], 0, sizeof(slot.rule.conditions[c]));
+    }
+
+    integrated_response_t check = rule->response;
+    check.trigger_event[0] = '\0';
+    if (check.target_zones == 0) check.target_zones = 1;    // 目标区域可由事件提供
+    if (!re_validate_parameters(&check)) return RESPONSE_ERROR_INVALID_PARAM;
+
+    slot.slice_ms = (uint64_t)rule->window_seconds * 1000 / RE_CORR_SLICES;
+    slot.keys = calloc(RE_CORR_TRACKED_KEYS, sizeof(corr_key_t));
+    if (!slot.keys) return RESPONSE_ERROR_INIT_FAILED;
+
+    pthread_mutex_lock(&corr_state.lock);
+    if (corr_state.rule_count >= RE_CORR_MAX_RULES) {
+        pthread_mutex_unlock(&corr_state.lock);
+        free(slot.keys);
+        return RESPONSE_ERROR_QUEUE_FULL;
+    }
+    uint32_t index = corr_state.rule_count++;
+    corr_state.rules[index] = slot;
+    pthread_mutex_unlock(&corr_state.lock);
+    return (int32_t)index;
+}
+
+void re_correlate_clear_rules(void) {
+    pthread_mutex_lock(&corr_state.lock);
+    for (uint32_t r = 0; r < corr_state.rule_count; r++) {
+        free(corr_state.rules[r].keys);
+        corr_state.rules[r].keys = NULL;
+    }
+    corr_state.rule_count = 0;
+    // 冷却表随代号失效
+    if (++corr_state.generation == 0) corr_state.generation = 1;
+    pthread_mutex_unlock(&corr_state.lock);
+}
+
+int32_t re_correlate_observe(const char* event, uint64_t key, uint32_t zones, uint32_t count) {
+    if (!event || !event[0]) return RESPONSE_ERROR_INVALID_PARAM;
+    if (count == 0) count = 1;
+    uint64_t hash = name_hash(event);
+    uint64_t now_ms = monotonic_ms();
+    int32_t fired = 0;
+
+    pthread_mutex_lock(&corr_state.lock);
+    if (!corr_state.running) {
+        pthread_mutex_unlock(&corr_state.lock);
+        return RESPONSE_ERROR_SHUTDOWN;
+    }
+    for (uint32_t r = 0; r < corr_state.rule_count; r++) {
+        corr_rule_slot_t* slot = &corr_state.rules[r];
+        corr_key_t* entry = NULL;
+        for (uint32_t c = 0; c < slot->condition_count; c++) {
+            if (slot->event_hash[c] != hash || strcmp(slot->rule.conditions[c].event, event) != 0) continue;
+            uint64_t epoch = now_ms / slot->slice_ms;
+            if (!entry) entry = key_lookup(slot, key, epoch);
+            uint32_t* cell = &entry->counts[c][epoch % RE_CORR_SLICES];
+            *cell = *cell > UINT32_MAX - count ? UINT32_MAX : *cell + count;
+        }
+        if (!entry) continue;
+
+        // 同一键上所有条件都达到阈值才触发
+        bool holds = true;
+        for (uint32_t c = 0; c < slot->condition_count && holds; c++) {
+            holds = key_total(entry, c) >= slot->rule.conditions[c].threshold;
+        }
+        if (holds && rule_fire(r, key, zones, now_ms)) fired++;
+    }
+    pthread_mutex_unlock(&corr_state.lock);
+
+    atomic_fetch_add(&corr_state.observed, 1);
+    return fired;
+}
+
+int32_t re_correlate_start(re_ctx_t* ctx) {
+    pthread_mutex_lock(&corr_state.start_lock);
+    if (corr_state.running) {
+        pthread_mutex_unlock(&corr_state.start_lock);
+        return RESPONSE_SUCCESS;
+    }
+
+    pthread_mutex_lock(&corr_state.lock);
+    corr_state.ctx = ctx ? ctx : re_ctx_default();
+    corr_state.queue_head = corr_state.queue_len = 0;
+    corr_state.running = true;
+    uint32_t rule_count = corr_state.rule_count;
+    pthread_mutex_unlock(&corr_state.lock);
+    if (pthread_create(&corr_state.dispatcher, NULL, dispatcher_thread, NULL) != 0) {
+        pthread_mutex_lock(&corr_state.lock);
+        corr_state.running = false;
+        pthread_mutex_unlock(&corr_state.lock);
+        pthread_mutex_unlock(&corr_state.start_lock);
+        return RESPONSE_ERROR_INIT_FAILED;
+    }
+
+    printf("[CORR] 事件关联已启动 (%u 条规则)\n", rule_count);
+    pthread_mutex_unlock(&corr_state.start_lock);
+    return RESPONSE_SUCCESS;
+}
+
+void re_correlate_get_stats(re_correlate_stats_t* stats) {
+    if (!stats) return;
+    stats->observed = atomic_load(&corr_state.observed);
+    stats->fired = atomic_load(&corr_state.fired_count);
+    stats->suppressed = atomic_load(&corr_state.suppressed);
+    stats->dropped = atomic_load(&corr_state.dropped);
+    stats->failed = atomic_load(&corr_state.failed);
+    stats->evicted = atomic_load(&corr_state.evicted);
+}
+
+void re_correlate_stop(void) {
+    pthread_mutex_lock(&corr_state.start_lock);
+    pthread_mutex_lock(&corr_state.lock);
+    if (!corr_state.running) {
+        pthread_mutex_unlock(&corr_state.lock);
+        pthread_mutex_unlock(&corr_state.start_lock);
+        return;
+    }
+    corr_state.running = false;
+    pthread_cond_broadcast(&corr_state.ready);
+    pthread_mutex_unlock(&corr_state.lock);
+    pthread_join(corr_state.dispatcher, NULL);
+
+    // 仍在排队的响应不再执行
+    pthread_mutex_lock(&corr_state.lock);
+    uint32_t dropped = corr_state.queue_len;
+    corr_state.queue_len = 0;
+    pthread_mutex_unlock(&corr_state.lock);
+    if (dropped > 0) {
+        printf("[CORR] 丢弃排队中的响应 %u 条\n", dropped);
+    }
+    printf("[CORR] 事件关联已停止\n");
+    pthread_mutex_unlock(&corr_state.start_lock);
+}
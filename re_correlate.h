@@ -0,0 +1,115 @@
+#ifndef RE_CORRELATE_H
+#define RE_CORRELATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "response_executor.h"
+
+/**
+ * @file re_correlate.h
+ * @brief Sliding-window event correlation
+ *
+ * Counts events per key (a zone, a source address, ...) over a sliding
+ * window and executes a response when every condition of a rule holds for
+ * the same key, e.g. "50 auth_failure and 1 priv_escalation within 10s on
+ * one zone".
+ *
+ * Memory does not grow with the number of keys: each rule tracks at most
+ * RE_CORR_TRACKED_KEYS keys in a set-associative table, and every tracked
+ * key keeps a ring of RE_CORR_SLICES time buckets per condition, so the
+ * window moves in steps of window/RE_CORR_SLICES. When a set is full the
+ * key with the fewest events in the window is evicted, so a flood of
+ * one-off keys displaces other quiet keys rather than the busy ones a
+ * rule is waiting for. Counts are exact while a key is tracked and are
+ * never overestimated; a response never fires because of hash collisions.
+ *
+ * After a rule fires for a key it stays quiet for that key for one window.
+ * Fired responses are executed in order by a dispatcher thread on the
+ * configured context.
+ */
+
+#define RE_CORR_MAX_RULES          32
+#define RE_CORR_MAX_CONDITIONS     4
+#define RE_CORR_EVENT_MAX          32
+#define RE_CORR_MAX_WINDOW         3600     // Seconds
+#define RE_CORR_SLICES             10       // Window granularity
+#define RE_CORR_TRACKED_KEYS       1024     // Keys per rule (power of two)
+#define RE_CORR_WAYS               8        // Keys per set
+#define RE_CORR_QUEUE              64       // Fired responses awaiting execution
+
+// Condition: at least `threshold` events named `event` within the window
+typedef struct {
+    char event[RE_CORR_EVENT_MAX];          // Empty = unused
+    uint32_t threshold;
+} re_correlate_condition_t;
+
+// Correlation rule; all used conditions must hold for the same key
+typedef struct {
+    re_correlate_condition_t conditions[RE_CORR_MAX_CONDITIONS];
+    uint32_t window_seconds;                // 1..RE_CORR_MAX_WINDOW
+    integrated_response_t response;         // target_zones 0 = zones of the completing event
+} re_correlate_rule_t;
+
+// Correlation counters
+typedef struct {
+    uint64_t observed;                      // Events counted
+    uint64_t fired;                         // Responses queued
+    uint64_t suppressed;                    // Rule held for a key that fired within the window
+    uint64_t dropped;                       // Fired while the queue was full
+    uint64_t failed;                        // Executions that did not succeed
+    uint64_t evicted;                       // Keys with events in the window displaced by new keys
+} re_correlate_stats_t;
+
+/**
+ * @brief Start the dispatcher
+ *
+ * @param ctx Context responses execute on (NULL = default context)
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_INIT_FAILED otherwise
+ */
+int32_t re_correlate_start(re_ctx_t* ctx);
+
+/**
+ * @brief Add a rule
+ *
+ * The rule's key table is allocated here (RE_CORR_TRACKED_KEYS keys of
+ * RE_CORR_MAX_CONDITIONS * RE_CORR_SLICES 32-bit counters).
+ *
+ * @return Rule index (>= 0) on success, RESPONSE_ERROR_INVALID_PARAM if the
+ *         rule has no condition, a zero threshold, a bad window or an
+ *         invalid response, RESPONSE_ERROR_QUEUE_FULL if RE_CORR_MAX_RULES
+ *         rules exist, RESPONSE_ERROR_INIT_FAILED on allocation failure
+ */
+int32_t re_correlate_add_rule(const re_correlate_rule_t* rule);
+
+/**
+ * @brief Remove all rules and their counters
+ */
+void re_correlate_clear_rules(void);
+
+/**
+ * @brief Count an event
+ *
+ * @param event Event name
+ * @param key Correlation key
+ * @param zones Zones the event concerns (used by rules without target zones)
+ * @param count Number of occurrences (0 is treated as 1)
+ * @return Number of rules fired (>= 0), RESPONSE_ERROR_INVALID_PARAM if the
+ *         name is empty, RESPONSE_ERROR_SHUTDOWN if the dispatcher is not
+ *         running
+ */
+int32_t re_correlate_observe(const char* event, uint64_t key, uint32_t zones, uint32_t count);
+
+/**
+ * @brief Read the counters
+ */
+void re_correlate_get_stats(re_correlate_stats_t* stats);
+
+/**
+ * @brief Stop the dispatcher
+ *
+ * Waits for the response currently executing; queued ones are dropped.
+ * Rules and counters are kept.
+ */
+void re_correlate_stop(void);
+
+#endif // RE_CORRELATE_H
@@ -0,0 +1,327 @@
+#include "re_evlog.h"
+#include "re_aio.h"
+#include "response_executor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <sched.h>
+
+#define EVLOG_DEFAULT_SLOTS     4096
+#define EVLOG_DEFAULT_FLUSH_MS  100
+#define EVLOG_WRITE_BUFFER      (64 * 1024)
+
+// 环形缓冲槽位：seq 按 Vyukov 有界队列协议推进
+typedef struct {
+    _Alignas(64) _Atomic uint64_t seq;
+    uint8_t len;
+    uint8_t data[RE_EVLOG_MAX_RECORD];
+} evlog_slot_t;
+
+// === 事件日志状态 ===
+static struct {
+    evlog_slot_t* _Atomic slots;      // 非 NULL 表示日志接收新事件
+    evlog_slot_t* ring;               // 消费端使用的缓冲区
+    _Atomic uint32_t writers;         // 正在编码的生产者数量
+    uint64_t mask;
+    _Atomic uint64_t head;            // 生产者位置
+    uint64_t tail;                    // 消费者位置（受 drain_lock 保护）
+    _Atomic uint64_t dropped;
+    _Atomic uint32_t write_errors;    // 异步写入失败次数
+    uint64_t base_time_ns;
+    int fd;
+    off_t offset;                     // 下一批写入的文件位置（受 drain_lock 保护）
+    uint32_t flush_interval_ms;
+    bool running;
+    pthread_t flusher;
+    pthread_mutex_t drain_lock;
+    pthread_cond_t wakeup;
+    uint8_t* write_buf;
+} evlog_state = { .fd = -1, .drain_lock = PTHREAD_MUTEX_INITIALIZER,
+                  .wakeup = PTHREAD_COND_INITIALIZER };
+
+static uint64_t evlog_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int write_all(int fd, const uint8_t* buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+static void evlog_write_done(int result, void* user) {
+    (void)user;
+    if (result < 0) atomic_fetch_add(&evlog_state.write_errors, 1);
+}
+
+// 批量写入交给 io_uring（数据被复制，write_buf 可立即复用），不等待磁盘；
+// 各批次可能乱序完成，因此按显式偏移写入而不依赖 O_APPEND
+static int evlog_write(const uint8_t* buf, size_t len) {
+    if (re_aio_write(evlog_state.fd, buf, len, evlog_state.offset, 0,
+                     evlog_write_done, NULL) != RESPONSE_SUCCESS) {
+        return -1;
+    }
+    evlog_state.offset += (off_t)len;
+    return 0;
+}
+
+// 将环形缓冲中已提交的事件批量写入磁盘，调用者持有 drain_lock
+static int evlog_drain_locked(evlog_slot_t* slots) {
+    size_t used = 0;
+    int result = 0;
+
+    for (;;) {
+        evlog_slot_t* slot = &slots[evlog_state.tail & evlog_state.mask];
+        uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (seq != evlog_state.tail + 1) break;
+
+        if (used + slot->len > EVLOG_WRITE_BUFFER) {
+            if (evlog_write(evlog_state.write_buf, used) != 0) result = -1;
+            used = 0;
+        }
+        memcpy(evlog_state.write_buf + used, slot->data, slot->len);
+        used += slot->len;
+
+        atomic_store_explicit(&slot->seq, evlog_state.tail + evlog_state.mask + 1,
+                              memory_order_release);
+        evlog_state.tail++;
+    }
+
+    if (used > 0 && evlog_write(evlog_state.write_buf, used) != 0) {
+        result = -1;
+    }
+    return result;
+}
+
+static void* evlog_flusher_thread(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&evlog_state.drain_lock);
+    while (evlog_state.running) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += evlog_state.flush_interval_ms / 1000;
+        deadline.tv_nsec += (long)(evlog_state.flush_interval_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&evlog_state.wakeup, &evlog_state.drain_lock, &deadline);
+        evlog_drain_locked(evlog_state.ring);
+    }
+    pthread_mutex_unlock(&evlog_state.drain_lock);
+    return NULL;
+}
+
+// === 公开API实现 ===
+
+int32_t re_evlog_open(const char* path, uint32_t ring_slots, uint32_t flush_interval_ms) {
+    if (!path) return RESPONSE_ERROR_INVALID_PARAM;
+    if (atomic_load(&evlog_state.slots)) return RESPONSE_SUCCESS;
+
+    uint64_t capacity = 1;
+    uint32_t wanted = ring_slots ? ring_slots : EVLOG_DEFAULT_SLOTS;
+    while (capacity < wanted) capacity <<= 1;
+
+    evlog_slot_t* slots = aligned_alloc(64, capacity * sizeof(evlog_slot_t));
+    uint8_t* write_buf = malloc(EVLOG_WRITE_BUFFER);
+    if (!slots || !write_buf) {
+        free(slots);
+        free(write_buf);
+        return RESPONSE_ERROR_INIT_FAILED;
+    }
+    for (uint64_t i = 0; i < capacity; i++) {
+        atomic_init(&slots[i].seq, i);
+    }
+
+    // 不用 O_APPEND：Linux 上 O_APPEND 会忽略 pwrite 与 io_uring 的显式偏移
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0640);
+    if (fd < 0) {
+        printf("[EVLOG] 无法打开事件日志 %s: %s\n", path, strerror(errno));
+        free(slots);
+        free(write_buf);
+        return RESPONSE_ERROR_ACCESS_DENIED;
+    }
+
+    // 新文件写入文件头；追加到已有日志时沿用原基准时间
+    evlog_state.base_time_ns = evlog_now_ns();
+    off_t size = lseek(fd, 0, SEEK_END);
+    re_evlog_file_header_t header = {0};
+    if (size == 0) {
+        header.magic = RE_EVLOG_MAGIC;
+        header.version = RE_EVLOG_VERSION;
+        header.base_time_ns = evlog_state.base_time_ns;
+        if (write_all(fd, (const uint8_t*)&header, sizeof(header)) != 0) {
+            close(fd);
+            free(slots);
+            free(write_buf);
+            return RESPONSE_ERROR_CRITICAL_FAILURE;
+        }
+    } else if (pread(fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header) &&
+               header.magic == RE_EVLOG_MAGIC) {
+        evlog_state.base_time_ns = header.base_time_ns;
+    } else {
+        printf("[EVLOG] %s 不是有效的事件日志\n", path);
+        close(fd);
+        free(slots);
+        free(write_buf);
+        return RESPONSE_ERROR_INVALID_PARAM;
+    }
+
+    evlog_state.fd = fd;
+    evlog_state.offset = size == 0 ? (off_t)sizeof(header) : size;
+    evlog_state.ring = slots;
+    evlog_state.mask = capacity - 1;
+    evlog_state.tail = 0;
+    evlog_state.write_buf = write_buf;
+    evlog_state.flush_interval_ms = flush_interval_ms ? flush_interval_ms : EVLOG_DEFAULT_FLUSH_MS;
+    evlog_state.running = true;
+    atomic_store(&evlog_state.head, 0);
+    atomic_store(&evlog_state.dropped, 0);
+    atomic_store(&evlog_state.write_errors, 0);
+    atomic_store(&evlog_state.slots, slots);
+
+    if (pthread_create(&evlog_state.flusher, NULL, evlog_flusher_thread, NULL) != 0) {
+        atomic_store(&evlog_state.slots, NULL);
+        evlog_state.running = false;
+        close(fd);
+        evlog_state.fd = -1;
+        free(slots);
+        free(write_buf);
+        return RESPONSE_ERROR_INIT_FAILED;
+    }
+
+    printf("[EVLOG] 事件日志已打开: %s (%llu 槽位)\n", path, (unsigned long long)capacity);
+    return RESPONSE_SUCCESS;
+}
+
+void re_evlog_emit(uint8_t event, uint8_t subsystem, uint64_t response_id,
+                   uint32_t zones, int64_t value, const char* text) {
+    // 与 re_evlog_close 的 exchange 构成 Dekker 式配对，需顺序一致
+    atomic_fetch_add(&evlog_state.writers, 1);
+    evlog_slot_t* slots = atomic_load(&evlog_state.slots);
+    if (!slots) {
+        atomic_fetch_sub_explicit(&evlog_state.writers, 1, memory_order_release);
+        return;
+    }
+
+    uint64_t now = evlog_now_ns();
+
+    // 预约槽位
+    evlog_slot_t* slot;
+    uint64_t pos = atomic_load_explicit(&evlog_state.head, memory_order_relaxed);
+    for (;;) {
+        slot = &slots[pos & evlog_state.mask];
+        uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int64_t diff = (int64_t)(seq - pos);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&evlog_state.head, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            atomic_fetch_add_explicit(&evlog_state.dropped, 1, memory_order_relaxed);
+            atomic_fetch_sub_explicit(&evlog_state.writers, 1, memory_order_release);
+            return;
+        } else {
+            pos = atomic_load_explicit(&evlog_state.head, memory_order_relaxed);
+        }
+    }
+
+    // 直接在槽位中编码记录
+    uint8_t* out = slot->data;
+    size_t n = 4;
+    uint8_t flags = 0;
+    n += re_varint_put(out + n, now > evlog_state.base_time_ns ? now - evlog_state.base_time_ns : 0);
+    n += re_varint_put(out + n, response_id);
+    n += re_varint_put(out + n, zones);
+    n += re_varint_put(out + n, re_zigzag_encode(value));
+    if (text) {
+        size_t len = strnlen(text, RE_EVLOG_MAX_TEXT);
+        flags |= RE_EVLOG_FLAG_TEXT;
+        out[n++] = (uint8_t)len;
+        memcpy(out + n, text, len);
+        n += len;
+    }
+    out[0] = (uint8_t)n;
+    out[1] = event;
+    out[2] = subsystem;
+    out[3] = flags;
+    slot->len = (uint8_t)n;
+
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+    atomic_fetch_sub_explicit(&evlog_state.writers, 1, memory_order_release);
+}
+
+int32_t re_evlog_flush(void) {
+    if (!atomic_load(&evlog_state.slots)) return RESPONSE_ERROR_INIT_FAILED;
+
+    pthread_mutex_lock(&evlog_state.drain_lock);
+    // 并发的 re_evlog_close 可能已在取得锁之前完成
+    if (!evlog_state.ring || evlog_state.fd < 0) {
+        pthread_mutex_unlock(&evlog_state.drain_lock);
+        return RESPONSE_ERROR_INIT_FAILED;
+    }
+    int result = evlog_drain_locked(evlog_state.ring);
+    // 等待已排队的批次写完，再统一落盘
+    re_aio_flush();
+    if (atomic_exchange(&evlog_state.write_errors, 0) > 0) result = -1;
+    if (result == 0 && fdatasync(evlog_state.fd) != 0) result = -1;
+    pthread_mutex_unlock(&evlog_state.drain_lock);
+
+    return result == 0 ? RESPONSE_SUCCESS : RESPONSE_ERROR_CRITICAL_FAILURE;
+}
+
+uint64_t re_evlog_dropped(void) {
+    return atomic_load(&evlog_state.dropped);
+}
+
+void re_evlog_close(void) {
+    evlog_slot_t* slots = atomic_exchange(&evlog_state.slots, NULL);
+    if (!slots) return;
+
+    // 停止接收新事件，等待正在编码的生产者退出
+    while (atomic_load_explicit(&evlog_state.writers, memory_order_acquire) > 0) {
+        sched_yield();
+    }
+
+    pthread_mutex_lock(&evlog_state.drain_lock);
+    evlog_state.running = false;
+    pthread_cond_signal(&evlog_state.wakeup);
+    pthread_mutex_unlock(&evlog_state.drain_lock);
+    pthread_join(evlog_state.flusher, NULL);
+
+    // 最后一次落盘
+    pthread_mutex_lock(&evlog_state.drain_lock);
+    evlog_drain_locked(slots);
+    re_aio_flush();
+    fdatasync(evlog_state.fd);
+    close(evlog_state.fd);
+    evlog_state.fd = -1;
+    evlog_state.ring = NULL;
+    pthread_mutex_unlock(&evlog_state.drain_lock);
+
+    uint64_t dropped = atomic_load(&evlog_state.dropped);
+    if (dropped > 0) {
+        printf("[EVLOG] 环形缓冲溢出，丢弃事件 %llu 条\n", (unsigned long long)dropped);
+    }
+
+    free(slots);
+    free(evlog_state.write_buf);
+    evlog_state.write_buf = NULL;
+}
@@ -0,0 +1,171 @@
+#ifndef RE_EVLOG_H
+#define RE_EVLOG_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @file re_evlog.h
+ * @brief Binary structured event log for the response executor
+ *
+ * Events are encoded into a preallocated lock-free ring by the executing
+ * threads and written to disk in batches by a background flusher thread.
+ *
+ * On-disk layout:
+ *   file header  : re_evlog_file_header_t (16 bytes, little-endian)
+ *   record header: size(u8) event(u8) subsystem(u8) flags(u8)
+ *   record body  : varint ts_delta_ns, varint response_id, varint zones,
+ *                  varint zigzag(value) [, varint text_len, text bytes]
+ *
+ * `size` covers the whole record including its header, so readers can
+ * skip records they do not understand.
+ */
+
+#define RE_EVLOG_MAGIC            0x474C5652u  // "RVLG"
+#define RE_EVLOG_VERSION          1
+#define RE_EVLOG_MAX_TEXT         63           // Bytes of text kept per record
+#define RE_EVLOG_MAX_RECORD       (4 + 4 * 10 + 1 + RE_EVLOG_MAX_TEXT)
+
+#define RE_EVLOG_FLAG_TEXT        0x01         // Record carries a text field
+
+// Event log file header
+typedef struct {
+    uint32_t magic;                   // RE_EVLOG_MAGIC
+    uint16_t version;                 // RE_EVLOG_VERSION
+    uint16_t reserved;                // Must be zero
+    uint64_t base_time_ns;            // CLOCK_REALTIME when the log was opened
+} re_evlog_file_header_t;
+
+// Event type enumeration
+typedef enum {
+    RE_EV_INIT = 1,                   // Subsystem initialized
+    RE_EV_SHUTDOWN,                   // Subsystem shut down
+    RE_EV_RESPONSE_BEGIN,             // Response execution started (value = type)
+    RE_EV_RESPONSE_END,               // Response execution finished (value = result)
+    RE_EV_STEP_OK,                    // Sub-operation succeeded
+    RE_EV_STEP_FAIL,                  // Sub-operation failed (value = error)
+    RE_EV_EMERGENCY,                  // Emergency sequence triggered (value = level)
+    RE_EV_COUNT
+} re_event_t;
+
+// Subsystem enumeration (mirrors the console log tags)
+typedef enum {
+    RE_SUB_CORE = 0,
+    RE_SUB_HARDWARE,
+    RE_SUB_ACCESS,
+    RE_SUB_NETWORK,
+    RE_SUB_SERVICE,
+    RE_SUB_SURVEILLANCE,
+    RE_SUB_EVACUATION,
+    RE_SUB_POWER,
+    RE_SUB_COMMS,
+    RE_SUB_BACKUP,
+    RE_SUB_CONTAINMENT,
+    RE_SUB_RECOVERY,
+    RE_SUB_COUNT
+} re_subsystem_t;
+
+// ============================================================================
+// ENCODING HELPERS (shared by the writer and the decoder tool)
+// ============================================================================
+
+static inline const char* re_evlog_event_name(uint8_t event) {
+    static const char* const names[RE_EV_COUNT] = {
+        "unknown", "init", "shutdown", "response_begin", "response_end",
+        "step_ok", "step_fail", "emergency"
+    };
+    return event < RE_EV_COUNT ? names[event] : "unknown";
+}
+
+static inline const char* re_evlog_subsystem_name(uint8_t subsystem) {
+    static const char* const names[RE_SUB_COUNT] = {
+        "CORE", "HARDWARE", "ACCESS", "NETWORK", "SERVICE", "SURVEILLANCE",
+        "EVACUATION", "POWER", "COMMS", "BACKUP", "CONTAINMENT", "RECOVERY"
+    };
+    return subsystem < RE_SUB_COUNT ? names[subsystem] : "UNKNOWN";
+}
+
+static inline size_t re_varint_put(uint8_t* out, uint64_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+// Returns the number of bytes consumed, 0 on truncated/overlong input
+static inline size_t re_varint_get(const uint8_t* in, size_t avail, uint64_t* v) {
+    uint64_t result = 0;
+    for (size_t i = 0; i < avail && i < 10; i++) {
+        result |= (uint64_t)(in[i] & 0x7F) << (7 * i);
+        if (!(in[i] & 0x80)) {
+            *v = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+static inline uint64_t re_zigzag_encode(int64_t v) {
+    return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static inline int64_t re_zigzag_decode(uint64_t v) {
+    return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+// ============================================================================
+// WRITER API
+// ============================================================================
+
+/**
+ * @brief Open the binary event log
+ *
+ * Allocates the event ring and starts the background flusher thread.
+ * Events emitted before the log is opened are silently discarded.
+ *
+ * @param path Output file path (appended to if it already holds a log)
+ * @param ring_slots Ring capacity in events, rounded up to a power of two
+ *                   (0 selects the default of 4096)
+ * @param flush_interval_ms Flusher period in milliseconds (0 selects 100ms)
+ * @return RESPONSE_SUCCESS on success, error code on failure
+ */
+int32_t re_evlog_open(const char* path, uint32_t ring_slots, uint32_t flush_interval_ms);
+
+/**
+ * @brief Record a structured event
+ *
+ * Lock-free and non-blocking: the event is encoded straight into a ring
+ * slot. If the ring is full the event is dropped and counted.
+ *
+ * @param event Event type (re_event_t)
+ * @param subsystem Originating subsystem (re_subsystem_t)
+ * @param response_id Response identifier, 0 if not response related
+ * @param zones Zone bitmask affected by the event
+ * @param value Event specific value (result code, level, ...)
+ * @param text Optional short text, truncated to RE_EVLOG_MAX_TEXT, may be NULL
+ */
+void re_evlog_emit(uint8_t event, uint8_t subsystem, uint64_t response_id,
+                   uint32_t zones, int64_t value, const char* text);
+
+/**
+ * @brief Write all pending events to disk immediately
+ *
+ * @return RESPONSE_SUCCESS on success, error code on failure
+ */
+int32_t re_evlog_flush(void);
+
+/**
+ * @brief Number of events dropped because the ring was full
+ */
+uint64_t re_evlog_dropped(void);
+
+/**
+ * @brief Flush pending events, stop the flusher and close the log
+ */
+void re_evlog_close(void);
+
+#endif // RE_EVLOG_H
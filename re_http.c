@@ -0,0 +1,849 @@
+#define _GNU_SOURCE
+#include "re_http.h"
+#include "re_json.h"
+#include "re_evlog.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#define HTTP_IN_BUFFER     8192
+#define HTTP_OUT_BUFFER    16384
+#define HTTP_BODY_MAX      6144             // 单个响应体上限，输出缓冲不足时暂停处理流水线请求
+#define HTTP_MAX_EVENTS    64
+#define HTTP_MAX_TOKENS    64
+#define HTTP_TAG_LISTEN    0xFFFFFFFFu
+#define HTTP_TAG_WAKE      0xFFFFFFFEu
+
+typedef struct {
+    int fd;                           // -1 表示空闲
+    bool close_after;                 // 发送完成后关闭
+    bool writing;                     // 正在等待 EPOLLOUT
+    uint32_t in_len;
+    uint32_t out_len;
+    uint32_t out_sent;
+    char in[HTTP_IN_BUFFER];
+    char out[HTTP_OUT_BUFFER];
+} http_conn_t;
+
+typedef enum {
+    JOB_FREE = 0,
+    JOB_QUEUED,
+    JOB_RUNNING,
+    JOB_DONE,
+    JOB_CANCELLED
+} job_state_t;
+
+static const char* const job_state_names[] = { "free", "queued", "running", "done", "cancelled" };
+
+typedef struct {
+    uint64_t id;
+    job_state_t state;
+    int32_t result;
+    uint64_t submitted;               // Unix 时间
+    uint64_t finished;
+    integrated_response_t response;
+} http_job_t;
+
+static const char* const response_type_names[RESPONSE_TYPE_COUNT] = {
+    NULL, "lockdown", "network_isolate", "service_failover", "evacuation",
+    "backup_activate", "comms_priority", "partial_contain", "full_recovery",
+    "heightened_surveillance"
+};
+
+// === 服务器状态 ===
+static struct {
+    bool running;
+    int listen_fd;
+    int epoll_fd;
+    int wake_fd;
+    uint16_t port;
+    re_ctx_t* ctx;
+    _Atomic uint8_t max_auth;         // 接口未鉴权，请求可声明的最高授权级别
+    pthread_t loop;
+    http_conn_t* conns;
+    uint32_t free_conns[RE_HTTP_MAX_CONNECTIONS];
+    uint32_t free_count;
+    // 执行队列（受 job_lock 保护）
+    http_job_t* jobs;
+    uint64_t queue[RE_HTTP_MAX_JOBS];
+    uint32_t queue_head;
+    uint32_t queue_len;               // 队列中的 ID 数（含已取消的）
+    uint32_t queued_jobs;             // 等待执行的响应数
+    uint32_t running_jobs;
+    uint64_t next_id;
+    bool workers_running;
+    unsigned worker_count;
+    pthread_t workers[RE_HTTP_MAX_WORKERS];
+    pthread_mutex_t job_lock;
+    pthread_cond_t job_ready;
+    // 计数器
+    _Atomic uint64_t requests;
+    _Atomic uint64_t bad_requests;
+    _Atomic uint64_t submitted;
+    _Atomic uint64_t rejected;
+    _Atomic uint64_t completed;
+    _Atomic uint64_t failed;
+    _Atomic uint64_t cancelled;
+    _Atomic uint32_t connections;
+    pthread_mutex_t lock;             // 串行化启动与停止
+} http_state = { .listen_fd = -1, .epoll_fd = -1, .wake_fd = -1, .max_auth = RE_HTTP_DEFAULT_MAX_AUTH,
+                 .job_lock = PTHREAD_MUTEX_INITIALIZER, .job_ready = PTHREAD_COND_INITIALIZER,
+                 .lock = PTHREAD_MUTEX_INITIALIZER };
+
+// === 执行队列 ===
+
+static void* worker_thread(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&http_state.job_lock);
+    for (;;) {
+        while (http_state.workers_running && http_state.queue_len == 0) {
+            pthread_cond_wait(&http_state.job_ready, &http_state.job_lock);
+        }
+        if (!http_state.workers_running) break;
+
+        uint64_t id = http_state.queue[http_state.queue_head];
+        http_state.queue_head = (http_state.queue_head + 1) % RE_HTTP_MAX_JOBS;
+        http_state.queue_len--;
+        http_job_t* job = &http_state.jobs[id % RE_HTTP_MAX_JOBS];
+        // 排队期间被取消的响应直接跳过
+        if (job->id != id || job->state != JOB_QUEUED) continue;
+
+        job->state = JOB_RUNNING;
+        http_state.queued_jobs--;
+        http_state.running_jobs++;
+        integrated_response_t response = job->response;
+        pthread_mutex_unlock(&http_state.job_lock);
+
+        int32_t result = re_ctx_execute(http_state.ctx, &response);
+
+        pthread_mutex_lock(&http_state.job_lock);
+        http_state.running_jobs--;
+        job->state = JOB_DONE;
+        job->result = result;
+        job->finished = (uint64_t)time(NULL);
+        atomic_fetch_add(result == RESPONSE_SUCCESS ? &http_state.completed : &http_state.failed, 1);
+    }
+    pthread_mutex_unlock(&http_state.job_lock);
+    return NULL;
+}
+
+// 入队成功返回分配的 ID，队列已满返回 0
+static uint64_t job_submit(const integrated_response_t* response) {
+    pthread_mutex_lock(&http_state.job_lock);
+    uint64_t id = http_state.next_id;
+    http_job_t* job = &http_state.jobs[id % RE_HTTP_MAX_JOBS];
+    // 槽位复用最早的记录，仍在排队或执行的不能覆盖
+    if (job->state == JOB_QUEUED || job->state == JOB_RUNNING || http_state.queue_len >= RE_HTTP_MAX_JOBS) {
+        pthread_mutex_unlock(&http_state.job_lock);
+        return 0;
+    }
+    http_state.next_id++;
+    job->id = id;
+    job->state = JOB_QUEUED;
+    job->result = 0;
+    job->submitted = (uint64_t)time(NULL);
+    job->finished = 0;
+    job->response = *response;
+    http_state.queue[(http_state.queue_head + http_state.queue_len) % RE_HTTP_MAX_JOBS] = id;
+    http_state.queue_len++;
+    http_state.queued_jobs++;
+    pthread_cond_signal(&http_state.job_ready);
+    pthread_mutex_unlock(&http_state.job_lock);
+    return id;
+}
+
+static bool job_lookup(uint64_t id, http_job_t* out) {
+    pthread_mutex_lock(&http_state.job_lock);
+    const http_job_t* job = &http_state.jobs[id % RE_HTTP_MAX_JOBS];
+    bool found = id != 0 && job->id == id && job->state != JOB_FREE;
+    if (found) *out = *job;
+    pthread_mutex_unlock(&http_state.job_lock);
+    return found;
+}
+
+// 只能取消尚未开始执行的响应
+static job_state_t job_cancel(uint64_t id, bool* found) {
+    pthread_mutex_lock(&http_state.job_lock);
+    http_job_t* job = &http_state.jobs[id % RE_HTTP_MAX_JOBS];
+    *found = id != 0 && job->id == id && job->state != JOB_FREE;
+    job_state_t state = *found ? job->state : JOB_FREE;
+    if (state == JOB_QUEUED) {
+        job->state = JOB_CANCELLED;
+        http_state.queued_jobs--;
+        job->result = RESPONSE_ERROR_SHUTDOWN;
+        job->finished = (uint64_t)time(NULL);
+        state = JOB_CANCELLED;
+        atomic_fetch_add(&http_state.cancelled, 1);
+    }
+    pthread_mutex_unlock(&http_state.job_lock);
+    return state;
+}
+
+// === 响应输出 ===
+
+static const char* status_text(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 202: return "Accepted";
+        case 400: return "Bad Request";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 409: return "Conflict";
+        case 413: return "Payload Too Large";
+        case 431: return "Request Header Fields Too Large";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        default:  return "Internal Server Error";
+    }
+}
+
+static void conn_respond(http_conn_t* c, int status, const char* content_type, const char* body, size_t body_len) {
+    size_t room = sizeof(c->out) - c->out_len;
+    int n = snprintf(c->out + c->out_len, room,
+                     "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\n%s\r\n",
+                     status, status_text(status), content_type, body_len,
+                     c->close_after ? "Connection: close\r\n" : "");
+    if (n < 0 || (size_t)n + body_len > room) {
+        // 调用前已保证空间，这里只作防护
+        c->close_after = true;
+        return;
+    }
+    memcpy(c->out + c->out_len + n, body, body_len);
+    c->out_len += (uint32_t)n + (uint32_t)body_len;
+}
+
+static void conn_error(http_conn_t* c, int status, const char* message) {
+    char body[128];
+    int n = snprintf(body, sizeof(body), "{\"error\":\"%s\"}", message);
+    conn_respond(c, status, "application/json", body, (size_t)n);
+}
+
+// 追加 JSON 字符串（含引号），返回新的长度；空间不足时截断
+static size_t json_put_string(char* buf, size_t len, size_t cap, const char* s) {
+    if (len + 2 >= cap) return len;
+    buf[len++] = '"';
+    for (; *s && len + 7 < cap; s++) {
+        unsigned char ch = (unsigned char)*s;
+        if (ch == '"' || ch == '\\') {
+            buf[len++] = '\\';
+            buf[len++] = (char)ch;
+        } else if (ch < 0x20) {
+            len += (size_t)snprintf(buf + len, cap - len, "\\u%04x", ch);
+        } else {
+            buf[len++] = (char)ch;
+        }
+    }
+    buf[len++] = '"';
+    buf[len] = '\0';
+    return len;
+}
+
+// === 接口处理 ===
+
+static bool parse_response_type(const char* js, const re_json_token_t* tok, int64_t* out) {
+    if (tok->type == RE_JSON_PRIMITIVE) return re_json_int(js, tok, out);
+
+    char name[32];
+    if (re_json_string(js, tok, name, sizeof(name)) < 0) return false;
+    for (size_t i = 1; i < sizeof(response_type_names) / sizeof(response_type_names[0]); i++) {
+        if (strcmp(name, response_type_names[i]) == 0) {
+            *out = (int64_t)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// 读取可选的整数字段，存在但越界或类型不符时失败
+static bool json_field_int(const char* js, const re_json_token_t* tokens, int count, const char* key,
+                           int64_t min, int64_t max, int64_t* value) {
+    int i = re_json_find(js, tokens, count, 0, key);
+    if (i < 0) return true;
+    int64_t v;
+    if (!re_json_int(js, &tokens[i], &v) || v < min || v > max) return false;
+    *value = v;
+    return true;
+}
+
+static void handle_submit(http_conn_t* c, const char* body, size_t len) {
+    re_json_parser_t parser;
+    re_json_token_t tokens[HTTP_MAX_TOKENS];
+    re_json_init(&parser);
+    int count = re_json_parse(&parser, body, len, tokens, HTTP_MAX_TOKENS);
+    if (count <= 0 || tokens[0].type != RE_JSON_OBJECT) {
+        atomic_fetch_add(&http_state.bad_requests, 1);
+        conn_error(c, 400, "malformed JSON");
+        return;
+    }
+
+    integrated_response_t response;
+    memset(&response, 0, sizeof(response));
+    int64_t type = 0, severity = 0, zones = 0, auth = 0, duration = 0, timeout = 0, retry = 0;
+    int64_t timestamp = (int64_t)time(NULL);
+    int type_tok = re_json_find(body, tokens, count, 0, "type");
+    int trigger_tok = re_json_find(body, tokens, count, 0, "trigger");
+    bool ok = type_tok >= 0 && parse_response_type(body, &tokens[type_tok], &type) &&
+              json_field_int(body, tokens, count, "severity", 0, 255, &severity) &&
+              json_field_int(body, tokens, count, "zones", 0, UINT32_MAX, &zones) &&
+              json_field_int(body, tokens, count, "auth_level", 0, 255, &auth) &&
+              json_field_int(body, tokens, count, "duration", 0, UINT32_MAX, &duration) &&
+              json_field_int(body, tokens, count, "timeout", 0, UINT16_MAX, &timeout) &&
+              json_field_int(body, tokens, count, "retry", 0, UINT32_MAX, &retry) &&
+              json_field_int(body, tokens, count, "timestamp", 0, INT64_MAX, &timestamp) &&
+              (trigger_tok < 0 || re_json_string(body, &tokens[trigger_tok], response.trigger_event,
+                                                 sizeof(response.trigger_event)) >= 0);
+    if (ok) {
+        response.type = (response_type_t)type;
+        response.severity = (uint8_t)severity;
+        response.target_zones = (uint32_t)zones;
+        response.auth_level = (auth_level_t)auth;
+        response.duration = (uint32_t)duration;
+        response.timeout_seconds = (uint16_t)timeout;
+        response.retry_count = (uint32_t)retry;
+        response.timestamp = (uint64_t)timestamp;
+        ok = re_validate_parameters(&response);
+    }
+    if (!ok) {
+        atomic_fetch_add(&http_state.bad_requests, 1);
+        conn_error(c, 400, "invalid response parameters");
+        return;
+    }
+    // 本机任何进程都能连接，声明的授权级别不得超过服务器允许的上限
+    if (auth > atomic_load(&http_state.max_auth)) {
+        atomic_fetch_add(&http_state.bad_requests, 1);
+        conn_error(c, 403, "auth_level exceeds server limit");
+        return;
+    }
+
+    uint64_t id = job_submit(&response);
+    if (id == 0) {
+        atomic_fetch_add(&http_state.rejected, 1);
+        conn_error(c, 503, "queue full");
+        return;
+    }
+    atomic_fetch_add(&http_state.submitted, 1);
+
+    char out[64];
+    int n = snprintf(out, sizeof(out), "{\"id\":%llu}", (unsigned long long)id);
+    conn_respond(c, 202, "application/json", out, (size_t)n);
+}
+
+static void handle_job(http_conn_t* c, bool cancel, const char* id_text) {
+    char* end;
+    errno = 0;
+    unsigned long long id = strtoull(id_text, &end, 10);
+    if (errno != 0 || end == id_text || *end != '\0') {
+        conn_error(c, 404, "not found");
+        return;
+    }
+
+    if (cancel) {
+        bool found;
+        job_state_t state = job_cancel(id, &found);
+        if (!found) {
+            conn_error(c, 404, "not found");
+        } else if (state != JOB_CANCELLED) {
+            conn_error(c, 409, state == JOB_RUNNING ? "already executing" : "already finished");
+        } else {
+            char out[64];
+            int n = snprintf(out, sizeof(out), "{\"id\":%llu,\"state\":\"cancelled\"}", id);
+            conn_respond(c, 200, "application/json", out, (size_t)n);
+        }
+        return;
+    }
+
+    http_job_t job;
+    if (!job_lookup(id, &job)) {
+        conn_error(c, 404, "not found");
+        return;
+    }
+    char out[512];
+    size_t n = (size_t)snprintf(out, sizeof(out),
+                                "{\"id\":%llu,\"state\":\"%s\",\"result\":%d,\"type\":%d,\"zones\":%u,"
+                                "\"submitted\":%llu,\"finished\":%llu,\"trigger\":",
+                                id, job_state_names[job.state], job.result, job.response.type,
+                                job.response.target_zones, (unsigned long long)job.submitted,
+                                (unsigned long long)job.finished);
+    n = json_put_string(out, n, sizeof(out) - 1, job.response.trigger_event);
+    out[n++] = '}';
+    conn_respond(c, 200, "application/json", out, n);
+}
+
+static void handle_status(http_conn_t* c) {
+    pthread_mutex_lock(&http_state.job_lock);
+    uint32_t queued = http_state.queued_jobs;
+    uint32_t running = http_state.running_jobs;
+    pthread_mutex_unlock(&http_state.job_lock);
+
+    char out[160];
+    int n = snprintf(out, sizeof(out), "{\"mode\":%d,\"queued\":%u,\"running\":%u,\"connections\":%u}",
+                     re_ctx_get_system_status(http_state.ctx), queued, running,
+                     atomic_load(&http_state.connections));
+    conn_respond(c, 200, "application/json", out, (size_t)n);
+}
+
+static void handle_report(http_conn_t* c) {
+    execution_report_t report;
+    if (re_ctx_get_last_report(http_state.ctx, &report) != RESPONSE_SUCCESS) {
+        conn_error(c, 503, "executor not initialized");
+        return;
+    }
+    report.status_summary[sizeof(report.status_summary) - 1] = '\0';
+    report.error_details[sizeof(report.error_details) - 1] = '\0';
+
+    char out[HTTP_BODY_MAX];
+    size_t n = (size_t)snprintf(out, sizeof(out),
+                                "{\"response_id\":%llu,\"result\":%d,\"start_time\":%llu,\"end_time\":%llu,"
+                                "\"sub_operations\":%u,\"success\":%u,\"failed\":%u,\"warnings\":%u,"
+                                "\"mode\":%d,\"summary\":",
+                                (unsigned long long)report.response_id, report.overall_result,
+                                (unsigned long long)report.start_time, (unsigned long long)report.end_time,
+                                report.sub_operations, report.success_count, report.failed_count,
+                                report.warning_count, report.system_mode);
+    n = json_put_string(out, n, sizeof(out) - 32, report.status_summary);
+    n += (size_t)snprintf(out + n, sizeof(out) - n, ",\"errors\":");
+    n = json_put_string(out, n, sizeof(out) - 2, report.error_details);
+    out[n++] = '}';
+    conn_respond(c, 200, "application/json", out, n);
+}
+
+static void handle_metrics(http_conn_t* c) {
+    pthread_mutex_lock(&http_state.job_lock);
+    uint32_t queued = http_state.queued_jobs;
+    uint32_t running = http_state.running_jobs;
+    pthread_mutex_unlock(&http_state.job_lock);
+
+    char out[1024];
+    int n = snprintf(out, sizeof(out),
+                     "re_http_requests_total %llu\n"
+                     "re_http_bad_requests_total %llu\n"
+                     "re_http_connections %u\n"
+                     "re_responses_submitted_total %llu\n"
+                     "re_responses_rejected_total %llu\n"
+                     "re_responses_completed_total %llu\n"
+                     "re_responses_failed_total %llu\n"
+                     "re_responses_cancelled_total %llu\n"
+                     "re_responses_queued %u\n"
+                     "re_responses_running %u\n"
+                     "re_system_mode %d\n"
+                     "re_evlog_dropped_total %llu\n",
+                     (unsigned long long)atomic_load(&http_state.requests),
+                     (unsigned long long)atomic_load(&http_state.bad_requests),
+                     atomic_load(&http_state.connections),
+                     (unsigned long long)atomic_load(&http_state.submitted),
+                     (unsigned long long)atomic_load(&http_state.rejected),
+                     (unsigned long long)atomic_load(&http_state.completed),
+                     (unsigned long long)atomic_load(&http_state.failed),
+                     (unsigned long long)atomic_load(&http_state.cancelled),
+                     queued, running, re_ctx_get_system_status(http_state.ctx),
+                     (unsigned long long)re_evlog_dropped());
+    conn_respond(c, 200, "text/plain; version=0.0.4", out, (size_t)n);
+}
+
+static void route(http_conn_t* c, const char* method, const char* path, const char* body, size_t body_len) {
+    atomic_fetch_add_explicit(&http_state.requests, 1, memory_order_relaxed);
+    bool get = strcmp(method, "GET") == 0;
+
+    if (strcmp(path, "/v1/status") == 0) {
+        if (get) handle_status(c); else conn_error(c, 405, "method not allowed");
+    } else if (strcmp(path, "/v1/reports") == 0) {
+        if (get) handle_report(c); else conn_error(c, 405, "method not allowed");
+    } else if (strcmp(path, "/metrics") == 0) {
+        if (get) handle_metrics(c); else conn_error(c, 405, "method not allowed");
+    } else if (strcmp(path, "/v1/responses") == 0) {
+        if (strcmp(method, "POST") == 0) handle_submit(c, body, body_len);
+        else conn_error(c, 405, "method not allowed");
+    } else if (strncmp(path, "/v1/responses/", 14) == 0) {
+        if (get) handle_job(c, false, path + 14);
+        else if (strcmp(method, "DELETE") == 0) handle_job(c, true, path + 14);
+        else conn_error(c, 405, "method not allowed");
+    } else {
+        conn_error(c, 404, "not found");
+    }
+}
+
+// === HTTP 解析 ===
+
+static bool span_equals(const char* p, const char* end, const char* text) {
+    size_t len = strlen(text);
+    return (size_t)(end - p) == len && strncasecmp(p, text, len) == 0;
+}
+
+/*
+ * 解析输入缓冲中的完整请求并依次应答（支持流水线）。
+ * 请求头在缓冲内原地扫描，不复制；请求体未收全时不修改缓冲，等待更多数据。
+ * 输出缓冲不足以容纳下一个应答时暂停，待发送后继续。
+ */
+static void conn_process(http_conn_t* c) {
+    while (c->in_len > 0 && !c->close_after && sizeof(c->out) - c->out_len >= HTTP_BODY_MAX + 256) {
+        char* head_end = memmem(c->in, c->in_len, "\r\n\r\n", 4);
+        if (!head_end) {
+            if (c->in_len == sizeof(c->in)) {
+                c->close_after = true;
+                conn_error(c, 431, "header too large");
+            }
+            return;
+        }
+        size_t head_len = (size_t)(head_end - c->in) + 4;
+
+        // 请求行：METHOD SP PATH SP HTTP/1.x
+        char* line_end = memmem(c->in, head_len, "\r\n", 2);
+        char* path = memchr(c->in, ' ', (size_t)(line_end - c->in));
+        char* version = path ? memchr(path + 1, ' ', (size_t)(line_end - path - 1)) : NULL;
+        if (!path || !version || path == c->in || version == path + 1) {
+            c->close_after = true;
+            atomic_fetch_add(&http_state.bad_requests, 1);
+            conn_error(c, 400, "bad request line");
+            return;
+        }
+        bool http10 = span_equals(version + 1, line_end, "HTTP/1.0");
+        if (!http10 && !span_equals(version + 1, line_end, "HTTP/1.1")) {
+            c->close_after = true;
+            conn_error(c, 400, "unsupported HTTP version");
+            return;
+        }
+
+        bool keep_alive = !http10;
+        size_t content_length = 0;
+        bool chunked = false;
+        bool bad_length = false;
+        for (char* line = line_end + 2; line < head_end + 2;) {
+            char* eol = memmem(line, (size_t)(head_end + 2 - line), "\r\n", 2);
+            char* colon = memchr(line, ':', (size_t)(eol - line));
+            if (colon) {
+                char* value = colon + 1;
+                while (value < eol && (*value == ' ' || *value == '\t')) value++;
+                char* value_end = eol;
+                while (value_end > value && (value_end[-1] == ' ' || value_end[-1] == '\t')) value_end--;
+
+                if (span_equals(line, colon, "Content-Length")) {
+                    content_length = 0;
+                    bad_length = value == value_end;
+                    for (char* p = value; p < value_end && !bad_length; p++) {
+                        if (*p < '0' || *p > '9') bad_length = true;
+                        else content_length = content_length * 10 + (size_t)(*p - '0');
+                        if (content_length > RE_HTTP_MAX_BODY) bad_length = true;
+                    }
+                } else if (span_equals(line, colon, "Connection")) {
+                    if (span_equals(value, value_end, "close")) keep_alive = false;
+                    else if (span_equals(value, value_end, "keep-alive")) keep_alive = true;
+                } else if (span_equals(line, colon, "Transfer-Encoding")) {
+                    chunked = true;
+                }
+            }
+            line = eol + 2;
+        }
+
+        if (chunked || bad_length) {
+            c->close_after = true;
+            conn_error(c, chunked ? 501 : 413, chunked ? "chunked bodies not supported" : "body too large");
+            return;
+        }
+        if (head_len + content_length > sizeof(c->in)) {
+            c->close_after = true;
+            conn_error(c, 413, "request too large");
+            return;
+        }
+        if (c->in_len < head_len + content_length) return;
+
+        // 请求完整后才切分请求行
+        *path++ = '\0';
+        *version = '\0';
+        c->close_after = !keep_alive;
+        route(c, c->in, path, c->in + head_len, content_length);
+
+        size_t consumed = head_len + content_length;
+        memmove(c->in, c->in + consumed, c->in_len - consumed);
+        c->in_len -= (uint32_t)consumed;
+    }
+}
+
+// === 连接管理 ===
+
+static void conn_close(uint32_t index) {
+    http_conn_t* c = &http_state.conns[index];
+    if (c->fd < 0) return;
+    epoll_ctl(http_state.epoll_fd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    c->fd = -1;
+    http_state.free_conns[http_state.free_count++] = index;
+    atomic_fetch_sub(&http_state.connections, 1);
+}
+
+static void conn_watch(uint32_t index, bool writing) {
+    http_conn_t* c = &http_state.conns[index];
+    if (c->writing == writing) return;
+    struct epoll_event ev = { .events = writing ? EPOLLOUT : EPOLLIN, .data.u32 = index };
+    epoll_ctl(http_state.epoll_fd, EPOLL_CTL_MOD, c->fd, &ev);
+    c->writing = writing;
+}
+
+// 发送输出缓冲；全部发出返回 true，连接已关闭或需等待可写返回 false
+static bool conn_flush(uint32_t index) {
+    http_conn_t* c = &http_state.conns[index];
+    while (c->out_sent < c->out_len) {
+        ssize_t n = send(c->fd, c->out + c->out_sent, c->out_len - c->out_sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                conn_watch(index, true);
+                return false;
+            }
+            conn_close(index);
+            return false;
+        }
+        c->out_sent += (uint32_t)n;
+    }
+    c->out_len = c->out_sent = 0;
+    if (c->close_after) {
+        conn_close(index);
+        return false;
+    }
+    conn_watch(index, false);
+    return true;
+}
+
+static void conn_readable(uint32_t index) {
+    http_conn_t* c = &http_state.conns[index];
+    for (;;) {
+        if (c->in_len == sizeof(c->in)) break;
+        ssize_t n = recv(c->fd, c->in + c->in_len, sizeof(c->in) - c->in_len, 0);
+        if (n > 0) {
+            c->in_len += (uint32_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        // 对端关闭或出错
+        conn_close(index);
+        return;
+    }
+
+    // 输出缓冲满时先发出应答，再继续处理缓冲中剩余的流水线请求
+    for (;;) {
+        uint32_t before = c->in_len;
+        conn_process(c);
+        bool progressed = c->in_len != before;
+        if (!conn_flush(index) || !progressed || c->in_len == 0) break;
+    }
+}
+
+static void accept_connections(void) {
+    for (;;) {
+        int fd = accept4(http_state.listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        if (http_state.free_count == 0) {
+            close(fd);
+            continue;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        uint32_t index = http_state.free_conns[--http_state.free_count];
+        http_conn_t* c = &http_state.conns[index];
+        c->fd = fd;
+        c->close_after = false;
+        c->writing = false;
+        c->in_len = c->out_len = c->out_sent = 0;
+        struct epoll_event ev = { .events = EPOLLIN, .data.u32 = index };
+        if (epoll_ctl(http_state.epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            close(fd);
+            c->fd = -1;
+            http_state.free_conns[http_state.free_count++] = index;
+            continue;
+        }
+        atomic_fetch_add(&http_state.connections, 1);
+    }
+}
+
+static void* event_loop(void* arg) {
+    (void)arg;
+    struct epoll_event events[HTTP_MAX_EVENTS];
+    bool running = true;
+
+    while (running) {
+        int n = epoll_wait(http_state.epoll_fd, events, HTTP_MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            printf("[HTTP] epoll_wait 失败: %s\n", strerror(errno));
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            uint32_t tag = events[i].data.u32;
+            if (tag == HTTP_TAG_WAKE) {
+                running = false;
+            } else if (tag == HTTP_TAG_LISTEN) {
+                accept_connections();
+            } else if (http_state.conns[tag].fd >= 0) {
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    conn_close(tag);
+                } else if (events[i].events & EPOLLOUT) {
+                    // 积压的应答发出后处理之前暂停的请求
+                    if (conn_flush(tag)) conn_readable(tag);
+                } else {
+                    conn_readable(tag);
+                }
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < RE_HTTP_MAX_CONNECTIONS; i++) conn_close(i);
+    return NULL;
+}
+
+// === 公开API实现 ===
+
+static int listen_socket(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    // 只监听回环地址，管理接口不对外暴露
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(port),
+                                .sin_addr.s_addr = htonl(INADDR_LOOPBACK) };
+    socklen_t addr_len = sizeof(addr);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0 ||
+        getsockname(fd, (struct sockaddr*)&addr, &addr_len) != 0) {
+        close(fd);
+        return -1;
+    }
+    http_state.port = ntohs(addr.sin_port);
+    return fd;
+}
+
+static void server_release(void) {
+    if (http_state.listen_fd >= 0) close(http_state.listen_fd);
+    if (http_state.wake_fd >= 0) close(http_state.wake_fd);
+    if (http_state.epoll_fd >= 0) close(http_state.epoll_fd);
+    http_state.listen_fd = http_state.wake_fd = http_state.epoll_fd = -1;
+    free(http_state.conns);
+    free(http_state.jobs);
+    http_state.conns = NULL;
+    http_state.jobs = NULL;
+    http_state.port = 0;
+}
+
+static void workers_stop(void) {
+    pthread_mutex_lock(&http_state.job_lock);
+    http_state.workers_running = false;
+    pthread_cond_broadcast(&http_state.job_ready);
+    pthread_mutex_unlock(&http_state.job_lock);
+    for (unsigned i = 0; i < http_state.worker_count; i++) {
+        pthread_join(http_state.workers[i], NULL);
+    }
+    http_state.worker_count = 0;
+}
+
+int32_t re_http_start(uint16_t port, re_ctx_t* ctx, unsigned workers) {
+    pthread_mutex_lock(&http_state.lock);
+    if (http_state.running) {
+        pthread_mutex_unlock(&http_state.lock);
+        return RESPONSE_SUCCESS;
+    }
+
+    http_state.ctx = ctx ? ctx : re_ctx_default();
+    http_state.conns = calloc(RE_HTTP_MAX_CONNECTIONS, sizeof(http_conn_t));
+    http_state.jobs = calloc(RE_HTTP_MAX_JOBS, sizeof(http_job_t));
+    http_state.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    http_state.wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (!http_state.conns || !http_state.jobs || http_state.epoll_fd < 0 || http_state.wake_fd < 0) {
+        server_release();
+        pthread_mutex_unlock(&http_state.lock);
+        return RESPONSE_ERROR_INIT_FAILED;
+    }
+    http_state.listen_fd = listen_socket(port);
+    if (http_state.listen_fd < 0) {
+        printf("[HTTP] 无法监听 127.0.0.1:%u: %s\n", port, strerror(errno));
+        server_release();
+        pthread_mutex_unlock(&http_state.lock);
+        return RESPONSE_ERROR_NETWORK_FAILURE;
+    }
+
+    for (uint32_t i = 0; i < RE_HTTP_MAX_CONNECTIONS; i++) {
+        http_state.conns[i].fd = -1;
+        http_state.free_conns[i] = RE_HTTP_MAX_CONNECTIONS - 1 - i;
+    }
+    http_state.free_count = RE_HTTP_MAX_CONNECTIONS;
+    http_state.queue_head = http_state.queue_len = http_state.queued_jobs = http_state.running_jobs = 0;
+    http_state.next_id = 1;
+    atomic_store(&http_state.connections, 0);
+
+    struct epoll_event ev = { .events = EPOLLIN, .data.u32 = HTTP_TAG_LISTEN };
+    epoll_ctl(http_state.epoll_fd, EPOLL_CTL_ADD, http_state.listen_fd, &ev);
+    ev.data.u32 = HTTP_TAG_WAKE;
+    epoll_ctl(http_state.epoll_fd, EPOLL_CTL_ADD, http_state.wake_fd, &ev);
+
+    unsigned count = workers ? workers : RE_HTTP_DEFAULT_WORKERS;
+    if (count > RE_HTTP_MAX_WORKERS) count = RE_HTTP_MAX_WORKERS;
+    http_state.workers_running = true;
+    for (unsigned i = 0; i < count; i++) {
+        if (pthread_create(&http_state.workers[i], NULL, worker_thread, NULL) != 0) break;
+        http_state.worker_count++;
+    }
+    if (http_state.worker_count == 0 || pthread_create(&http_state.loop, NULL, event_loop, NULL) != 0) {
+        workers_stop();
+        server_release();
+        pthread_mutex_unlock(&http_state.lock);
+        return RESPONSE_ERROR_INIT_FAILED;
+    }
+
+    http_state.running = true;
+    printf("[HTTP] 管理接口已启动: 127.0.0.1:%u (%u 个执行线程)\n", http_state.port, http_state.worker_count);
+    pthread_mutex_unlock(&http_state.lock);
+    return RESPONSE_SUCCESS;
+}
+
+int32_t re_http_set_max_auth(auth_level_t level) {
+    if (level < AUTH_LEVEL_1 || level > AUTH_LEVEL_5) return RESPONSE_ERROR_INVALID_PARAM;
+    atomic_store(&http_state.max_auth, (uint8_t)level);
+    return RESPONSE_SUCCESS;
+}
+
+uint16_t re_http_port(void) {
+    pthread_mutex_lock(&http_state.lock);
+    uint16_t port = http_state.running ? http_state.port : 0;
+    pthread_mutex_unlock(&http_state.lock);
+    return port;
+}
+
+void re_http_stop(void) {
+    pthread_mutex_lock(&http_state.lock);
+    if (!http_state.running) {
+        pthread_mutex_unlock(&http_state.lock);
+        return;
+    }
+
+    uint64_t one = 1;
+    if (write(http_state.wake_fd, &one, sizeof(one)) < 0) {
+        printf("[HTTP] 唤醒事件循环失败: %s\n", strerror(errno));
+    }
+    pthread_join(http_state.loop, NULL);
+
+    // 停止执行线程；仍在排队的响应不再执行
+    workers_stop();
+    uint32_t dropped = http_state.queued_jobs;
+    http_state.queue_len = http_state.queued_jobs = 0;
+    if (dropped > 0) {
+        printf("[HTTP] 取消排队中的响应 %u 条\n", dropped);
+    }
+
+    server_release();
+    http_state.running = false;
+    printf("[HTTP] 管理接口已停止\n");
+    pthread_mutex_unlock(&http_state.lock);
+}
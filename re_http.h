@@ -0,0 +1,81 @@
+#ifndef RE_HTTP_H
+#define RE_HTTP_H
+
+#include <stdint.h>
+#include "response_executor.h"
+
+/**
+ * @file re_http.h
+ * @brief Local HTTP/JSON management API
+ *
+ * An embedded HTTP/1.1 server bound to 127.0.0.1 for operations tooling.
+ * One event-loop thread serves all connections with epoll; connections
+ * are persistent by default and pipelined requests are answered in order.
+ * Connection buffers are preallocated when the server starts and request
+ * bodies are tokenized in place with re_json, so serving a request does
+ * not allocate. Submitted responses are queued to a small pool of worker
+ * threads; the event loop never executes a response itself.
+ *
+ * Endpoints:
+ *   POST   /v1/responses       Queue a response, 202 {"id":N}
+ *   GET    /v1/responses/<id>  State and result of a queued response
+ *   DELETE /v1/responses/<id>  Cancel a response that has not started
+ *   GET    /v1/status          Mode of the context and queue depth
+ *   GET    /v1/reports         Last execution report of the context
+ *   GET    /metrics            Counters in Prometheus text format
+ *
+ * Submission body (integers, "type" may also be a name such as
+ * "network_isolate"):
+ *   {"type":2,"severity":5,"zones":3,"auth_level":3,"trigger":"ids-17",
+ *    "duration":600,"timeout":30,"retry":1,"timestamp":1700000000}
+ *
+ * Requests are not authenticated, so any local process can connect. A
+ * submission whose auth_level exceeds the configured maximum (see
+ * re_http_set_max_auth()) is refused with 403.
+ */
+
+#define RE_HTTP_MAX_CONNECTIONS   256
+#define RE_HTTP_MAX_BODY          4096
+#define RE_HTTP_MAX_JOBS          1024     // Queued plus remembered responses
+#define RE_HTTP_DEFAULT_WORKERS   4
+#define RE_HTTP_MAX_WORKERS       32
+#define RE_HTTP_DEFAULT_MAX_AUTH  AUTH_LEVEL_3
+
+/**
+ * @brief Start the server
+ *
+ * @param port TCP port on 127.0.0.1 (0 picks a free port, see re_http_port())
+ * @param ctx Context responses execute on (NULL = default context)
+ * @param workers Execution threads (0 = RE_HTTP_DEFAULT_WORKERS)
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_NETWORK_FAILURE if
+ *         the socket cannot be set up, RESPONSE_ERROR_INIT_FAILED otherwise
+ */
+int32_t re_http_start(uint16_t port, re_ctx_t* ctx, unsigned workers);
+
+/**
+ * @brief Set the highest auth_level a submission may claim
+ *
+ * Defaults to RE_HTTP_DEFAULT_MAX_AUTH. May be called while the server
+ * is running.
+ *
+ * @param level Highest accepted level
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_INVALID_PARAM if the
+ *         level is out of range
+ */
+int32_t re_http_set_max_auth(auth_level_t level);
+
+/**
+ * @brief Port the server listens on, 0 if it is not running
+ */
+uint16_t re_http_port(void);
+
+/**
+ * @brief Stop the server
+ *
+ * Closes all connections, waits for responses currently executing and
+ * cancels those still queued. Must be called before the context is
+ * destroyed.
+ */
+void re_http_stop(void);
+
+#endif // RE_HTTP_H
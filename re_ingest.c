@@ -0,0 +1,629 @@
+#define _GNU_SOURCE
+#include "re_ingest.h"
+#include "re_match.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#define INGEST_RCVBUF      (8 * 1024 * 1024)   // 告警风暴时由内核缓冲突发
+#define INGEST_TAG_UDP     0
+#define INGEST_TAG_UNIX    1
+#define INGEST_TAG_WAKE    2
+
+// 解析后的 syslog 消息（指向接收缓冲区，不复制）
+typedef struct {
+    uint8_t severity;
+    const char* host;
+    size_t host_len;
+    const char* text;
+    size_t text_len;
+} syslog_msg_t;
+
+typedef struct {
+    re_ingest_rule_t rule;
+    size_t pattern_len;
+    bool pending;                     // 响应排队或执行中，新的命中只计数
+} ingest_rule_slot_t;
+
+typedef struct {
+    uint32_t index;
+    uint32_t generation;
+    integrated_response_t response;
+} ingest_dispatch_t;
+
+// === 接收状态 ===
+static struct {
+    bool running;
+    int udp_fd;
+    int unix_fd;
+    int epoll_fd;
+    int wake_fd;
+    uint16_t udp_port;
+    uint32_t udp_bind;                // UDP 绑定地址（主机序），默认只收本机
+    struct {
+        uint32_t addr;
+        uint32_t mask;
+    } sources[RE_INGEST_MAX_SOURCES]; // UDP 来源白名单，为空时不检查
+    uint32_t source_count;
+    char unix_path[sizeof(((struct sockaddr_un*)0)->sun_path)];
+    re_ctx_t* ctx;
+    pthread_t receiver;
+    // 批量接收缓冲
+    char* buffers;
+    struct mmsghdr msgs[RE_INGEST_BATCH];
+    struct iovec iovs[RE_INGEST_BATCH];
+    struct sockaddr_in peers[RE_INGEST_BATCH];
+    // 规则与分发队列（受 lock 保护）
+    ingest_rule_slot_t rules[RE_INGEST_MAX_RULES];
+    uint32_t rule_count;
+    re_matcher_t* matcher;            // 全部规则模式编译成的自动机，增删规则时重建
+    uint32_t generation;              // 清空规则时递增，丢弃旧规则的完成通知
+    ingest_dispatch_t queue[RE_INGEST_MAX_RULES];
+    uint32_t queue_head;
+    uint32_t queue_len;
+    bool dispatching;
+    unsigned dispatcher_count;
+    pthread_t dispatchers[RE_INGEST_DISPATCHERS];
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    // 计数器
+    _Atomic uint64_t received;
+    _Atomic uint64_t malformed;
+    _Atomic uint64_t rejected;
+    _Atomic uint64_t matched;
+    _Atomic uint64_t submitted;
+    _Atomic uint64_t coalesced;
+    _Atomic uint64_t correlated;
+    _Atomic uint64_t failed;
+    pthread_mutex_t start_lock;       // 串行化启动与停止
+} ingest_state = { .udp_fd = -1, .unix_fd = -1, .epoll_fd = -1, .wake_fd = -1, .udp_bind = INADDR_LOOPBACK,
+                   .lock = PTHREAD_MUTEX_INITIALIZER, .ready = PTHREAD_COND_INITIALIZER,
+                   .start_lock = PTHREAD_MUTEX_INITIALIZER };
+
+// === syslog 解析 ===
+
+static size_t skip_token(const char* p, size_t len, size_t i) {
+    while (i < len && p[i] != ' ') i++;
+    return i;
+}
+
+// RFC 3164 时间戳 "Mmm dd hh:mm:ss "
+static bool bsd_timestamp(const char* p, size_t len) {
+    return len >= 16 && p[3] == ' ' && p[6] == ' ' && p[9] == ':' && p[12] == ':' && p[15] == ' ';
+}
+
+static bool parse_syslog(const char* p, size_t len, syslog_msg_t* msg) {
+    // 去掉结尾的换行与 NUL
+    while (len > 0 && (p[len - 1] == '\n' || p[len - 1] == '\r' || p[len - 1] == '\0')) len--;
+
+    // <PRI>，0-191，1-3 位数字
+    if (len < 3 || p[0] != '<') return false;
+    size_t i = 1;
+    unsigned pri = 0;
+    while (i < len && i <= 3 && p[i] >= '0' && p[i] <= '9') {
+        pri = pri * 10 + (unsigned)(p[i] - '0');
+        i++;
+    }
+    if (i == 1 || i >= len || p[i] != '>' || pri > 191) return false;
+    i++;
+    msg->severity = (uint8_t)(pri & 7);
+    msg->host = NULL;
+    msg->host_len = 0;
+
+    if (i + 1 < len && p[i] >= '1' && p[i] <= '9' && p[i + 1] == ' ') {
+        // RFC 5424: VERSION TIMESTAMP HOSTNAME APP-NAME PROCID MSGID SD [MSG]
+        i += 2;
+        i = skip_token(p, len, i) + 1;                       // TIMESTAMP
+        size_t host_start = i;
+        i = skip_token(p, len, i);
+        if (i > len) return false;
+        if (!(i - host_start == 1 && p[host_start] == '-')) {
+            msg->host = p + host_start;
+            msg->host_len = i - host_start;
+        }
+        for (int field = 0; field < 3 && i < len; field++) { // APP-NAME PROCID MSGID
+            i = skip_token(p, len, i + 1);
+        }
+        if (i >= len) return false;
+        i++;
+        if (i < len && p[i] == '-') {
+            i++;
+        } else {
+            // 结构化数据 [id k="v" ...]...，引号内允许 \] 转义
+            while (i < len && p[i] == '[') {
+                bool quoted = false;
+                for (i++; i < len; i++) {
+                    if (quoted && p[i] == '\\') { i++; continue; }
+                    if (p[i] == '"') quoted = !quoted;
+                    else if (!quoted && p[i] == ']') break;
+                }
+                if (i >= len) return false;
+                i++;
+            }
+        }
+        if (i < len && p[i] == ' ') i++;
+        if (len - i >= 3 && (uint8_t)p[i] == 0xEF && (uint8_t)p[i + 1] == 0xBB && (uint8_t)p[i + 2] == 0xBF) {
+            i += 3;                                          // UTF-8 BOM
+        }
+    } else if (bsd_timestamp(p + i, len - i)) {
+        // RFC 3164: TIMESTAMP [HOSTNAME] TAG: MSG
+        // 本地 syslog(3) 不带主机名，首个字段以 ':' 结尾或含 '[' 时即为 TAG
+        i += 16;
+        size_t end = skip_token(p, len, i);
+        bool is_tag = end > i && (p[end - 1] == ':' || memchr(p + i, '[', end - i) != NULL);
+        if (!is_tag && end < len) {
+            msg->host = p + i;
+            msg->host_len = end - i;
+            i = end + 1;
+        }
+    }
+
+    msg->text = p + i;
+    msg->text_len = len - i;
+    return true;
+}
+
+// === 分发 ===
+
+static void* dispatcher_thread(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&ingest_state.lock);
+    for (;;) {
+        while (ingest_state.dispatching && ingest_state.queue_len == 0) {
+            pthread_cond_wait(&ingest_state.ready, &ingest_state.lock);
+        }
+        if (!ingest_state.dispatching) break;
+
+        ingest_dispatch_t item = ingest_state.queue[ingest_state.queue_head];
+        ingest_state.queue_head = (ingest_state.queue_head + 1) % RE_INGEST_MAX_RULES;
+        ingest_state.queue_len--;
+        pthread_mutex_unlock(&ingest_state.lock);
+
+        int32_t result = re_ctx_execute(ingest_state.ctx, &item.response);
+        if (result != RESPONSE_SUCCESS) {
+            atomic_fetch_add(&ingest_state.failed, 1);
+            printf("[INGEST] 规则 %u 触发的响应执行失败: %d\n", item.index, result);
+        }
+
+        pthread_mutex_lock(&ingest_state.lock);
+        if (item.generation == ingest_state.generation) {
+            ingest_state.rules[item.index].pending = false;
+        }
+    }
+    pthread_mutex_unlock(&ingest_state.lock);
+    return NULL;
+}
+
+// 调用者持有 lock
+static void rule_fire(uint32_t index, const syslog_msg_t* msg) {
+    ingest_rule_slot_t* slot = &ingest_state.rules[index];
+    if (slot->rule.correlate[0]) {
+        uint32_t zones = slot->rule.response.target_zones;
+        if (re_correlate_observe(slot->rule.correlate, zones, zones, 1) >= 0) {
+            atomic_fetch_add(&ingest_state.correlated, 1);
+        }
+        return;
+    }
+    if (slot->pending) {
+        atomic_fetch_add(&ingest_state.coalesced, 1);
+        return;
+    }
+
+    // 每条规则最多一个待执行响应，队列不会溢出
+    ingest_dispatch_t* item = &ingest_state.queue[(ingest_state.queue_head + ingest_state.queue_len) % RE_INGEST_MAX_RULES];
+    item->index = index;
+    item->generation = ingest_state.generation;
+    item->response = slot->rule.response;
+    item->response.timestamp = (uint64_t)time(NULL);
+    char trigger[sizeof(item->response.trigger_event)];
+    snprintf(trigger, sizeof(trigger), "syslog:%.*s:%.31s",
+             (int)(msg->host ? (msg->host_len > 24 ? 24 : msg->host_len) : 5),
+             msg->host ? msg->host : "local", slot->rule.pattern);
+    memcpy(item->response.trigger_event, trigger, sizeof(trigger));
+    ingest_state.queue_len++;
+    slot->pending = true;
+    atomic_fetch_add(&ingest_state.submitted, 1);
+    pthread_cond_signal(&ingest_state.ready);
+}
+
+static bool rule_hit(uint32_t id, size_t end, void* arg) {
+    (void)end;
+    uint64_t* hits = arg;
+    hits[id / 64] |= 1ull << (id % 64);
+    return true;
+}
+
+// 调用者持有 lock
+static int32_t rules_compile(uint32_t count) {
+    re_matcher_t* matcher = re_matcher_create(0);
+    if (!matcher) return RESPONSE_ERROR_INIT_FAILED;
+    for (uint32_t r = 0; r < count; r++) {
+        if (re_matcher_add(matcher, ingest_state.rules[r].rule.pattern, ingest_state.rules[r].pattern_len, r) != RESPONSE_SUCCESS) {
+            re_matcher_destroy(matcher);
+            return RESPONSE_ERROR_INIT_FAILED;
+        }
+    }
+    if (re_matcher_compile(matcher) != RESPONSE_SUCCESS) {
+        re_matcher_destroy(matcher);
+        return RESPONSE_ERROR_INIT_FAILED;
+    }
+    re_matcher_destroy(ingest_state.matcher);
+    ingest_state.matcher = matcher;
+    return RESPONSE_SUCCESS;
+}
+
+// 白名单在接收期间不变，接收线程无需加锁
+static bool source_allowed(const struct sockaddr_in* peer, socklen_t len) {
+    if (ingest_state.source_count == 0) return true;
+    if (len < sizeof(*peer) || peer->sin_family != AF_INET) return false;
+    uint32_t addr = ntohl(peer->sin_addr.s_addr);
+    for (uint32_t i = 0; i < ingest_state.source_count; i++) {
+        if ((addr & ingest_state.sources[i].mask) == ingest_state.sources[i].addr) return true;
+    }
+    return false;
+}
+
+static void process_batch(int count, bool udp) {
+    syslog_msg_t parsed[RE_INGEST_BATCH];
+    int valid = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (udp && !source_allowed(&ingest_state.peers[i], ingest_state.msgs[i].msg_hdr.msg_namelen)) {
+            atomic_fetch_add(&ingest_state.rejected, 1);
+            continue;
+        }
+        size_t len = ingest_state.msgs[i].msg_len;
+        if (len > RE_INGEST_MESSAGE_MAX) len = RE_INGEST_MESSAGE_MAX;
+        if (parse_syslog(ingest_state.iovs[i].iov_base, len, &parsed[valid])) {
+            valid++;
+        } else {
+            atomic_fetch_add(&ingest_state.malformed, 1);
+        }
+    }
+    atomic_fetch_add(&ingest_state.received, (uint64_t)count);
+    if (valid == 0) return;
+
+    // 每批只加一次锁；每条消息一遍扫描得到全部命中的规则
+    uint64_t matched = 0;
+    pthread_mutex_lock(&ingest_state.lock);
+    for (int m = 0; m < valid && ingest_state.matcher; m++) {
+        const syslog_msg_t* msg = &parsed[m];
+        uint64_t hits[RE_INGEST_MAX_RULES / 64] = { 0 };
+        if (re_matcher_scan(ingest_state.matcher, msg->text, msg->text_len, rule_hit, hits) == 0) continue;
+
+        bool fired = false;
+        for (uint32_t w = 0; w < RE_INGEST_MAX_RULES / 64; w++) {
+            for (uint64_t bits = hits[w]; bits; bits &= bits - 1) {
+                uint32_t r = w * 64 + (uint32_t)__builtin_ctzll(bits);
+                if (msg->severity > ingest_state.rules[r].rule.max_severity) continue;
+                fired = true;
+                rule_fire(r, msg);
+            }
+        }
+        if (fired) matched++;
+    }
+    pthread_mutex_unlock(&ingest_state.lock);
+    if (matched > 0) atomic_fetch_add(&ingest_state.matched, matched);
+}
+
+// === 接收线程 ===
+
+static void drain_socket(int fd, bool udp) {
+    for (;;) {
+        for (int i = 0; i < RE_INGEST_BATCH; i++) {
+            ingest_state.msgs[i].msg_hdr.msg_iov = &ingest_state.iovs[i];
+            ingest_state.msgs[i].msg_hdr.msg_iovlen = 1;
+            // UDP 需要来源地址做白名单检查
+            ingest_state.msgs[i].msg_hdr.msg_name = udp ? &ingest_state.peers[i] : NULL;
+            ingest_state.msgs[i].msg_hdr.msg_namelen = udp ? sizeof(ingest_state.peers[i]) : 0;
+            ingest_state.msgs[i].msg_hdr.msg_control = NULL;
+            ingest_state.msgs[i].msg_hdr.msg_controllen = 0;
+        }
+        int count = recvmmsg(fd, ingest_state.msgs, RE_INGEST_BATCH, MSG_DONTWAIT, NULL);
+        if (count <= 0) {
+            if (count < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                printf("[INGEST] 接收失败: %s\n", strerror(errno));
+            }
+            return;
+        }
+        process_batch(count, udp);
+        if (count < RE_INGEST_BATCH) return;
+    }
+}
+
+static void* receiver_thread(void* arg) {
+    (void)arg;
+    struct epoll_event events[3];
+
+    for (;;) {
+        int n = epoll_wait(ingest_state.epoll_fd, events, 3, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            printf("[INGEST] epoll_wait 失败: %s\n", strerror(errno));
+            break;
+        }
+        bool stop = false;
+        for (int i = 0; i < n; i++) {
+            switch (events[i].data.u32) {
+                case INGEST_TAG_UDP:  drain_socket(ingest_state.udp_fd, true); break;
+                case INGEST_TAG_UNIX: drain_socket(ingest_state.unix_fd, false); break;
+                default:              stop = true; break;
+            }
+        }
+        if (stop) break;
+    }
+    return NULL;
+}
+
+// === 套接字 ===
+
+static void socket_tune(int fd) {
+    int size = INGEST_RCVBUF;
+    // SO_RCVBUFFORCE 需要 CAP_NET_ADMIN，失败时退回受 rmem_max 限制的 SO_RCVBUF
+    if (setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, &size, sizeof(size)) < 0) {
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+    }
+}
+
+static int udp_socket(uint16_t port) {
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    socket_tune(fd);
+
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(port),
+                                .sin_addr.s_addr = htonl(ingest_state.udp_bind) };
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    socklen_t addr_len = sizeof(addr);
+    getsockname(fd, (struct sockaddr*)&addr, &addr_len);
+    ingest_state.udp_port = ntohs(addr.sin_port);
+    return fd;
+}
+
+static int unix_socket(const char* path) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    socket_tune(fd);
+
+    // 只替换残留的套接字文件，不删除其他类型的文件
+    struct stat st;
+    if (lstat(path, &st) == 0 && S_ISSOCK(st.st_mode)) unlink(path);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    strcpy(ingest_state.unix_path, path);
+    return fd;
+}
+
+static void ingest_release(void) {
+    if (ingest_state.udp_fd >= 0) close(ingest_state.udp_fd);
+    if (ingest_state.unix_fd >= 0) close(ingest_state.unix_fd);
+    if (ingest_state.epoll_fd >= 0) close(ingest_state.epoll_fd);
+    if (ingest_state.wake_fd >= 0) close(ingest_state.wake_fd);
+    if (ingest_state.unix_path[0]) unlink(ingest_state.unix_path);
+    ingest_state.udp_fd = ingest_state.unix_fd = ingest_state.epoll_fd = ingest_state.wake_fd = -1;
+    ingest_state.unix_path[0] = '\0';
+    ingest_state.udp_port = 0;
+    free(ingest_state.buffers);
+    ingest_state.buffers = NULL;
+}
+
+static void dispatchers_stop(void) {
+    pthread_mutex_lock(&ingest_state.lock);
+    ingest_state.dispatching = false;
+    pthread_cond_broadcast(&ingest_state.ready);
+    pthread_mutex_unlock(&ingest_state.lock);
+    for (unsigned i = 0; i < ingest_state.dispatcher_count; i++) {
+        pthread_join(ingest_state.dispatchers[i], NULL);
+    }
+    ingest_state.dispatcher_count = 0;
+}
+
+// === 公共接口 ===
+
+int32_t re_ingest_add_rule(const re_ingest_rule_t* rule) {
+    if (!rule) return RESPONSE_ERROR_INVALID_PARAM;
+    size_t pattern_len = strnlen(rule->pattern, RE_INGEST_PATTERN_MAX);
+    if (pattern_len == 0 || pattern_len == RE_INGEST_PATTERN_MAX) return RESPONSE_ERROR_INVALID_PARAM;
+
+    // 关联规则只用响应的目标区域作为关联键，不执行响应本身
+    if (rule->correlate[0]) {
+        if (strnlen(rule->correlate, RE_CORR_EVENT_MAX) == RE_CORR_EVENT_MAX) return RESPONSE_ERROR_INVALID_PARAM;
+    } else {
+        integrated_response_t check = rule->response;
+        check.trigger_event[0] = '\0';
+        if (!re_validate_parameters(&check)) return RESPONSE_ERROR_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&ingest_state.lock);
+    if (ingest_state.rule_count >= RE_INGEST_MAX_RULES) {
+        pthread_mutex_unlock(&ingest_state.lock);
+        return RESPONSE_ERROR_QUEUE_FULL;
+    }
+    uint32_t index = ingest_state.rule_count;
+    ingest_state.rules[index].rule = *rule;
+    ingest_state.rules[index].pattern_len = pattern_len;
+    ingest_state.rules[index].pending = false;
+    int32_t result = rules_compile(index + 1);
+    if (result == RESPONSE_SUCCESS) ingest_state.rule_count++;
+    pthread_mutex_unlock(&ingest_state.lock);
+    return result == RESPONSE_SUCCESS ? (int32_t)index : result;
+}
+
+void re_ingest_clear_rules(void) {
+    pthread_mutex_lock(&ingest_state.lock);
+    ingest_state.rule_count = 0;
+    re_matcher_destroy(ingest_state.matcher);
+    ingest_state.matcher = NULL;
+    ingest_state.generation++;
+    // 旧规则尚未执行的响应一并丢弃
+    ingest_state.queue_len = 0;
+    pthread_mutex_unlock(&ingest_state.lock);
+}
+
+int32_t re_ingest_set_udp_bind(uint32_t addr) {
+    pthread_mutex_lock(&ingest_state.start_lock);
+    bool running = ingest_state.running;
+    if (!running) ingest_state.udp_bind = addr;
+    pthread_mutex_unlock(&ingest_state.start_lock);
+    return running ? RESPONSE_ERROR_CONFLICT : RESPONSE_SUCCESS;
+}
+
+int32_t re_ingest_allow_source(uint32_t addr, uint8_t prefixlen) {
+    if (prefixlen > 32) return RESPONSE_ERROR_INVALID_PARAM;
+
+    pthread_mutex_lock(&ingest_state.start_lock);
+    int32_t result = RESPONSE_SUCCESS;
+    if (ingest_state.running) {
+        result = RESPONSE_ERROR_CONFLICT;
+    } else if (ingest_state.source_count >= RE_INGEST_MAX_SOURCES) {
+        result = RESPONSE_ERROR_QUEUE_FULL;
+    } else {
+        uint32_t mask = prefixlen ? 0xFFFFFFFFu << (32 - prefixlen) : 0;
+        ingest_state.sources[ingest_state.source_count].addr = addr & mask;
+        ingest_state.sources[ingest_state.source_count].mask = mask;
+        ingest_state.source_count++;
+    }
+    pthread_mutex_unlock(&ingest_state.start_lock);
+    return result;
+}
+
+int32_t re_ingest_start(uint16_t udp_port, const char* unix_path, re_ctx_t* ctx) {
+    if (udp_port == 0 && (!unix_path || !unix_path[0])) return RESPONSE_ERROR_INVALID_PARAM;
+
+    pthread_mutex_lock(&ingest_state.start_lock);
+    if (ingest_state.running) {
+        pthread_mutex_unlock(&ingest_state.start_lock);
+        return RESPONSE_SUCCESS;
+    }
+
+    ingest_state.ctx = ctx ? ctx : re_ctx_default();
+    ingest_state.buffers = malloc((size_t)RE_INGEST_BATCH * RE_INGEST_MESSAGE_MAX);
+    ingest_state.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    ingest_state.wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (!ingest_state.buffers || ingest_state.epoll_fd < 0 || ingest_state.wake_fd < 0) {
+        ingest_release();
+        pthread_mutex_unlock(&ingest_state.start_lock);
+        return RESPONSE_ERROR_INIT_FAILED;
+    }
+    for (int i = 0; i < RE_INGEST_BATCH; i++) {
+        ingest_state.iovs[i].iov_base = ingest_state.buffers + (size_t)i * RE_INGEST_MESSAGE_MAX;
+        ingest_state.iovs[i].iov_len = RE_INGEST_MESSAGE_MAX;
+    }
+
+    if (udp_port != 0) {
+        ingest_state.udp_fd = udp_socket(udp_port);
+        if (ingest_state.udp_fd < 0) {
+            printf("[INGEST] 无法绑定 UDP 端口 %u: %s\n", udp_port, strerror(errno));
+            ingest_release();
+            pthread_mutex_unlock(&ingest_state.start_lock);
+            return RESPONSE_ERROR_NETWORK_FAILURE;
+        }
+        struct epoll_event ev = { .events = EPOLLIN, .data.u32 = INGEST_TAG_UDP };
+        epoll_ctl(ingest_state.epoll_fd, EPOLL_CTL_ADD, ingest_state.udp_fd, &ev);
+    }
+    if (unix_path && unix_path[0]) {
+        ingest_state.unix_fd = unix_socket(unix_path);
+        if (ingest_state.unix_fd < 0) {
+            printf("[INGEST] 无法绑定 %s: %s\n", unix_path, strerror(errno));
+            ingest_release();
+            pthread_mutex_unlock(&ingest_state.start_lock);
+            return RESPONSE_ERROR_NETWORK_FAILURE;
+        }
+        struct epoll_event ev = { .events = EPOLLIN, .data.u32 = INGEST_TAG_UNIX };
+        epoll_ctl(ingest_state.epoll_fd, EPOLL_CTL_ADD, ingest_state.unix_fd, &ev);
+    }
+    struct epoll_event ev = { .events = EPOLLIN, .data.u32 = INGEST_TAG_WAKE };
+    epoll_ctl(ingest_state.epoll_fd, EPOLL_CTL_ADD, ingest_state.wake_fd, &ev);
+
+    pthread_mutex_lock(&ingest_state.lock);
+    ingest_state.dispatching = true;
+    ingest_state.queue_head = ingest_state.queue_len = 0;
+    for (uint32_t r = 0; r < ingest_state.rule_count; r++) ingest_state.rules[r].pending = false;
+    pthread_mutex_unlock(&ingest_state.lock);
+    for (unsigned i = 0; i < RE_INGEST_DISPATCHERS; i++) {
+        if (pthread_create(&ingest_state.dispatchers[i], NULL, dispatcher_thread, NULL) != 0) break;
+        ingest_state.dispatcher_count++;
+    }
+    if (ingest_state.dispatcher_count == 0 || pthread_create(&ingest_state.receiver, NULL, receiver_thread, NULL) != 0) {
+        dispatchers_stop();
+        ingest_release();
+        pthread_mutex_unlock(&ingest_state.start_lock);
+        return RESPONSE_ERROR_INIT_FAILED;
+    }
+
+    ingest_state.running = true;
+    printf("[INGEST] 告警接收已启动: UDP %u%s%s\n", ingest_state.udp_port,
+           ingest_state.unix_path[0] ? ", " : "", ingest_state.unix_path);
+    pthread_mutex_unlock(&ingest_state.start_lock);
+    return RESPONSE_SUCCESS;
+}
+
+uint16_t re_ingest_udp_port(void) {
+    pthread_mutex_lock(&ingest_state.start_lock);
+    uint16_t port = ingest_state.udp_port;
+    pthread_mutex_unlock(&ingest_state.start_lock);
+    return port;
+}
+
+void re_ingest_get_stats(re_ingest_stats_t* stats) {
+    if (!stats) return;
+    stats->received = atomic_load(&ingest_state.received);
+    stats->malformed = atomic_load(&ingest_state.malformed);
+    stats->rejected = atomic_load(&ingest_state.rejected);
+    stats->matched = atomic_load(&ingest_state.matched);
+    stats->submitted = atomic_load(&ingest_state.submitted);
+    stats->coalesced = atomic_load(&ingest_state.coalesced);
+    stats->correlated = atomic_load(&ingest_state.correlated);
+    stats->failed = atomic_load(&ingest_state.failed);
+}
+
+void re_ingest_stop(void) {
+    pthread_mutex_lock(&ingest_state.start_lock);
+    if (!ingest_state.running) {
+        pthread_mutex_unlock(&ingest_state.start_lock);
+        return;
+    }
+
+    uint64_t one = 1;
+    if (write(ingest_state.wake_fd, &one, sizeof(one)) < 0) {
+        printf("[INGEST] 唤醒接收线程失败: %s\n", strerror(errno));
+    }
+    pthread_join(ingest_state.receiver, NULL);
+
+    // 停止分发线程；仍在排队的响应不再执行
+    dispatchers_stop();
+    pthread_mutex_lock(&ingest_state.lock);
+    uint32_t dropped = ingest_state.queue_len;
+    ingest_state.queue_len = 0;
+    pthread_mutex_unlock(&ingest_state.lock);
+    if (dropped > 0) {
+        printf("[INGEST] 丢弃排队中的响应 %u 条\n", dropped);
+    }
+
+    ingest_release();
+    ingest_state.running = false;
+    printf("[INGEST] 告警接收已停止\n");
+    pthread_mutex_unlock(&ingest_state.start_lock);
+}
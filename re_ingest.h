@@ -0,0 +1,148 @@
+#ifndef RE_INGEST_H
+#define RE_INGEST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "response_executor.h"
+#include "re_correlate.h"
+
+/**
+ * @file re_ingest.h
+ * @brief Syslog alert ingestion
+ *
+ * Receives syslog messages from IDS sensors over UDP and/or a Unix
+ * datagram socket and maps them to responses through rules. One receiver
+ * thread drains both sockets with recvmmsg() in batches and parses the
+ * messages in the receive buffers without copying (RFC 5424 and the BSD
+ * RFC 3164 format are recognized).
+ *
+ * A rule fires when its pattern occurs in the message text and the
+ * message severity is at or above the rule's threshold. The patterns of
+ * all rules are compiled into one re_match automaton, so each message is
+ * resolved to its rules in a single pass. Fired rules are
+ * handed to dispatcher threads that execute the rule's response on the
+ * configured context. While a rule's response is queued or executing,
+ * further hits of the same rule are only counted, so an alert storm costs
+ * one execution per rule instead of one per message.
+ *
+ * The UDP socket listens on 127.0.0.1 unless another address is set with
+ * re_ingest_set_udp_bind(). When sensors send from other hosts, restrict
+ * the accepted senders with re_ingest_allow_source().
+ *
+ * A rule with a `correlate` event name does not execute its response;
+ * each hit is counted by re_correlate as that event, keyed by the rule's
+ * target zones, and correlation rules decide what to execute.
+ */
+
+#define RE_INGEST_MAX_RULES        256
+#define RE_INGEST_PATTERN_MAX      64
+#define RE_INGEST_BATCH            64       // Messages per recvmmsg() call
+#define RE_INGEST_MESSAGE_MAX      2048     // Longer datagrams are truncated
+#define RE_INGEST_DISPATCHERS      2
+#define RE_INGEST_MAX_SOURCES      32       // UDP source allowlist entries
+
+// Syslog severities (RFC 5424)
+#define RE_SYSLOG_EMERG            0
+#define RE_SYSLOG_ALERT            1
+#define RE_SYSLOG_CRIT             2
+#define RE_SYSLOG_ERR              3
+#define RE_SYSLOG_WARNING          4
+#define RE_SYSLOG_NOTICE           5
+#define RE_SYSLOG_INFO             6
+#define RE_SYSLOG_DEBUG            7
+
+// Mapping from alert text to a response
+typedef struct {
+    char pattern[RE_INGEST_PATTERN_MAX];   // Substring searched in the message text
+    uint8_t max_severity;                  // Fire for severities 0..max_severity
+    integrated_response_t response;        // Response to execute (trigger_event is filled in)
+    char correlate[RE_CORR_EVENT_MAX];     // Correlation event instead of executing (empty = none)
+} re_ingest_rule_t;
+
+// Ingestion counters
+typedef struct {
+    uint64_t received;                     // Datagrams received
+    uint64_t malformed;                    // Datagrams without a valid <PRI> header
+    uint64_t rejected;                     // UDP datagrams from sources not on the allowlist
+    uint64_t matched;                      // Messages that fired at least one rule
+    uint64_t submitted;                    // Responses handed to the dispatchers
+    uint64_t coalesced;                    // Hits absorbed by a pending response of the same rule
+    uint64_t correlated;                   // Hits passed to re_correlate
+    uint64_t failed;                       // Executions that did not succeed
+} re_ingest_stats_t;
+
+/**
+ * @brief Add a rule
+ *
+ * Rules may be added while ingestion is running.
+ *
+ * @return Rule index (>= 0) on success, RESPONSE_ERROR_INVALID_PARAM if the
+ *         pattern is empty or the response invalid, RESPONSE_ERROR_QUEUE_FULL
+ *         if RE_INGEST_MAX_RULES rules exist, RESPONSE_ERROR_INIT_FAILED if
+ *         the rule set cannot be recompiled
+ */
+int32_t re_ingest_add_rule(const re_ingest_rule_t* rule);
+
+/**
+ * @brief Remove all rules
+ */
+void re_ingest_clear_rules(void);
+
+/**
+ * @brief Set the IPv4 address the UDP socket binds to
+ *
+ * Defaults to INADDR_LOOPBACK. Must be called while ingestion is stopped.
+ *
+ * @param addr Address in host byte order (INADDR_ANY = all addresses)
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_CONFLICT if
+ *         ingestion is running
+ */
+int32_t re_ingest_set_udp_bind(uint32_t addr);
+
+/**
+ * @brief Accept UDP datagrams from a source prefix
+ *
+ * While the allowlist is empty every source is accepted; once a prefix
+ * is added, datagrams from other sources are dropped and counted as
+ * rejected. Must be called while ingestion is stopped.
+ *
+ * @param addr IPv4 network address (host byte order)
+ * @param prefixlen Prefix length (0-32)
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_INVALID_PARAM if the
+ *         prefix length is out of range, RESPONSE_ERROR_QUEUE_FULL if
+ *         RE_INGEST_MAX_SOURCES prefixes exist, RESPONSE_ERROR_CONFLICT if
+ *         ingestion is running
+ */
+int32_t re_ingest_allow_source(uint32_t addr, uint8_t prefixlen);
+
+/**
+ * @brief Start receiving
+ *
+ * @param udp_port UDP port on the bind address (0 = no UDP socket)
+ * @param unix_path Unix datagram socket path (NULL = none); an existing
+ *                  socket file is replaced
+ * @param ctx Context responses execute on (NULL = default context)
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_NETWORK_FAILURE if a
+ *         socket cannot be bound, RESPONSE_ERROR_INVALID_PARAM if neither
+ *         source is given
+ */
+int32_t re_ingest_start(uint16_t udp_port, const char* unix_path, re_ctx_t* ctx);
+
+/**
+ * @brief UDP port being received on, 0 if none
+ */
+uint16_t re_ingest_udp_port(void);
+
+/**
+ * @brief Read the counters
+ */
+void re_ingest_get_stats(re_ingest_stats_t* stats);
+
+/**
+ * @brief Stop receiving
+ *
+ * Waits for responses currently executing; queued ones are dropped.
+ */
+void re_ingest_stop(void);
+
+#endif // RE_INGEST_H
@@ -0,0 +1,169 @@
+#include "re_init.h"
+#include "response_executor.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static uint64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000ull + (uint64_t)ts.tv_nsec / 1000000ull;
+}
+
+// === 图构建 ===
+
+int32_t re_init_graph_setup(re_init_graph_t* graph, const re_init_node_t* nodes, int count, void* user) {
+    if (!graph || !nodes || count <= 0 || count > RE_INIT_MAX_NODES) return RESPONSE_ERROR_INVALID_PARAM;
+
+    // 只允许依赖序号更小的节点，保证无环
+    for (int i = 0; i < count; i++) {
+        if (!nodes[i].init || (nodes[i].deps >> i) != 0) return RESPONSE_ERROR_INVALID_PARAM;
+    }
+
+    memset(graph, 0, sizeof(*graph));
+    graph->nodes = nodes;
+    graph->count = count;
+    graph->user = user;
+    if (pthread_mutex_init(&graph->lock, NULL) != 0) return RESPONSE_ERROR_INVALID_PARAM;
+    if (pthread_cond_init(&graph->changed, NULL) != 0) {
+        pthread_mutex_destroy(&graph->lock);
+        return RESPONSE_ERROR_INVALID_PARAM;
+    }
+    return RESPONSE_SUCCESS;
+}
+
+void re_init_graph_destroy(re_init_graph_t* graph) {
+    if (!graph || !graph->nodes) return;
+    pthread_cond_destroy(&graph->changed);
+    pthread_mutex_destroy(&graph->lock);
+    graph->nodes = NULL;
+}
+
+// === 节点执行 ===
+
+/*
+ * 让节点进入终态：已就绪直接返回；他人正在初始化则等待；
+ * 否则由当前线程先依次完成依赖，再执行本节点。
+ * 依赖节点可能正由其他线程初始化，此时只等待不重复执行。
+ */
+static int node_settle(re_init_graph_t* graph, int node, bool retry) {
+    pthread_mutex_lock(&graph->lock);
+    for (;;) {
+        re_init_state_t state = graph->state[node];
+        if (state == RE_INIT_READY) {
+            pthread_mutex_unlock(&graph->lock);
+            return 0;
+        }
+        if (state == RE_INIT_FAILED && !retry) {
+            pthread_mutex_unlock(&graph->lock);
+            return -1;
+        }
+        if (state != RE_INIT_RUNNING) break;
+        pthread_cond_wait(&graph->changed, &graph->lock);
+    }
+    graph->state[node] = RE_INIT_RUNNING;
+    pthread_mutex_unlock(&graph->lock);
+
+    const re_init_node_t* desc = &graph->nodes[node];
+    int rc = 0;
+    for (int dep = 0; dep < node && rc == 0; dep++) {
+        if (desc->deps & (1u << dep)) {
+            rc = node_settle(graph, dep, retry);
+        }
+    }
+
+    uint64_t start = monotonic_ms();
+    if (rc == 0) {
+        rc = desc->init(graph->user);
+    } else {
+        printf("[INIT] 子系统 %s 的依赖未就绪，跳过\n", desc->name);
+    }
+
+    pthread_mutex_lock(&graph->lock);
+    graph->elapsed_ms[node] = monotonic_ms() - start;
+    graph->state[node] = rc == 0 ? RE_INIT_READY : RE_INIT_FAILED;
+    pthread_cond_broadcast(&graph->changed);
+    pthread_mutex_unlock(&graph->lock);
+
+    if (rc == 0) {
+        printf("[INIT] 子系统 %s 就绪 (%llu ms)\n", desc->name,
+               (unsigned long long)graph->elapsed_ms[node]);
+    }
+    return rc == 0 ? 0 : -1;
+}
+
+typedef struct {
+    re_init_graph_t* graph;
+    int node;
+} init_task_t;
+
+static void* init_worker(void* arg) {
+    init_task_t* task = arg;
+    node_settle(task->graph, task->node, false);
+    return NULL;
+}
+
+uint32_t re_init_run(re_init_graph_t* graph) {
+    if (!graph || !graph->nodes) return 0xFFFFFFFF;
+
+    init_task_t tasks[RE_INIT_MAX_NODES];
+    pthread_t threads[RE_INIT_MAX_NODES];
+    bool started[RE_INIT_MAX_NODES] = {false};
+
+    // 每个立即初始化的节点一个线程，依赖关系由节点自身等待
+    for (int i = 0; i < graph->count; i++) {
+        if (graph->nodes[i].lazy) continue;
+        tasks[i] = (init_task_t){ .graph = graph, .node = i };
+        started[i] = pthread_create(&threads[i], NULL, init_worker, &tasks[i]) == 0;
+        if (!started[i]) {
+            node_settle(graph, i, false);
+        }
+    }
+
+    uint32_t failed = 0;
+    for (int i = 0; i < graph->count; i++) {
+        if (graph->nodes[i].lazy) continue;
+        if (started[i]) pthread_join(threads[i], NULL);
+        if (!re_init_ready(graph, i)) failed |= 1u << i;
+    }
+    return failed;
+}
+
+int32_t re_init_ensure(re_init_graph_t* graph, int node) {
+    if (!graph || !graph->nodes || node < 0 || node >= graph->count) return RESPONSE_ERROR_INVALID_PARAM;
+
+    return node_settle(graph, node, true) == 0 ? RESPONSE_SUCCESS : RESPONSE_ERROR_HARDWARE_UNAVAILABLE;
+}
+
+bool re_init_ready(re_init_graph_t* graph, int node) {
+    if (!graph || !graph->nodes || node < 0 || node >= graph->count) return false;
+
+    pthread_mutex_lock(&graph->lock);
+    bool ready = graph->state[node] == RE_INIT_READY;
+    pthread_mutex_unlock(&graph->lock);
+    return ready;
+}
+
+void re_init_mark_ready(re_init_graph_t* graph, int node) {
+    if (!graph || !graph->nodes || node < 0 || node >= graph->count) return;
+
+    pthread_mutex_lock(&graph->lock);
+    while (graph->state[node] == RE_INIT_RUNNING) {
+        pthread_cond_wait(&graph->changed, &graph->lock);
+    }
+    graph->state[node] = RE_INIT_READY;
+    pthread_cond_broadcast(&graph->changed);
+    pthread_mutex_unlock(&graph->lock);
+}
+
+void re_init_reset(re_init_graph_t* graph, int node) {
+    if (!graph || !graph->nodes || node < 0 || node >= graph->count) return;
+
+    pthread_mutex_lock(&graph->lock);
+    // 正在初始化的节点不打断，等它结束后再复位
+    while (graph->state[node] == RE_INIT_RUNNING) {
+        pthread_cond_wait(&graph->changed, &graph->lock);
+    }
+    graph->state[node] = RE_INIT_PENDING;
+    pthread_mutex_unlock(&graph->lock);
+}
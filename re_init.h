@@ -0,0 +1,109 @@
+#ifndef RE_INIT_H
+#define RE_INIT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+/**
+ * @file re_init.h
+ * @brief Dependency-ordered parallel subsystem initialization
+ *
+ * Subsystems are described as nodes of a dependency graph. re_init_run()
+ * starts every eager node at once; each node waits only for its own
+ * dependencies, so independent subsystems initialize concurrently and
+ * startup takes as long as the longest dependency chain instead of the
+ * sum of all steps. Lazy nodes are skipped at startup and initialized by
+ * re_init_ensure() the first time they are needed; concurrent callers
+ * wait for the same initialization.
+ *
+ * A node may only depend on nodes with a lower index, which keeps the
+ * graph acyclic.
+ */
+
+#define RE_INIT_MAX_NODES  32
+
+/**
+ * @brief Initializes one subsystem, returns 0 on success
+ */
+typedef int (*re_init_fn)(void* user);
+
+typedef struct {
+    const char* name;      // Subsystem name for logs
+    uint32_t deps;         // Bitmask of node indices that must be ready first
+    re_init_fn init;       // Initialization step
+    bool lazy;             // Initialize on first re_init_ensure() instead of at startup
+} re_init_node_t;
+
+typedef enum {
+    RE_INIT_PENDING = 0,
+    RE_INIT_RUNNING,
+    RE_INIT_READY,
+    RE_INIT_FAILED
+} re_init_state_t;
+
+typedef struct {
+    const re_init_node_t* nodes;
+    int count;
+    void* user;                                   // Passed to every init step
+    re_init_state_t state[RE_INIT_MAX_NODES];
+    uint64_t elapsed_ms[RE_INIT_MAX_NODES];       // Duration of each step
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+} re_init_graph_t;
+
+/**
+ * @brief Prepare a graph; every node starts pending
+ *
+ * @param graph Graph storage owned by the caller
+ * @param nodes Node table, must outlive the graph
+ * @param count Number of nodes (at most RE_INIT_MAX_NODES)
+ * @param user Passed to every init step
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_INVALID_PARAM if a
+ *         node depends on itself or a later node
+ */
+int32_t re_init_graph_setup(re_init_graph_t* graph, const re_init_node_t* nodes, int count, void* user);
+
+/**
+ * @brief Initialize all eager nodes in parallel and wait for them
+ *
+ * Nodes whose dependencies failed are not run and count as failed.
+ *
+ * @return Bitmask of nodes that failed (0 = all eager nodes ready)
+ */
+uint32_t re_init_run(re_init_graph_t* graph);
+
+/**
+ * @brief Make sure a node and its dependencies are initialized
+ *
+ * Returns immediately once the node is ready. A failed node is retried.
+ *
+ * @return RESPONSE_SUCCESS if the node is ready, RESPONSE_ERROR_HARDWARE_UNAVAILABLE
+ *         if it or a dependency failed to initialize
+ */
+int32_t re_init_ensure(re_init_graph_t* graph, int node);
+
+/**
+ * @brief Whether a node has been initialized successfully
+ */
+bool re_init_ready(re_init_graph_t* graph, int node);
+
+/**
+ * @brief Mark a node ready without running it
+ *
+ * For subsystems known to be in place already, e.g. state carried over
+ * from a previous executor instance.
+ */
+void re_init_mark_ready(re_init_graph_t* graph, int node);
+
+/**
+ * @brief Mark a node pending again after its subsystem was torn down
+ */
+void re_init_reset(re_init_graph_t* graph, int node);
+
+/**
+ * @brief Release the graph's synchronization objects
+ */
+void re_init_graph_destroy(re_init_graph_t* graph);
+
+#endif // RE_INIT_H
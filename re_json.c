@@ -0,0 +1,355 @@
+#include "re_json.h"
+#include <string.h>
+
+// === 分词 ===
+
+static re_json_token_t* token_alloc(re_json_parser_t* parser, re_json_token_t* tokens, int max) {
+    if (parser->next >= max) return NULL;
+    re_json_token_t* tok = &tokens[parser->next++];
+    tok->type = RE_JSON_UNDEFINED;
+    tok->start = tok->end = -1;
+    tok->size = 0;
+    tok->parent = -1;
+    return tok;
+}
+
+static bool is_hex(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+// 数字、true、false、null；文本在值中间结束时回退到值的起点，下次调用重新扫描
+static int parse_primitive(re_json_parser_t* parser, const char* js, size_t len,
+                           re_json_token_t* tokens, int max) {
+    uint32_t start = parser->pos;
+    for (; parser->pos < len; parser->pos++) {
+        char c = js[parser->pos];
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ',' || c == ']' || c == '}') break;
+        if ((unsigned char)c < 0x20 || (unsigned char)c >= 0x7F || c == '"' || c == ':') {
+            parser->pos = start;
+            return RE_JSON_ERROR_INVALID;
+        }
+    }
+    if (parser->pos >= len) {
+        parser->pos = start;
+        return RE_JSON_ERROR_PARTIAL;
+    }
+
+    re_json_token_t* tok = token_alloc(parser, tokens, max);
+    if (!tok) {
+        parser->pos = start;
+        return RE_JSON_ERROR_NOMEM;
+    }
+    tok->type = RE_JSON_PRIMITIVE;
+    tok->start = (int32_t)start;
+    tok->end = (int32_t)parser->pos;
+    tok->parent = parser->super;
+    parser->pos--;
+    return 0;
+}
+
+static int parse_string(re_json_parser_t* parser, const char* js, size_t len,
+                        re_json_token_t* tokens, int max) {
+    uint32_t start = parser->pos;
+    parser->pos++;    // 跳过起始引号
+
+    for (; parser->pos < len; parser->pos++) {
+        unsigned char c = (unsigned char)js[parser->pos];
+        if (c == '"') {
+            re_json_token_t* tok = token_alloc(parser, tokens, max);
+            if (!tok) {
+                parser->pos = start;
+                return RE_JSON_ERROR_NOMEM;
+            }
+            tok->type = RE_JSON_STRING;
+            tok->start = (int32_t)start + 1;
+            tok->end = (int32_t)parser->pos;
+            tok->parent = parser->super;
+            return 0;
+        }
+        if (c < 0x20) {
+            parser->pos = start;
+            return RE_JSON_ERROR_INVALID;
+        }
+        if (c != '\\') continue;
+
+        if (parser->pos + 1 >= len) break;
+        parser->pos++;
+        switch (js[parser->pos]) {
+            case '"': case '/': case '\\': case 'b': case 'f': case 'r': case 'n': case 't':
+                break;
+            case 'u': {
+                int digits = 0;
+                for (; digits < 4 && parser->pos + 1 < len; digits++) {
+                    if (!is_hex(js[parser->pos + 1])) {
+                        parser->pos = start;
+                        return RE_JSON_ERROR_INVALID;
+                    }
+                    parser->pos++;
+                }
+                if (digits < 4) {
+                    parser->pos = start;
+                    return RE_JSON_ERROR_PARTIAL;
+                }
+                break;
+            }
+            default:
+                parser->pos = start;
+                return RE_JSON_ERROR_INVALID;
+        }
+    }
+    parser->pos = start;
+    return RE_JSON_ERROR_PARTIAL;
+}
+
+void re_json_init(re_json_parser_t* parser) {
+    parser->pos = 0;
+    parser->next = 0;
+    parser->super = -1;
+}
+
+/*
+ * super 指向最内层尚未结束的容器；在对象中读到冒号后指向当前键，
+ * 值的 parent 因此是键，键的 parent 是对象。逗号或右括号把 super
+ * 从键退回对象。
+ */
+int re_json_parse(re_json_parser_t* parser, const char* js, size_t len,
+                  re_json_token_t* tokens, int max) {
+    if (!parser || !js || !tokens || max <= 0) return RE_JSON_ERROR_INVALID;
+
+    for (; parser->pos < len; parser->pos++) {
+        char c = js[parser->pos];
+        re_json_token_t* super = parser->super >= 0 ? &tokens[parser->super] : NULL;
+        int rc;
+
+        switch (c) {
+            case '{':
+            case '[': {
+                // 对象内的值必须跟在键之后，一个键只能有一个值
+                if (super && (super->type == RE_JSON_OBJECT || (super->type == RE_JSON_STRING && super->size > 0))) {
+                    return RE_JSON_ERROR_INVALID;
+                }
+                re_json_token_t* tok = token_alloc(parser, tokens, max);
+                if (!tok) return RE_JSON_ERROR_NOMEM;
+                if (super) super->size++;
+                tok->type = c == '{' ? RE_JSON_OBJECT : RE_JSON_ARRAY;
+                tok->start = (int32_t)parser->pos;
+                tok->parent = parser->super;
+                parser->super = parser->next - 1;
+                break;
+            }
+            case '}':
+            case ']': {
+                re_json_type_t type = c == '}' ? RE_JSON_OBJECT : RE_JSON_ARRAY;
+                int open = parser->super;
+                if (open >= 0 && tokens[open].type == RE_JSON_STRING) {
+                    if (tokens[open].size == 0) return RE_JSON_ERROR_INVALID;
+                    open = tokens[open].parent;
+                } else if (open >= 0 && tokens[open].type == RE_JSON_OBJECT && tokens[open].size > 0) {
+                    // 非空对象的 super 应停在最后一个键上：缺少冒号或结尾多余逗号
+                    return RE_JSON_ERROR_INVALID;
+                }
+                if (open < 0 || tokens[open].type != type || tokens[open].end != -1) {
+                    return RE_JSON_ERROR_INVALID;
+                }
+                tokens[open].end = (int32_t)parser->pos + 1;
+                parser->super = tokens[open].parent;
+                break;
+            }
+            case '"':
+                if (super && super->type == RE_JSON_STRING && super->size > 0) return RE_JSON_ERROR_INVALID;
+                rc = parse_string(parser, js, len, tokens, max);
+                if (rc < 0) return rc;
+                if (super) super->size++;
+                break;
+            case ':': {
+                int key = parser->next - 1;
+                if (!super || super->type != RE_JSON_OBJECT || key < 0 ||
+                    tokens[key].type != RE_JSON_STRING || tokens[key].parent != parser->super) {
+                    return RE_JSON_ERROR_INVALID;
+                }
+                parser->super = key;
+                break;
+            }
+            case ',':
+                // 对象中的逗号只能跟在键值对之后
+                if (super && super->type == RE_JSON_OBJECT) return RE_JSON_ERROR_INVALID;
+                if (super && super->type == RE_JSON_STRING) {
+                    if (super->size == 0) return RE_JSON_ERROR_INVALID;
+                    parser->super = super->parent;
+                }
+                break;
+            case ' ': case '\t': case '\r': case '\n':
+                break;
+            case '-': case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7':
+            case '8': case '9': case 't': case 'f': case 'n':
+                if (super && (super->type == RE_JSON_OBJECT || (super->type == RE_JSON_STRING && super->size > 0))) {
+                    return RE_JSON_ERROR_INVALID;
+                }
+                rc = parse_primitive(parser, js, len, tokens, max);
+                if (rc < 0) return rc;
+                if (super) super->size++;
+                break;
+            default:
+                return RE_JSON_ERROR_INVALID;
+        }
+    }
+
+    // 仍有未闭合的容器说明文本尚未结束
+    if (parser->next == 0) return RE_JSON_ERROR_PARTIAL;
+    for (int i = 0; i < parser->next; i++) {
+        if (tokens[i].start != -1 && tokens[i].end == -1) return RE_JSON_ERROR_PARTIAL;
+    }
+    return parser->next;
+}
+
+// === 取值 ===
+
+// 跳过一个值及其全部子 token，返回其后的下一个 token
+static int token_skip(const re_json_token_t* tokens, int count, int index) {
+    int next = index + 1;
+    while (next < count && tokens[next].start < tokens[index].end) next++;
+    return next;
+}
+
+int re_json_find(const char* js, const re_json_token_t* tokens, int count, int object, const char* key) {
+    if (!js || !tokens || !key || object < 0 || object >= count || tokens[object].type != RE_JSON_OBJECT) {
+        return -1;
+    }
+
+    size_t key_len = strlen(key);
+    int i = object + 1;
+    while (i + 1 < count && tokens[i].start < tokens[object].end) {
+        const re_json_token_t* k = &tokens[i];
+        if (k->parent == object && k->type == RE_JSON_STRING &&
+            (size_t)(k->end - k->start) == key_len && memcmp(js + k->start, key, key_len) == 0) {
+            return i + 1;
+        }
+        i = token_skip(tokens, count, i + 1);
+    }
+    return -1;
+}
+
+bool re_json_int(const char* js, const re_json_token_t* token, int64_t* out) {
+    if (!js || !token || !out || token->type != RE_JSON_PRIMITIVE) return false;
+
+    const char* p = js + token->start;
+    const char* end = js + token->end;
+    bool negative = p < end && *p == '-';
+    if (negative) p++;
+    if (p == end) return false;
+
+    uint64_t value = 0;
+    uint64_t limit = negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+    for (; p < end; p++) {
+        if (*p < '0' || *p > '9') return false;
+        uint64_t digit = (uint64_t)(*p - '0');
+        if (value > (limit - digit) / 10) return false;
+        value = value * 10 + digit;
+    }
+    *out = negative ? (int64_t)(0 - value) : (int64_t)value;
+    return true;
+}
+
+bool re_json_bool(const char* js, const re_json_token_t* token, bool* out) {
+    if (!js || !token || !out || token->type != RE_JSON_PRIMITIVE) return false;
+
+    size_t len = (size_t)(token->end - token->start);
+    if (len == 4 && memcmp(js + token->start, "true", 4) == 0) {
+        *out = true;
+        return true;
+    }
+    if (len == 5 && memcmp(js + token->start, "false", 5) == 0) {
+        *out = false;
+        return true;
+    }
+    return false;
+}
+
+static int hex4(const char* p) {
+    int value = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = p[i];
+        value <<= 4;
+        if (c >= '0' && c <= '9') value |= c - '0';
+        else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+        else return -1;
+    }
+    return value;
+}
+
+int re_json_string(const char* js, const re_json_token_t* token, char* out, size_t cap) {
+    if (!js || !token || !out || cap == 0 || token->type != RE_JSON_STRING) return -1;
+
+    const char* p = js + token->start;
+    const char* end = js + token->end;
+    size_t n = 0;
+
+    while (p < end) {
+        uint32_t cp;
+        if (*p != '\\') {
+            if (n + 1 >= cap) return -1;
+            out[n++] = *p++;
+            continue;
+        }
+        p++;
+        switch (*p++) {
+            case '"':  cp = '"';  break;
+            case '\\': cp = '\\'; break;
+            case '/':  cp = '/';  break;
+            case 'b':  cp = '\b'; break;
+            case 'f':  cp = '\f'; break;
+            case 'n':  cp = '\n'; break;
+            case 'r':  cp = '\r'; break;
+            case 't':  cp = '\t'; break;
+            case 'u': {
+                int hi = hex4(p);
+                if (hi < 0) return -1;
+                p += 4;
+                cp = (uint32_t)hi;
+                if (cp >= 0xD800 && cp <= 0xDBFF) {
+                    // 代理对合并为一个码点
+                    if (end - p < 6 || p[0] != '\\' || p[1] != 'u') return -1;
+                    int lo = hex4(p + 2);
+                    if (lo < 0xDC00 || lo > 0xDFFF) return -1;
+                    p += 6;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + ((uint32_t)lo - 0xDC00);
+                } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+                    return -1;
+                }
+                break;
+            }
+            default:
+                return -1;
+        }
+        // 输出为 C 字符串，不接受内嵌的 NUL
+        if (cp == 0) return -1;
+
+        char utf8[4];
+        size_t bytes;
+        if (cp < 0x80) {
+            utf8[0] = (char)cp;
+            bytes = 1;
+        } else if (cp < 0x800) {
+            utf8[0] = (char)(0xC0 | (cp >> 6));
+            utf8[1] = (char)(0x80 | (cp & 0x3F));
+            bytes = 2;
+        } else if (cp < 0x10000) {
+            utf8[0] = (char)(0xE0 | (cp >> 12));
+            utf8[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+            utf8[2] = (char)(0x80 | (cp & 0x3F));
+            bytes = 3;
+        } else {
+            utf8[0] = (char)(0xF0 | (cp >> 18));
+            utf8[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+            utf8[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+            utf8[3] = (char)(0x80 | (cp & 0x3F));
+            bytes = 4;
+        }
+        if (n + bytes >= cap) return -1;
+        memcpy(out + n, utf8, bytes);
+        n += bytes;
+    }
+    out[n] = '\0';
+    return (int)n;
+}
@@ -0,0 +1,103 @@
+#ifndef RE_JSON_H
+#define RE_JSON_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @file re_json.h
+ * @brief Allocation-free JSON tokenizer
+ *
+ * The tokenizer splits a JSON text into tokens stored in a caller-provided
+ * array; tokens reference the text by offset and nothing is copied or
+ * allocated. Parsing is resumable: when the text ends in the middle of a
+ * value RE_JSON_ERROR_PARTIAL is returned, and calling again with the
+ * same parser, token array and a longer text continues where it stopped,
+ * so a body can be parsed as it arrives.
+ *
+ * Tokens are stored in document order. An object token is followed by its
+ * keys and values; its `size` is the number of keys (arrays: elements).
+ */
+
+#define RE_JSON_ERROR_NOMEM     -1    // Token array too small
+#define RE_JSON_ERROR_INVALID   -2    // Malformed JSON
+#define RE_JSON_ERROR_PARTIAL   -3    // Text ends before the document does
+
+typedef enum {
+    RE_JSON_UNDEFINED = 0,
+    RE_JSON_OBJECT,
+    RE_JSON_ARRAY,
+    RE_JSON_STRING,                   // start/end exclude the quotes
+    RE_JSON_PRIMITIVE                 // Number, true, false or null
+} re_json_type_t;
+
+typedef struct {
+    re_json_type_t type;
+    int32_t start;                    // Offset of the first byte
+    int32_t end;                      // Offset past the last byte (-1 while open)
+    int32_t size;                     // Number of keys or elements
+    int32_t parent;                   // Enclosing token (-1 at top level)
+} re_json_token_t;
+
+typedef struct {
+    uint32_t pos;                     // Next byte to read
+    int32_t next;                     // Next free token
+    int32_t super;                    // Innermost open object, array or key
+} re_json_parser_t;
+
+/**
+ * @brief Reset a parser before the first call to re_json_parse()
+ */
+void re_json_init(re_json_parser_t* parser);
+
+/**
+ * @brief Tokenize (or continue tokenizing) a JSON text
+ *
+ * @param parser Parser state
+ * @param js Text, at least as long as on the previous call
+ * @param len Length of the text
+ * @param tokens Token array
+ * @param max Capacity of the token array
+ * @return Number of tokens on success, RE_JSON_ERROR_* otherwise
+ */
+int re_json_parse(re_json_parser_t* parser, const char* js, size_t len,
+                  re_json_token_t* tokens, int max);
+
+/**
+ * @brief Find the value of a key in an object
+ *
+ * @param js Parsed text
+ * @param tokens Tokens returned by re_json_parse()
+ * @param count Number of tokens
+ * @param object Index of an object token
+ * @param key Key to look up
+ * @return Index of the value token, -1 if absent
+ */
+int re_json_find(const char* js, const re_json_token_t* tokens, int count, int object, const char* key);
+
+/**
+ * @brief Read an integer primitive
+ *
+ * @return true if the token is an integer that fits int64_t
+ */
+bool re_json_int(const char* js, const re_json_token_t* token, int64_t* out);
+
+/**
+ * @brief Read a true/false primitive
+ */
+bool re_json_bool(const char* js, const re_json_token_t* token, bool* out);
+
+/**
+ * @brief Copy a string token with escapes decoded
+ *
+ * \uXXXX escapes are written as UTF-8 (surrogate pairs are combined).
+ *
+ * @param out Receives the NUL-terminated string
+ * @param cap Capacity of out
+ * @return Length of the decoded string, -1 if it is not a string, has a
+ *         bad escape or does not fit
+ */
+int re_json_string(const char* js, const re_json_token_t* token, char* out, size_t cap);
+
+#endif // RE_JSON_H
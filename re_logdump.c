@@ -0,0 +1,228 @@
+/**
+ * @file re_logdump.c
+ * @brief Offline decoder for the binary event log
+ *
+ * Usage: re_logdump [-f text|json] [-r response_id] [-z zone] [-s subsystem] <log>
+ *
+ * Build: cc -O2 -o re_logdump re_logdump.c
+ */
+
+#include "re_evlog.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <getopt.h>
+#include <time.h>
+
+typedef struct {
+    bool json;
+    bool has_response;
+    uint64_t response_id;
+    int zone;                         // -1 = 不过滤
+    int subsystem;                    // -1 = 不过滤
+} dump_filter_t;
+
+typedef struct {
+    uint8_t event;
+    uint8_t subsystem;
+    uint8_t flags;
+    uint64_t ts_ns;
+    uint64_t response_id;
+    uint64_t zones;
+    int64_t value;
+    char text[RE_EVLOG_MAX_TEXT * 2 + 1];
+} dump_record_t;
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "用法: %s [-f text|json] [-r response_id] [-z zone] [-s subsystem] <log>\n"
+            "  -f  输出格式 (默认 text)\n"
+            "  -r  仅输出指定 response_id 的事件\n"
+            "  -z  仅输出涉及指定区域 (0-31) 的事件\n"
+            "  -s  仅输出指定子系统 (如 NETWORK) 的事件\n", prog);
+}
+
+static int parse_subsystem(const char* name) {
+    for (int i = 0; i < RE_SUB_COUNT; i++) {
+        if (strcasecmp(name, re_evlog_subsystem_name((uint8_t)i)) == 0) return i;
+    }
+    return -1;
+}
+
+// 解码单条记录，返回记录长度，0 表示数据损坏
+static size_t decode_record(const uint8_t* p, size_t avail, uint64_t base_ns, dump_record_t* rec) {
+    if (avail < 4 || p[0] < 4 || p[0] > avail) return 0;
+    size_t size = p[0];
+    size_t off = 4;
+    uint64_t fields[4];
+
+    rec->event = p[1];
+    rec->subsystem = p[2];
+    rec->flags = p[3];
+    for (int i = 0; i < 4; i++) {
+        size_t n = re_varint_get(p + off, size - off, &fields[i]);
+        if (n == 0) return 0;
+        off += n;
+    }
+    rec->ts_ns = base_ns + fields[0];
+    rec->response_id = fields[1];
+    rec->zones = fields[2];
+    rec->value = re_zigzag_decode(fields[3]);
+    rec->text[0] = '\0';
+
+    if (rec->flags & RE_EVLOG_FLAG_TEXT) {
+        if (off >= size || p[off] > size - off - 1) return 0;
+        size_t len = p[off++];
+        memcpy(rec->text, p + off, len);
+        rec->text[len] = '\0';
+    }
+    return size;
+}
+
+static void print_json_string(const char* s) {
+    putchar('"');
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            printf("\\%c", c);
+        } else if (c < 0x20) {
+            printf("\\u%04x", c);
+        } else {
+            putchar(c);
+        }
+    }
+    putchar('"');
+}
+
+static void print_record(const dump_record_t* rec, bool json) {
+    if (json) {
+        printf("{\"ts_ns\":%llu,\"event\":\"%s\",\"subsystem\":\"%s\","
+               "\"response_id\":%llu,\"zones\":%llu,\"value\":%lld",
+               (unsigned long long)rec->ts_ns, re_evlog_event_name(rec->event),
+               re_evlog_subsystem_name(rec->subsystem),
+               (unsigned long long)rec->response_id, (unsigned long long)rec->zones,
+               (long long)rec->value);
+        if (rec->flags & RE_EVLOG_FLAG_TEXT) {
+            printf(",\"text\":");
+            print_json_string(rec->text);
+        }
+        printf("}\n");
+        return;
+    }
+
+    time_t secs = (time_t)(rec->ts_ns / 1000000000ull);
+    struct tm tm;
+    char stamp[32];
+    gmtime_r(&secs, &tm);
+    strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%S", &tm);
+    printf("%s.%09lluZ [%s] %-14s id=%llu zones=0x%08llX value=%lld%s%s\n",
+           stamp, (unsigned long long)(rec->ts_ns % 1000000000ull),
+           re_evlog_subsystem_name(rec->subsystem), re_evlog_event_name(rec->event),
+           (unsigned long long)rec->response_id, (unsigned long long)rec->zones,
+           (long long)rec->value, rec->text[0] ? " " : "", rec->text);
+}
+
+static bool record_matches(const dump_record_t* rec, const dump_filter_t* filter) {
+    if (filter->has_response && rec->response_id != filter->response_id) return false;
+    if (filter->zone >= 0 && !(rec->zones & (1ull << filter->zone))) return false;
+    if (filter->subsystem >= 0 && rec->subsystem != filter->subsystem) return false;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    dump_filter_t filter = { .zone = -1, .subsystem = -1 };
+    int opt;
+
+    while ((opt = getopt(argc, argv, "f:r:z:s:h")) != -1) {
+        switch (opt) {
+            case 'f':
+                if (strcmp(optarg, "json") == 0) {
+                    filter.json = true;
+                } else if (strcmp(optarg, "text") != 0) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'r':
+                filter.has_response = true;
+                filter.response_id = strtoull(optarg, NULL, 0);
+                break;
+            case 'z':
+                filter.zone = atoi(optarg);
+                if (filter.zone < 0 || filter.zone > 31) {
+                    fprintf(stderr, "区域编号必须在 0-31 之间\n");
+                    return 2;
+                }
+                break;
+            case 's':
+                filter.subsystem = parse_subsystem(optarg);
+                if (filter.subsystem < 0) {
+                    fprintf(stderr, "未知子系统: %s\n", optarg);
+                    return 2;
+                }
+                break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (optind >= argc) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    FILE* fp = fopen(argv[optind], "rb");
+    if (!fp) {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    re_evlog_file_header_t header;
+    if (fread(&header, sizeof(header), 1, fp) != 1 || header.magic != RE_EVLOG_MAGIC) {
+        fprintf(stderr, "%s: 不是有效的事件日志\n", argv[optind]);
+        fclose(fp);
+        return 1;
+    }
+    if (header.version != RE_EVLOG_VERSION) {
+        fprintf(stderr, "%s: 不支持的日志版本 %u\n", argv[optind], header.version);
+        fclose(fp);
+        return 1;
+    }
+
+    // 按块读取，块尾不完整的记录移到下一块开头
+    uint8_t buf[64 * 1024];
+    size_t have = 0;
+    uint64_t offset = sizeof(header);
+    int status = 0;
+
+    for (;;) {
+        size_t n = fread(buf + have, 1, sizeof(buf) - have, fp);
+        have += n;
+        if (have == 0) break;
+
+        size_t pos = 0;
+        while (pos < have) {
+            dump_record_t rec;
+            if (buf[pos] > have - pos && n > 0) break;
+            size_t len = decode_record(buf + pos, have - pos, header.base_time_ns, &rec);
+            if (len == 0) {
+                fprintf(stderr, "偏移 %llu 处记录损坏，停止解码\n",
+                        (unsigned long long)(offset + pos));
+                status = 1;
+                goto done;
+            }
+            if (record_matches(&rec, &filter)) print_record(&rec, filter.json);
+            pos += len;
+        }
+
+        memmove(buf, buf + pos, have - pos);
+        offset += pos;
+        have -= pos;
+        if (n == 0) break;
+    }
+
+done:
+    fclose(fp);
+    return status;
+}
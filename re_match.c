@@ -0,0 +1,320 @@
+#include "re_match.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <tmmintrin.h>
+#define MATCH_HAVE_SSSE3 1
+#endif
+
+#define MATCH_ROOT         0
+#define MATCH_NONE         UINT32_MAX        // 构建期间表示尚无转移
+#define MATCH_OUTPUT       0x80000000u       // 转移目标状态有匹配输出
+
+typedef struct {
+    uint32_t offset;                  // 在 text 中的起点
+    uint32_t len;
+    uint32_t id;
+} match_pattern_t;
+
+struct re_matcher {
+    uint32_t flags;
+    bool compiled;
+    // 编译前收集的模式
+    match_pattern_t* patterns;
+    uint32_t pattern_count;
+    uint32_t pattern_cap;
+    char* text;
+    size_t text_len;
+    size_t text_cap;
+    // 自动机
+    uint8_t classes[256];             // 字节 -> 字节类
+    uint32_t class_count;
+    uint32_t state_count;
+    uint32_t* delta;                  // 行起点 + class -> 目标行起点（state * class_count）| MATCH_OUTPUT
+    uint32_t* out_start;              // 每个状态的匹配列表
+    uint32_t* out_count;
+    uint32_t* outputs;
+    // 起始状态预过滤
+    bool prefilter;
+    bool first[256];                  // 可作为模式首字节
+    uint8_t nibble_lo[16];
+    uint8_t nibble_hi[16];
+    bool use_ssse3;
+};
+
+static inline uint8_t fold(uint8_t c, uint32_t flags) {
+    return ((flags & RE_MATCH_CASELESS) && c >= 'A' && c <= 'Z') ? (uint8_t)(c + 32) : c;
+}
+
+// === 起始状态跳过 ===
+
+static size_t skip_scalar(const re_matcher_t* m, const uint8_t* text, size_t i, size_t len) {
+    while (i < len && !m->first[text[i]]) i++;
+    return i;
+}
+
+#ifdef MATCH_HAVE_SSSE3
+// 以高低半字节两次 pshufb 判断 16 字节是否可能为首字节：
+// 高半字节选出 8 个桶之一，低半字节表记录每个桶内出现的组合，误报再由 first[] 精确排除
+__attribute__((target("ssse3")))
+static size_t skip_ssse3(const re_matcher_t* m, const uint8_t* text, size_t i, size_t len) {
+    const __m128i lo_table = _mm_loadu_si128((const __m128i*)m->nibble_lo);
+    const __m128i hi_table = _mm_loadu_si128((const __m128i*)m->nibble_hi);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i zero = _mm_setzero_si128();
+
+    while (i + 16 <= len) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(text + i));
+        __m128i lo = _mm_shuffle_epi8(lo_table, _mm_and_si128(v, nibble));
+        __m128i hi = _mm_shuffle_epi8(hi_table, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+        unsigned bits = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), zero)) ^ 0xFFFFu;
+        while (bits) {
+            size_t j = i + (size_t)__builtin_ctz(bits);
+            if (m->first[text[j]]) return j;
+            bits &= bits - 1;
+        }
+        i += 16;
+    }
+    return skip_scalar(m, text, i, len);
+}
+#endif
+
+// === 构建 ===
+
+int32_t re_matcher_add(re_matcher_t* m, const char* pattern, size_t len, uint32_t id) {
+    if (!m || !pattern || len == 0 || len > UINT32_MAX || m->compiled) return RESPONSE_ERROR_INVALID_PARAM;
+
+    if (m->pattern_count == m->pattern_cap) {
+        uint32_t cap = m->pattern_cap ? m->pattern_cap * 2 : 16;
+        match_pattern_t* grown = realloc(m->patterns, cap * sizeof(match_pattern_t));
+        if (!grown) return RESPONSE_ERROR_INIT_FAILED;
+        m->patterns = grown;
+        m->pattern_cap = cap;
+    }
+    if (m->text_len + len > m->text_cap) {
+        size_t cap = m->text_cap ? m->text_cap : 256;
+        while (cap < m->text_len + len) cap *= 2;
+        char* grown = realloc(m->text, cap);
+        if (!grown) return RESPONSE_ERROR_INIT_FAILED;
+        m->text = grown;
+        m->text_cap = cap;
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        m->text[m->text_len + i] = (char)fold((uint8_t)pattern[i], m->flags);
+    }
+    m->patterns[m->pattern_count++] = (match_pattern_t){ (uint32_t)m->text_len, (uint32_t)len, id };
+    m->text_len += len;
+    return RESPONSE_SUCCESS;
+}
+
+// 出现在模式中的每个字节各占一类，其余字节共用第 0 类
+static void build_classes(re_matcher_t* m) {
+    bool used[256] = { false };
+    uint32_t used_count = 0;
+    for (size_t i = 0; i < m->text_len; i++) {
+        if (!used[(uint8_t)m->text[i]]) used_count++;
+        used[(uint8_t)m->text[i]] = true;
+    }
+
+    memset(m->classes, 0, sizeof(m->classes));
+    m->class_count = used_count == 256 ? 0 : 1;       // 256 个字节都出现时没有公共类
+    for (int c = 0; c < 256; c++) {
+        if (used[c]) m->classes[c] = (uint8_t)m->class_count++;
+    }
+    if (m->flags & RE_MATCH_CASELESS) {
+        for (int c = 'A'; c <= 'Z'; c++) m->classes[c] = m->classes[c + 32];
+    }
+}
+
+static void build_prefilter(re_matcher_t* m) {
+    uint32_t count = 0;
+    memset(m->nibble_lo, 0, sizeof(m->nibble_lo));
+    for (int c = 0; c < 256; c++) {
+        m->first[c] = m->delta[m->classes[c]] != MATCH_ROOT;
+        if (!m->first[c]) continue;
+        m->nibble_lo[c & 0x0F] |= (uint8_t)(1u << ((c >> 4) & 7));
+        count++;
+    }
+    for (int h = 0; h < 16; h++) m->nibble_hi[h] = (uint8_t)(1u << (h & 7));
+
+    // 首字节覆盖大部分字节值时逐字节走自动机更快
+    m->prefilter = count > 0 && count <= 128;
+#ifdef MATCH_HAVE_SSSE3
+    m->use_ssse3 = __builtin_cpu_supports("ssse3");
+#else
+    m->use_ssse3 = false;
+#endif
+}
+
+int32_t re_matcher_compile(re_matcher_t* m) {
+    if (!m || m->compiled) return RESPONSE_ERROR_INVALID_PARAM;
+    build_classes(m);
+
+    // 状态数上限为模式总长度加根；转移中保存行起点，须留出 MATCH_OUTPUT 位
+    size_t max_states = m->text_len + 1;
+    uint32_t cls = m->class_count;
+    if (max_states * cls >= MATCH_OUTPUT) return RESPONSE_ERROR_INVALID_PARAM;
+    uint32_t* delta = malloc(max_states * cls * sizeof(uint32_t));
+    uint32_t* fail = malloc(max_states * sizeof(uint32_t));
+    uint32_t* queue = malloc(max_states * sizeof(uint32_t));
+    uint32_t* term_head = malloc(max_states * sizeof(uint32_t));
+    uint32_t* term_next = malloc((m->pattern_count + 1) * sizeof(uint32_t));
+    uint32_t* out_start = malloc(max_states * sizeof(uint32_t));
+    uint32_t* out_count = calloc(max_states, sizeof(uint32_t));
+    if (!delta || !fail || !queue || !term_head || !term_next || !out_start || !out_count) {
+        free(delta); free(fail); free(queue); free(term_head); free(term_next); free(out_start); free(out_count);
+        return RESPONSE_ERROR_INIT_FAILED;
+    }
+
+    // 字典树
+    for (size_t i = 0; i < max_states * cls; i++) delta[i] = MATCH_NONE;
+    for (size_t i = 0; i < max_states; i++) term_head[i] = MATCH_NONE;
+    uint32_t states = 1;
+    for (uint32_t p = 0; p < m->pattern_count; p++) {
+        const uint8_t* s = (const uint8_t*)m->text + m->patterns[p].offset;
+        uint32_t state = MATCH_ROOT;
+        for (uint32_t k = 0; k < m->patterns[p].len; k++) {
+            uint32_t* next = &delta[(size_t)state * cls + m->classes[s[k]]];
+            if (*next == MATCH_NONE) *next = states++;
+            state = *next;
+        }
+        term_next[p] = term_head[state];
+        term_head[state] = p;
+    }
+
+    // 按广度优先计算失败链接并补全转移，同时累计匹配列表长度
+    size_t total_outputs = 0;
+    uint32_t q_head = 0, q_tail = 0;
+    fail[MATCH_ROOT] = MATCH_ROOT;
+    for (uint32_t c = 0; c < cls; c++) {
+        uint32_t* next = &delta[MATCH_ROOT * cls + c];
+        if (*next == MATCH_NONE) {
+            *next = MATCH_ROOT;
+        } else {
+            fail[*next] = MATCH_ROOT;
+            queue[q_tail++] = *next;
+        }
+    }
+    while (q_head < q_tail) {
+        uint32_t state = queue[q_head++];
+        for (uint32_t p = term_head[state]; p != MATCH_NONE; p = term_next[p]) out_count[state]++;
+        out_count[state] += out_count[fail[state]];
+        total_outputs += out_count[state];
+        for (uint32_t c = 0; c < cls; c++) {
+            uint32_t* next = &delta[(size_t)state * cls + c];
+            uint32_t fallback = delta[(size_t)fail[state] * cls + c];
+            if (*next == MATCH_NONE) {
+                *next = fallback;
+            } else {
+                fail[*next] = fallback;
+                queue[q_tail++] = *next;
+            }
+        }
+    }
+
+    // 匹配列表：本状态结束的模式在前，随后接失败状态的列表（已按 BFS 顺序建好）
+    uint32_t* outputs = malloc((total_outputs ? total_outputs : 1) * sizeof(uint32_t));
+    if (!outputs) {
+        free(delta); free(fail); free(queue); free(term_head); free(term_next); free(out_start); free(out_count);
+        return RESPONSE_ERROR_INIT_FAILED;
+    }
+    out_start[MATCH_ROOT] = 0;
+    size_t pos = 0;
+    for (uint32_t q = 0; q < q_tail; q++) {
+        uint32_t state = queue[q];
+        out_start[state] = (uint32_t)pos;
+        for (uint32_t p = term_head[state]; p != MATCH_NONE; p = term_next[p]) {
+            outputs[pos++] = m->patterns[p].id;
+        }
+        uint32_t f = fail[state];
+        memcpy(&outputs[pos], &outputs[out_start[f]], out_count[f] * sizeof(uint32_t));
+        pos += out_count[f];
+    }
+
+    // 转移改存目标行起点并标记有输出的目标，扫描时省去乘法和一次查表
+    for (size_t i = 0; i < (size_t)states * cls; i++) {
+        uint32_t target = delta[i];
+        delta[i] = target * cls | (out_count[target] ? MATCH_OUTPUT : 0);
+    }
+
+    free(fail);
+    free(queue);
+    free(term_head);
+    free(term_next);
+    // 收缩到实际状态数
+    uint32_t* shrunk = realloc(delta, (size_t)states * cls * sizeof(uint32_t));
+    m->delta = shrunk ? shrunk : delta;
+    m->out_start = out_start;
+    m->out_count = out_count;
+    m->outputs = outputs;
+    m->state_count = states;
+
+    build_prefilter(m);
+    free(m->patterns);
+    free(m->text);
+    m->patterns = NULL;
+    m->text = NULL;
+    m->compiled = true;
+    return RESPONSE_SUCCESS;
+}
+
+// === 公共接口 ===
+
+re_matcher_t* re_matcher_create(uint32_t flags) {
+    re_matcher_t* m = calloc(1, sizeof(re_matcher_t));
+    if (m) m->flags = flags;
+    return m;
+}
+
+size_t re_matcher_scan(const re_matcher_t* m, const char* text, size_t len,
+                       re_match_cb_t cb, void* arg) {
+    if (!m || !m->compiled || !text || m->state_count <= 1) return 0;
+
+    const uint8_t* s = (const uint8_t*)text;
+    const uint32_t* delta = m->delta;
+    const uint8_t* classes = m->classes;
+    const bool prefilter = m->prefilter;
+    uint32_t row = MATCH_ROOT;
+    size_t matches = 0;
+
+    for (size_t i = 0; i < len; ) {
+        if (row == MATCH_ROOT && prefilter) {
+#ifdef MATCH_HAVE_SSSE3
+            i = m->use_ssse3 ? skip_ssse3(m, s, i, len) : skip_scalar(m, s, i, len);
+#else
+            i = skip_scalar(m, s, i, len);
+#endif
+            if (i >= len) break;
+        }
+        uint32_t next = delta[row + classes[s[i]]];
+        row = next & ~MATCH_OUTPUT;
+        i++;
+        if (!(next & MATCH_OUTPUT)) continue;
+
+        uint32_t state = row / m->class_count;
+        uint32_t count = m->out_count[state];
+        const uint32_t* ids = &m->outputs[m->out_start[state]];
+        for (uint32_t k = 0; k < count; k++) {
+            matches++;
+            if (cb && !cb(ids[k], i, arg)) return matches;
+        }
+    }
+    return matches;
+}
+
+uint32_t re_matcher_states(const re_matcher_t* m) {
+    return (m && m->compiled) ? m->state_count : 0;
+}
+
+void re_matcher_destroy(re_matcher_t* m) {
+    if (!m) return;
+    free(m->patterns);
+    free(m->text);
+    free(m->delta);
+    free(m->out_start);
+    free(m->out_count);
+    free(m->outputs);
+    free(m);
+}
@@ -0,0 +1,91 @@
+#ifndef RE_MATCH_H
+#define RE_MATCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "response_executor.h"
+
+/**
+ * @file re_match.h
+ * @brief Multi-pattern trigger matching
+ *
+ * Compiles a set of literal trigger patterns into one Aho-Corasick
+ * automaton and finds every occurrence of every pattern in an event text
+ * in a single pass. The automaton is a complete DFA over byte classes
+ * (bytes that appear in no pattern share one class), so scanning costs
+ * one table lookup per byte whatever the number of patterns, plus the
+ * matches reported.
+ *
+ * While the automaton is in its start state, bytes that cannot begin any
+ * pattern are skipped 16 at a time with an SSSE3 nibble-table filter when
+ * the CPU supports it (scalar otherwise).
+ *
+ * Patterns are added, then the matcher is compiled once; a compiled
+ * matcher is read-only and may be scanned from any number of threads.
+ */
+
+#define RE_MATCH_CASELESS         0x1      // ASCII letters match regardless of case
+
+typedef struct re_matcher re_matcher_t;
+
+/**
+ * @brief Called for each match
+ *
+ * @param id Identifier the pattern was added with
+ * @param end Offset just past the last byte of the match
+ * @param arg Caller argument
+ * @return true to continue scanning, false to stop
+ */
+typedef bool (*re_match_cb_t)(uint32_t id, size_t end, void* arg);
+
+/**
+ * @brief Create an empty matcher
+ *
+ * @param flags RE_MATCH_* flags
+ * @return New matcher, NULL on allocation failure
+ */
+re_matcher_t* re_matcher_create(uint32_t flags);
+
+/**
+ * @brief Add a pattern
+ *
+ * Several patterns may share an identifier, and the same text may be
+ * added under several identifiers.
+ *
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_INVALID_PARAM if the
+ *         pattern is empty or the matcher is already compiled,
+ *         RESPONSE_ERROR_INIT_FAILED on allocation failure
+ */
+int32_t re_matcher_add(re_matcher_t* matcher, const char* pattern, size_t len, uint32_t id);
+
+/**
+ * @brief Build the automaton
+ *
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_INIT_FAILED on
+ *         allocation failure
+ */
+int32_t re_matcher_compile(re_matcher_t* matcher);
+
+/**
+ * @brief Scan a text
+ *
+ * Matches are reported in order of their end offset; patterns ending at
+ * the same offset are reported longest first.
+ *
+ * @return Number of matches reported
+ */
+size_t re_matcher_scan(const re_matcher_t* matcher, const char* text, size_t len,
+                       re_match_cb_t cb, void* arg);
+
+/**
+ * @brief Number of automaton states (0 before compilation)
+ */
+uint32_t re_matcher_states(const re_matcher_t* matcher);
+
+/**
+ * @brief Free a matcher
+ */
+void re_matcher_destroy(re_matcher_t* matcher);
+
+#endif // RE_MATCH_H
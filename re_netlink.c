@@ -0,0 +1,203 @@
+#include "re_netlink.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/socket.h>
+
+#define NL_SEND_CHUNK   (64 * 1024)   // 单次 sendmsg 的上限，按完整消息切分
+#define NL_RECV_BUFFER  (32 * 1024)
+
+int re_nl_open(int protocol) {
+    int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, protocol);
+    if (fd < 0) return -errno;
+
+    struct sockaddr_nl addr = { .nl_family = AF_NETLINK };
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+        int err = -errno;
+        close(fd);
+        return err;
+    }
+
+    // 批量请求的 ACK 较多，扩大接收缓冲避免溢出
+    int rcvbuf = 1024 * 1024;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    // 错误 ACK 不回带原始请求，否则大批量消息的 ACK 会超出接收缓冲
+    int cap_ack = 1;
+    setsockopt(fd, SOL_NETLINK, NETLINK_CAP_ACK, &cap_ack, sizeof(cap_ack));
+    return fd;
+}
+
+void re_nl_batch_init(re_nl_batch_t* batch) {
+    memset(batch, 0, sizeof(*batch));
+    batch->seq = (uint32_t)time(NULL);
+}
+
+void re_nl_batch_free(re_nl_batch_t* batch) {
+    free(batch->buf);
+    memset(batch, 0, sizeof(*batch));
+}
+
+// 预留 len 字节（按 NLA 对齐），返回写入位置
+static void* nl_reserve(re_nl_batch_t* batch, size_t len) {
+    size_t aligned = NLMSG_ALIGN(len);
+    if (batch->error) return NULL;
+    if (batch->len + aligned > batch->cap) {
+        size_t cap = batch->cap ? batch->cap * 2 : 4096;
+        while (cap < batch->len + aligned) cap *= 2;
+        uint8_t* buf = realloc(batch->buf, cap);
+        if (!buf) {
+            batch->error = -ENOMEM;
+            return NULL;
+        }
+        batch->buf = buf;
+        batch->cap = cap;
+    }
+    void* p = batch->buf + batch->len;
+    memset(p, 0, aligned);
+    batch->len += aligned;
+    return p;
+}
+
+void* re_nl_msg_begin(re_nl_batch_t* batch, uint16_t type, uint16_t flags,
+                      const void* family_hdr, size_t hdr_len) {
+    size_t off = batch->len;
+    struct nlmsghdr* nlh = nl_reserve(batch, NLMSG_HDRLEN);
+    if (!nlh) return NULL;
+    nlh->nlmsg_type = type;
+    nlh->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK | flags;
+    nlh->nlmsg_seq = batch->seq++;
+    batch->msg_off = off;
+
+    void* hdr = nl_reserve(batch, hdr_len);
+    if (hdr && family_hdr) memcpy(hdr, family_hdr, hdr_len);
+    return hdr;
+}
+
+void re_nl_msg_end(re_nl_batch_t* batch) {
+    if (batch->error) return;
+    struct nlmsghdr* nlh = (struct nlmsghdr*)(batch->buf + batch->msg_off);
+    nlh->nlmsg_len = (uint32_t)(batch->len - batch->msg_off);
+    batch->count++;
+}
+
+void re_nl_attr_put(re_nl_batch_t* batch, uint16_t type, const void* data, size_t len) {
+    struct nlattr* nla = nl_reserve(batch, NLA_HDRLEN + len);
+    if (!nla) return;
+    nla->nla_type = type;
+    nla->nla_len = (uint16_t)(NLA_HDRLEN + len);
+    if (len) memcpy((uint8_t*)nla + NLA_HDRLEN, data, len);
+}
+
+void re_nl_attr_put_u8(re_nl_batch_t* batch, uint16_t type, uint8_t value) {
+    re_nl_attr_put(batch, type, &value, sizeof(value));
+}
+
+void re_nl_attr_put_u32(re_nl_batch_t* batch, uint16_t type, uint32_t value) {
+    re_nl_attr_put(batch, type, &value, sizeof(value));
+}
+
+void re_nl_attr_put_str(re_nl_batch_t* batch, uint16_t type, const char* value) {
+    re_nl_attr_put(batch, type, value, strlen(value) + 1);
+}
+
+size_t re_nl_nest_begin(re_nl_batch_t* batch, uint16_t type) {
+    size_t off = batch->len;
+    struct nlattr* nla = nl_reserve(batch, NLA_HDRLEN);
+    if (nla) nla->nla_type = type | NLA_F_NESTED;
+    return off;
+}
+
+void re_nl_nest_end(re_nl_batch_t* batch, size_t nest_off) {
+    if (batch->error) return;
+    struct nlattr* nla = (struct nlattr*)(batch->buf + nest_off);
+    nla->nla_len = (uint16_t)(batch->len - nest_off);
+}
+
+// 接收 ACK，直到 pending 条消息全部得到确认
+static int nl_collect_acks(int fd, uint32_t pending, int* first_error) {
+    uint8_t buf[NL_RECV_BUFFER];
+
+    while (pending > 0) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -errno;
+        }
+
+        for (struct nlmsghdr* nlh = (struct nlmsghdr*)buf; NLMSG_OK(nlh, (size_t)n);
+             nlh = NLMSG_NEXT(nlh, n)) {
+            if (nlh->nlmsg_type != NLMSG_ERROR) continue;
+            struct nlmsgerr* err = NLMSG_DATA(nlh);
+            if (err->error != 0 && *first_error == 0) *first_error = err->error;
+            pending--;
+        }
+    }
+    return 0;
+}
+
+int re_nl_batch_send(int fd, re_nl_batch_t* batch) {
+    if (batch->error) return batch->error;
+
+    int first_error = 0;
+    size_t off = 0;
+
+    while (off < batch->len) {
+        // 按完整消息切分发送块
+        size_t end = off;
+        uint32_t msgs = 0;
+        while (end < batch->len) {
+            struct nlmsghdr* nlh = (struct nlmsghdr*)(batch->buf + end);
+            size_t msg_len = NLMSG_ALIGN(nlh->nlmsg_len);
+            if (msgs > 0 && end + msg_len - off > NL_SEND_CHUNK) break;
+            end += msg_len;
+            msgs++;
+        }
+
+        struct sockaddr_nl kernel = { .nl_family = AF_NETLINK };
+        struct iovec iov = { .iov_base = batch->buf + off, .iov_len = end - off };
+        struct msghdr msg = { .msg_name = &kernel, .msg_namelen = sizeof(kernel),
+                              .msg_iov = &iov, .msg_iovlen = 1 };
+        if (sendmsg(fd, &msg, 0) < 0) return -errno;
+
+        int rc = nl_collect_acks(fd, msgs, &first_error);
+        if (rc != 0) return rc;
+        off = end;
+    }
+
+    return first_error;
+}
+
+int re_nl_dump(int fd, re_nl_batch_t* batch, re_nl_dump_fn cb, void* arg) {
+    if (batch->error) return batch->error;
+    if (batch->count != 1) return -EINVAL;
+
+    // 转储以 NLMSG_DONE 结束，不另行请求 ACK
+    struct nlmsghdr* req = (struct nlmsghdr*)batch->buf;
+    req->nlmsg_flags &= ~NLM_F_ACK;
+    if (send(fd, batch->buf, batch->len, 0) < 0) return -errno;
+
+    uint8_t buf[NL_RECV_BUFFER];
+    int rc = 0;
+    for (;;) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -errno;
+        }
+
+        for (struct nlmsghdr* nlh = (struct nlmsghdr*)buf; NLMSG_OK(nlh, (size_t)n);
+             nlh = NLMSG_NEXT(nlh, n)) {
+            if (nlh->nlmsg_type == NLMSG_DONE) return rc;
+            if (nlh->nlmsg_type == NLMSG_ERROR) {
+                struct nlmsgerr* err = NLMSG_DATA(nlh);
+                if (err->error != 0) return err->error;
+                continue;
+            }
+            // 回调要求停止后继续读完剩余回复，保持套接字可复用
+            if (rc == 0) rc = cb(nlh, arg);
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef RE_NETLINK_H
+#define RE_NETLINK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <linux/netlink.h>
+
+/**
+ * @file re_netlink.h
+ * @brief Internal netlink message batching helpers
+ *
+ * Builds several netlink requests into one buffer so that a whole
+ * configuration change is handed to the kernel in as few sendmsg() calls
+ * as possible, then collects one ACK per request. Not part of the public
+ * API.
+ */
+
+// Growable netlink request buffer; nests are tracked by offset
+typedef struct {
+    uint8_t* buf;
+    size_t len;
+    size_t cap;
+    uint32_t seq;                     // Sequence number of the next message
+    uint32_t count;                   // Messages in the buffer
+    size_t msg_off;                   // Offset of the open message
+    int error;                        // Sticky allocation error
+} re_nl_batch_t;
+
+int re_nl_open(int protocol);
+void re_nl_batch_init(re_nl_batch_t* batch);
+void re_nl_batch_free(re_nl_batch_t* batch);
+
+// Start a message with the given family header; NLM_F_REQUEST|NLM_F_ACK are added
+void* re_nl_msg_begin(re_nl_batch_t* batch, uint16_t type, uint16_t flags,
+                      const void* family_hdr, size_t hdr_len);
+void re_nl_msg_end(re_nl_batch_t* batch);
+
+void re_nl_attr_put(re_nl_batch_t* batch, uint16_t type, const void* data, size_t len);
+void re_nl_attr_put_u8(re_nl_batch_t* batch, uint16_t type, uint8_t value);
+void re_nl_attr_put_u32(re_nl_batch_t* batch, uint16_t type, uint32_t value);
+void re_nl_attr_put_str(re_nl_batch_t* batch, uint16_t type, const char* value);
+size_t re_nl_nest_begin(re_nl_batch_t* batch, uint16_t type);
+void re_nl_nest_end(re_nl_batch_t* batch, size_t nest_off);
+
+/**
+ * Send every message in the batch and wait for all ACKs.
+ * Returns 0 when the kernel accepted every message, otherwise the first
+ * negative errno reported.
+ */
+int re_nl_batch_send(int fd, re_nl_batch_t* batch);
+
+// Called for every reply of a dump; a non-zero return stops the dump
+typedef int (*re_nl_dump_fn)(const struct nlmsghdr* nlh, void* arg);
+
+/**
+ * Send the single dump request in the batch (begun with NLM_F_DUMP) and
+ * pass every reply to cb until the kernel signals the end of the dump.
+ * Returns 0 on success, the negative errno reported by the kernel, or the
+ * first non-zero value returned by cb.
+ */
+int re_nl_dump(int fd, re_nl_batch_t* batch, re_nl_dump_fn cb, void* arg);
+
+#endif // RE_NETLINK_H
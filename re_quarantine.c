@@ -0,0 +1,397 @@
+#include "re_quarantine.h"
+#include "re_netlink.h"
+#include "response_executor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <errno.h>
+#include <arpa/inet.h>
+#include <linux/netfilter.h>
+#include <linux/netfilter/nfnetlink.h>
+#include <linux/netfilter/ipset/ip_set.h>
+
+#define QUARANTINE_HASHSIZE      1024
+#define QUARANTINE_PER_MESSAGE   2048  // 嵌套属性长度为 16 位，单条消息需限制元素数
+
+// === 隔离集合状态 ===
+// 本地镜像集合用于去重与计数，开放寻址，0 表示空槽
+static struct {
+    uint32_t* slots;
+    size_t capacity;
+    size_t count;
+    bool set_ready;
+    bool loaded;                      // 镜像已与内核集合同步
+    pthread_mutex_t lock;
+} quarantine_state = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static size_t mirror_hash(uint32_t addr, size_t mask) {
+    return (size_t)((addr * 2654435761u) & mask);
+}
+
+static bool mirror_contains(uint32_t addr) {
+    if (!quarantine_state.slots) return false;
+    size_t mask = quarantine_state.capacity - 1;
+    for (size_t i = mirror_hash(addr, mask);; i = (i + 1) & mask) {
+        if (quarantine_state.slots[i] == addr) return true;
+        if (quarantine_state.slots[i] == 0) return false;
+    }
+}
+
+static int mirror_grow(void) {
+    size_t capacity = quarantine_state.capacity ? quarantine_state.capacity * 2 : 1024;
+    uint32_t* slots = calloc(capacity, sizeof(uint32_t));
+    if (!slots) return -1;
+
+    for (size_t i = 0; i < quarantine_state.capacity; i++) {
+        uint32_t addr = quarantine_state.slots[i];
+        if (addr == 0) continue;
+        size_t j = mirror_hash(addr, capacity - 1);
+        while (slots[j] != 0) j = (j + 1) & (capacity - 1);
+        slots[j] = addr;
+    }
+    free(quarantine_state.slots);
+    quarantine_state.slots = slots;
+    quarantine_state.capacity = capacity;
+    return 0;
+}
+
+// 返回 1 表示新插入，0 表示已存在，-1 表示内存不足
+static int mirror_insert(uint32_t addr) {
+    if ((quarantine_state.count + 1) * 2 > quarantine_state.capacity && mirror_grow() != 0) {
+        return -1;
+    }
+    size_t mask = quarantine_state.capacity - 1;
+    size_t i = mirror_hash(addr, mask);
+    while (quarantine_state.slots[i] != 0) {
+        if (quarantine_state.slots[i] == addr) return 0;
+        i = (i + 1) & mask;
+    }
+    quarantine_state.slots[i] = addr;
+    quarantine_state.count++;
+    return 1;
+}
+
+// 删除后向前移动后续元素，保持探测链连续
+static bool mirror_remove(uint32_t addr) {
+    if (!quarantine_state.slots) return false;
+    size_t mask = quarantine_state.capacity - 1;
+    size_t i = mirror_hash(addr, mask);
+    while (quarantine_state.slots[i] != addr) {
+        if (quarantine_state.slots[i] == 0) return false;
+        i = (i + 1) & mask;
+    }
+
+    size_t hole = i;
+    for (size_t j = (i + 1) & mask; quarantine_state.slots[j] != 0; j = (j + 1) & mask) {
+        size_t home = mirror_hash(quarantine_state.slots[j], mask);
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            quarantine_state.slots[hole] = quarantine_state.slots[j];
+            hole = j;
+        }
+    }
+    quarantine_state.slots[hole] = 0;
+    quarantine_state.count--;
+    return true;
+}
+
+static void* ipset_msg_begin(re_nl_batch_t* batch, uint8_t cmd, uint16_t flags) {
+    struct nfgenmsg nfg = {
+        .nfgen_family = NFPROTO_IPV4,
+        .version = NFNETLINK_V0,
+        .res_id = htons(0),
+    };
+    void* hdr = re_nl_msg_begin(batch, (NFNL_SUBSYS_IPSET << 8) | cmd, flags, &nfg, sizeof(nfg));
+    re_nl_attr_put_u8(batch, IPSET_ATTR_PROTOCOL, IPSET_PROTOCOL);
+    re_nl_attr_put_str(batch, IPSET_ATTR_SETNAME, RE_QUARANTINE_SET_NAME);
+    return hdr;
+}
+
+static void ipset_put_be32(re_nl_batch_t* batch, uint16_t type, uint32_t host_value) {
+    re_nl_attr_put_u32(batch, type | NLA_F_NET_BYTEORDER, htonl(host_value));
+}
+
+// 批量增删：每条消息携带一个 ADT 容器，内含多个元素
+static void ipset_build_adt(re_nl_batch_t* batch, uint8_t cmd, const uint32_t* addrs, size_t count) {
+    for (size_t base = 0; base < count; base += QUARANTINE_PER_MESSAGE) {
+        size_t end = base + QUARANTINE_PER_MESSAGE < count ? base + QUARANTINE_PER_MESSAGE : count;
+
+        ipset_msg_begin(batch, cmd, 0);
+        re_nl_attr_put_u32(batch, IPSET_ATTR_LINENO, 0);  // 内核要求 ADT 容器携带行号
+        size_t adt = re_nl_nest_begin(batch, IPSET_ATTR_ADT);
+        for (size_t i = base; i < end; i++) {
+            size_t data = re_nl_nest_begin(batch, IPSET_ATTR_DATA);
+            size_t ip = re_nl_nest_begin(batch, IPSET_ATTR_IP);
+            ipset_put_be32(batch, IPSET_ATTR_IPADDR_IPV4, addrs[i]);
+            re_nl_nest_end(batch, ip);
+            re_nl_nest_end(batch, data);
+        }
+        re_nl_nest_end(batch, adt);
+        re_nl_msg_end(batch);
+    }
+}
+
+static int ipset_send(re_nl_batch_t* batch) {
+    int fd = re_nl_open(NETLINK_NETFILTER);
+    if (fd < 0) return fd;
+    int rc = re_nl_batch_send(fd, batch);
+    close(fd);
+    return rc;
+}
+
+// 在属性序列中查找指定类型，忽略嵌套与字节序标志
+static const struct nlattr* ipset_attr_find(const uint8_t* attrs, size_t len, uint16_t type) {
+    while (len >= NLA_HDRLEN) {
+        const struct nlattr* nla = (const struct nlattr*)attrs;
+        if (nla->nla_len < NLA_HDRLEN || nla->nla_len > len) return NULL;
+        if ((nla->nla_type & NLA_TYPE_MASK) == type) return nla;
+        size_t step = NLA_ALIGN(nla->nla_len);
+        if (step >= len) return NULL;
+        attrs += step;
+        len -= step;
+    }
+    return NULL;
+}
+
+// 列表回复：ADT 容器内每个 DATA 对应一个元素
+static int ipset_list_reply(const struct nlmsghdr* nlh, void* arg) {
+    (void)arg;
+    size_t hdr = NLMSG_HDRLEN + NLMSG_ALIGN(sizeof(struct nfgenmsg));
+    if (nlh->nlmsg_len < hdr) return 0;
+    const struct nlattr* adt = ipset_attr_find((const uint8_t*)nlh + hdr, nlh->nlmsg_len - hdr, IPSET_ATTR_ADT);
+    if (!adt) return 0;
+
+    const uint8_t* pos = (const uint8_t*)adt + NLA_HDRLEN;
+    size_t len = adt->nla_len - NLA_HDRLEN;
+    while (len >= NLA_HDRLEN) {
+        const struct nlattr* data = (const struct nlattr*)pos;
+        if (data->nla_len < NLA_HDRLEN || data->nla_len > len) break;
+        const struct nlattr* ip = ipset_attr_find(pos + NLA_HDRLEN, data->nla_len - NLA_HDRLEN, IPSET_ATTR_IP);
+        const struct nlattr* addr = ip ? ipset_attr_find((const uint8_t*)ip + NLA_HDRLEN, ip->nla_len - NLA_HDRLEN,
+                                                         IPSET_ATTR_IPADDR_IPV4) : NULL;
+        if (addr && addr->nla_len >= NLA_HDRLEN + sizeof(uint32_t)) {
+            uint32_t value;
+            memcpy(&value, (const uint8_t*)addr + NLA_HDRLEN, sizeof(value));
+            if (value != 0 && mirror_insert(ntohl(value)) < 0) return -ENOMEM;
+        }
+        size_t step = NLA_ALIGN(data->nla_len);
+        if (step >= len) break;
+        pos += step;
+        len -= step;
+    }
+    return 0;
+}
+
+// 内核集合不随进程退出消失，首次使用时从内核载入镜像，调用者持有锁
+static int quarantine_load_locked(void) {
+    if (quarantine_state.loaded) return 0;
+
+    int fd = re_nl_open(NETLINK_NETFILTER);
+    if (fd < 0) return fd;
+    re_nl_batch_t batch;
+    re_nl_batch_init(&batch);
+    ipset_msg_begin(&batch, IPSET_CMD_LIST, NLM_F_DUMP);
+    re_nl_msg_end(&batch);
+    int rc = re_nl_dump(fd, &batch, ipset_list_reply, NULL);
+    re_nl_batch_free(&batch);
+    close(fd);
+
+    if (rc == -ENOENT) rc = 0;        // 集合尚未创建
+    if (rc != 0) {
+        printf("[NETWORK] 读取隔离集合失败: %s\n", strerror(-rc));
+        free(quarantine_state.slots);
+        quarantine_state.slots = NULL;
+        quarantine_state.capacity = 0;
+        quarantine_state.count = 0;
+        return rc;
+    }
+    quarantine_state.loaded = true;
+    if (quarantine_state.count > 0) {
+        printf("[NETWORK] 接管已隔离主机 %zu 台\n", quarantine_state.count);
+    }
+    return 0;
+}
+
+// 首次使用时创建集合并挂接两条固定规则，调用者持有锁
+static int quarantine_ensure_set_locked(void) {
+    if (quarantine_state.set_ready) return 0;
+
+    re_nl_batch_t batch;
+    re_nl_batch_init(&batch);
+    ipset_msg_begin(&batch, IPSET_CMD_CREATE, 0);
+    re_nl_attr_put_str(&batch, IPSET_ATTR_TYPENAME, "hash:ip");
+    re_nl_attr_put_u8(&batch, IPSET_ATTR_REVISION, 0);
+    re_nl_attr_put_u8(&batch, IPSET_ATTR_FAMILY, NFPROTO_IPV4);
+    size_t data = re_nl_nest_begin(&batch, IPSET_ATTR_DATA);
+    ipset_put_be32(&batch, IPSET_ATTR_HASHSIZE, QUARANTINE_HASHSIZE);
+    ipset_put_be32(&batch, IPSET_ATTR_MAXELEM, RE_QUARANTINE_MAX_HOSTS);
+    re_nl_nest_end(&batch, data);
+    re_nl_msg_end(&batch);
+
+    int rc = ipset_send(&batch);
+    re_nl_batch_free(&batch);
+    if (rc != 0) {
+        printf("[NETWORK] 创建隔离集合失败: %s\n", strerror(-rc));
+        return rc;
+    }
+
+    // 数据面只有这两条规则，与隔离主机数量无关
+    if (system("iptables -C FORWARD -m set --match-set " RE_QUARANTINE_SET_NAME " src -j DROP 2>/dev/null || "
+               "iptables -I FORWARD -m set --match-set " RE_QUARANTINE_SET_NAME " src -j DROP") != 0 ||
+        system("iptables -C FORWARD -m set --match-set " RE_QUARANTINE_SET_NAME " dst -j DROP 2>/dev/null || "
+               "iptables -I FORWARD -m set --match-set " RE_QUARANTINE_SET_NAME " dst -j DROP") != 0) {
+        printf("[NETWORK] 隔离集合规则挂接失败\n");
+        return -1;
+    }
+
+    quarantine_state.set_ready = true;
+    printf("[NETWORK] 主机隔离集合 %s 已就绪\n", RE_QUARANTINE_SET_NAME);
+    return 0;
+}
+
+// === 公开API实现 ===
+
+int32_t re_quarantine_add(const uint32_t* addrs, size_t count) {
+    if (!addrs && count > 0) return RESPONSE_ERROR_INVALID_PARAM;
+    if (count == 0) return RESPONSE_SUCCESS;
+
+    uint32_t* added = malloc(count * sizeof(uint32_t));
+    if (!added) return RESPONSE_ERROR_CRITICAL_FAILURE;
+
+    pthread_mutex_lock(&quarantine_state.lock);
+    if (quarantine_load_locked() != 0 || quarantine_ensure_set_locked() != 0) {
+        pthread_mutex_unlock(&quarantine_state.lock);
+        free(added);
+        return RESPONSE_ERROR_NETWORK_FAILURE;
+    }
+
+    // 只下发尚未隔离的主机
+    size_t n = 0;
+    int32_t result = RESPONSE_SUCCESS;
+    for (size_t i = 0; i < count; i++) {
+        if (addrs[i] == 0) continue;
+        int rc = mirror_insert(addrs[i]);
+        if (rc < 0) {
+            result = RESPONSE_ERROR_CRITICAL_FAILURE;
+            break;
+        }
+        if (rc == 1) added[n++] = addrs[i];
+    }
+    if (quarantine_state.count > RE_QUARANTINE_MAX_HOSTS) {
+        result = RESPONSE_ERROR_INVALID_PARAM;
+    }
+
+    if (result == RESPONSE_SUCCESS && n > 0) {
+        re_nl_batch_t batch;
+        re_nl_batch_init(&batch);
+        ipset_build_adt(&batch, IPSET_CMD_ADD, added, n);
+        int rc = ipset_send(&batch);
+        re_nl_batch_free(&batch);
+
+        if (rc != 0) {
+            printf("[NETWORK] 批量隔离主机失败: %s\n", strerror(-rc));
+            result = RESPONSE_ERROR_NETWORK_FAILURE;
+        } else {
+            printf("[NETWORK] 新增隔离主机 %zu 台，当前共 %zu 台\n", n, quarantine_state.count);
+        }
+    }
+    if (result != RESPONSE_SUCCESS) {
+        for (size_t i = 0; i < n; i++) mirror_remove(added[i]);
+    }
+
+    pthread_mutex_unlock(&quarantine_state.lock);
+    free(added);
+    return result;
+}
+
+int32_t re_quarantine_remove(const uint32_t* addrs, size_t count) {
+    if (!addrs && count > 0) return RESPONSE_ERROR_INVALID_PARAM;
+    if (count == 0) return RESPONSE_SUCCESS;
+
+    uint32_t* removed = malloc(count * sizeof(uint32_t));
+    if (!removed) return RESPONSE_ERROR_CRITICAL_FAILURE;
+
+    pthread_mutex_lock(&quarantine_state.lock);
+    if (quarantine_load_locked() != 0) {
+        pthread_mutex_unlock(&quarantine_state.lock);
+        free(removed);
+        return RESPONSE_ERROR_NETWORK_FAILURE;
+    }
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (mirror_remove(addrs[i])) removed[n++] = addrs[i];
+    }
+
+    int32_t result = RESPONSE_SUCCESS;
+    if (n > 0) {
+        re_nl_batch_t batch;
+        re_nl_batch_init(&batch);
+        ipset_build_adt(&batch, IPSET_CMD_DEL, removed, n);
+        int rc = ipset_send(&batch);
+        re_nl_batch_free(&batch);
+
+        if (rc != 0) {
+            printf("[NETWORK] 解除主机隔离失败: %s\n", strerror(-rc));
+            for (size_t i = 0; i < n; i++) mirror_insert(removed[i]);
+            result = RESPONSE_ERROR_NETWORK_FAILURE;
+        } else {
+            printf("[NETWORK] 解除隔离主机 %zu 台，当前共 %zu 台\n", n, quarantine_state.count);
+        }
+    }
+
+    pthread_mutex_unlock(&quarantine_state.lock);
+    free(removed);
+    return result;
+}
+
+int32_t re_quarantine_flush(void) {
+    pthread_mutex_lock(&quarantine_state.lock);
+    if (quarantine_load_locked() != 0) {
+        pthread_mutex_unlock(&quarantine_state.lock);
+        return RESPONSE_ERROR_NETWORK_FAILURE;
+    }
+    // 重启前隔离的主机也在集合中，需要一并清空
+    if (!quarantine_state.set_ready && quarantine_state.count == 0) {
+        pthread_mutex_unlock(&quarantine_state.lock);
+        return RESPONSE_SUCCESS;
+    }
+
+    re_nl_batch_t batch;
+    re_nl_batch_init(&batch);
+    ipset_msg_begin(&batch, IPSET_CMD_FLUSH, 0);
+    re_nl_msg_end(&batch);
+    int rc = ipset_send(&batch);
+    re_nl_batch_free(&batch);
+
+    int32_t result = RESPONSE_SUCCESS;
+    if (rc == 0) {
+        free(quarantine_state.slots);
+        quarantine_state.slots = NULL;
+        quarantine_state.capacity = 0;
+        quarantine_state.count = 0;
+        printf("[NETWORK] 已解除全部主机隔离\n");
+    } else {
+        printf("[NETWORK] 清空隔离集合失败: %s\n", strerror(-rc));
+        result = RESPONSE_ERROR_NETWORK_FAILURE;
+    }
+
+    pthread_mutex_unlock(&quarantine_state.lock);
+    return result;
+}
+
+size_t re_quarantine_count(void) {
+    pthread_mutex_lock(&quarantine_state.lock);
+    quarantine_load_locked();
+    size_t count = quarantine_state.count;
+    pthread_mutex_unlock(&quarantine_state.lock);
+    return count;
+}
+
+bool re_quarantine_contains(uint32_t addr) {
+    pthread_mutex_lock(&quarantine_state.lock);
+    quarantine_load_locked();
+    bool found = mirror_contains(addr);
+    pthread_mutex_unlock(&quarantine_state.lock);
+    return found;
+}
@@ -0,0 +1,63 @@
+#ifndef RE_QUARANTINE_H
+#define RE_QUARANTINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @file re_quarantine.h
+ * @brief Host-level quarantine backed by a kernel hash set
+ *
+ * Quarantined hosts live in an ipset hash:ip set matched by one fixed pair
+ * of FORWARD rules (source and destination), so the per-packet cost is a
+ * single hash lookup however many hosts are quarantined. Adding or
+ * removing hosts only updates set membership; bulk updates are sent as
+ * one netlink batch.
+ *
+ * Addresses are IPv4 in host byte order (10.0.3.7 == 0x0A000307).
+ */
+
+#define RE_QUARANTINE_SET_NAME  "cassie_quarantine"
+#define RE_QUARANTINE_MAX_HOSTS 65536
+
+/**
+ * @brief Quarantine a batch of hosts
+ *
+ * Creates the set and its FORWARD rules on first use. Hosts already
+ * quarantined are ignored.
+ *
+ * @param addrs Array of IPv4 addresses (host byte order)
+ * @param count Number of addresses
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_NETWORK_FAILURE if
+ *         the kernel rejected the update
+ */
+int32_t re_quarantine_add(const uint32_t* addrs, size_t count);
+
+/**
+ * @brief Release a batch of hosts from quarantine
+ *
+ * @param addrs Array of IPv4 addresses (host byte order)
+ * @param count Number of addresses
+ * @return RESPONSE_SUCCESS on success, error code on failure
+ */
+int32_t re_quarantine_remove(const uint32_t* addrs, size_t count);
+
+/**
+ * @brief Release every quarantined host (the set and rules stay in place)
+ *
+ * @return RESPONSE_SUCCESS on success, error code on failure
+ */
+int32_t re_quarantine_flush(void);
+
+/**
+ * @brief Number of hosts currently quarantined
+ */
+size_t re_quarantine_count(void);
+
+/**
+ * @brief Check whether a host is quarantined
+ */
+bool re_quarantine_contains(uint32_t addr);
+
+#endif // RE_QUARANTINE_H
@@ -0,0 +1,174 @@
+#include "re_recovery.h"
+#include "response_executor.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#define HEALTH_BACKOFF_MIN_MS   1
+#define HEALTH_BACKOFF_MAX_MS   100
+
+static const char* const stage_names[RE_RECOVERY_STAGE_COUNT] = { "网络", "门禁", "服务" };
+
+// === 恢复配置与统计 ===
+static struct {
+    re_health_check_fn checks[RE_RECOVERY_STAGE_COUNT];
+    void* check_ctx[RE_RECOVERY_STAGE_COUNT];
+    uint32_t timeout_ms[RE_RECOVERY_STAGE_COUNT];
+    re_recovery_timing_t last;
+    pthread_mutex_t lock;
+} recovery_state = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+// 单个阶段的并行执行上下文
+typedef struct {
+    re_recovery_stage_t stage;
+    re_recovery_action_fn action;
+    void* user;
+    re_health_check_fn check;
+    void* check_ctx;
+    uint64_t deadline_ms;
+    int zones[32];
+    int count;
+    _Atomic int next;
+    _Atomic uint32_t recovered;
+    _Atomic uint32_t failed;
+} stage_run_t;
+
+static uint64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000ull + (uint64_t)ts.tv_nsec / 1000000ull;
+}
+
+static void sleep_ms(uint64_t ms) {
+    struct timespec ts = { .tv_sec = (time_t)(ms / 1000), .tv_nsec = (long)(ms % 1000) * 1000000L };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {}
+}
+
+// 以指数退避轮询健康检查，直到通过或阶段超时
+static bool wait_healthy(stage_run_t* run, int zone) {
+    if (!run->check) return true;
+
+    uint64_t backoff = HEALTH_BACKOFF_MIN_MS;
+    for (;;) {
+        if (run->check(run->stage, zone, run->check_ctx)) return true;
+        uint64_t now = monotonic_ms();
+        if (now >= run->deadline_ms) return false;
+        uint64_t left = run->deadline_ms - now;
+        sleep_ms(backoff < left ? backoff : left);
+        if (backoff < HEALTH_BACKOFF_MAX_MS) backoff *= 2;
+    }
+}
+
+static void* stage_worker(void* arg) {
+    stage_run_t* run = arg;
+    for (;;) {
+        int i = atomic_fetch_add(&run->next, 1);
+        if (i >= run->count) break;
+        int zone = run->zones[i];
+
+        int rc = run->action ? run->action(run->stage, zone, run->user) : 0;
+        if (rc == 0 && wait_healthy(run, zone)) {
+            atomic_fetch_or(&run->recovered, 1u << zone);
+        } else {
+            atomic_fetch_or(&run->failed, 1u << zone);
+            printf("[RECOVERY] 区域 %d %s恢复%s\n", zone, stage_names[run->stage],
+                   rc == 0 ? "健康检查超时" : "失败");
+        }
+    }
+    return NULL;
+}
+
+static void run_stage(stage_run_t* run, uint32_t zones) {
+    run->count = 0;
+    for (int zone = 0; zone < 32; zone++) {
+        if (zones & (1u << zone)) run->zones[run->count++] = zone;
+    }
+
+    pthread_t workers[RE_RECOVERY_WORKERS];
+    int started = 0;
+    int nworkers = run->count < RE_RECOVERY_WORKERS ? run->count : RE_RECOVERY_WORKERS;
+    for (int i = 1; i < nworkers; i++) {
+        if (pthread_create(&workers[started], NULL, stage_worker, run) == 0) started++;
+    }
+    stage_worker(run);
+    for (int i = 0; i < started; i++) pthread_join(workers[i], NULL);
+}
+
+// === 公开API实现 ===
+
+int32_t re_recovery_set_health_check(re_recovery_stage_t stage, re_health_check_fn check, void* user) {
+    if (stage >= RE_RECOVERY_STAGE_COUNT) return RESPONSE_ERROR_INVALID_PARAM;
+
+    pthread_mutex_lock(&recovery_state.lock);
+    recovery_state.checks[stage] = check;
+    recovery_state.check_ctx[stage] = user;
+    pthread_mutex_unlock(&recovery_state.lock);
+    return RESPONSE_SUCCESS;
+}
+
+int32_t re_recovery_set_stage_timeout(re_recovery_stage_t stage, uint32_t timeout_ms) {
+    if (stage >= RE_RECOVERY_STAGE_COUNT) return RESPONSE_ERROR_INVALID_PARAM;
+
+    pthread_mutex_lock(&recovery_state.lock);
+    recovery_state.timeout_ms[stage] = timeout_ms;
+    pthread_mutex_unlock(&recovery_state.lock);
+    return RESPONSE_SUCCESS;
+}
+
+int32_t re_recovery_run(uint32_t zones, const re_recovery_action_fn actions[RE_RECOVERY_STAGE_COUNT],
+                        void* user, re_recovery_timing_t* timing) {
+    if (!actions) return RESPONSE_ERROR_INVALID_PARAM;
+
+    re_recovery_timing_t result;
+    memset(&result, 0, sizeof(result));
+    uint64_t start = monotonic_ms();
+    uint32_t remaining = zones;
+
+    for (int stage = 0; stage < RE_RECOVERY_STAGE_COUNT && remaining; stage++) {
+        stage_run_t run;
+        memset(&run, 0, sizeof(run));
+        run.stage = (re_recovery_stage_t)stage;
+        run.action = actions[stage];
+        run.user = user;
+
+        pthread_mutex_lock(&recovery_state.lock);
+        run.check = recovery_state.checks[stage];
+        run.check_ctx = recovery_state.check_ctx[stage];
+        uint32_t timeout = recovery_state.timeout_ms[stage] ? recovery_state.timeout_ms[stage]
+                                                            : RE_RECOVERY_DEFAULT_TIMEOUT_MS;
+        pthread_mutex_unlock(&recovery_state.lock);
+
+        uint64_t stage_start = monotonic_ms();
+        run.deadline_ms = stage_start + timeout;
+        run_stage(&run, remaining);
+
+        result.stage_ms[stage] = monotonic_ms() - stage_start;
+        result.recovered_zones[stage] = atomic_load(&run.recovered);
+        result.failed_zones[stage] = atomic_load(&run.failed);
+        printf("[RECOVERY] %s恢复阶段完成，区域: 0x%08X，失败: 0x%08X，耗时 %llums\n",
+               stage_names[stage], result.recovered_zones[stage], result.failed_zones[stage],
+               (unsigned long long)result.stage_ms[stage]);
+
+        // 未通过本阶段的区域不进入后续阶段
+        remaining = result.recovered_zones[stage];
+    }
+    result.total_ms = monotonic_ms() - start;
+
+    pthread_mutex_lock(&recovery_state.lock);
+    recovery_state.last = result;
+    pthread_mutex_unlock(&recovery_state.lock);
+    if (timing) *timing = result;
+
+    printf("[RECOVERY] 分阶段恢复完成，总耗时 %llums\n", (unsigned long long)result.total_ms);
+    return remaining == zones ? RESPONSE_SUCCESS : RESPONSE_ERROR_TIMEOUT;
+}
+
+void re_recovery_last_timing(re_recovery_timing_t* timing) {
+    if (!timing) return;
+    pthread_mutex_lock(&recovery_state.lock);
+    *timing = recovery_state.last;
+    pthread_mutex_unlock(&recovery_state.lock);
+}
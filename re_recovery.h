@@ -0,0 +1,85 @@
+#ifndef RE_RECOVERY_H
+#define RE_RECOVERY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @file re_recovery.h
+ * @brief Staged, health-gated recovery
+ *
+ * RESPONSE_FULL_RECOVERY restores the affected zones in three stages:
+ * network, then access control, then services. Within a stage all zones
+ * are restored in parallel. A zone only advances to the next stage once
+ * its health check for the current stage passes; zones that do not become
+ * healthy before the stage timeout stay in their current state and are
+ * reported as failed. Stage durations are measured and kept for the last
+ * recovery.
+ */
+
+#define RE_RECOVERY_DEFAULT_TIMEOUT_MS  30000
+#define RE_RECOVERY_WORKERS             8
+
+typedef enum {
+    RE_RECOVERY_NETWORK = 0,
+    RE_RECOVERY_ACCESS,
+    RE_RECOVERY_SERVICES,
+    RE_RECOVERY_STAGE_COUNT
+} re_recovery_stage_t;
+
+/**
+ * @brief Site health probe for one zone after a stage was restored
+ *
+ * Polled with backoff until it returns true or the stage times out.
+ */
+typedef bool (*re_health_check_fn)(re_recovery_stage_t stage, int zone, void* user);
+
+/**
+ * @brief Restores one zone for one stage, returns 0 on success
+ */
+typedef int (*re_recovery_action_fn)(re_recovery_stage_t stage, int zone, void* user);
+
+typedef struct {
+    uint64_t stage_ms[RE_RECOVERY_STAGE_COUNT];         // Wall time per stage
+    uint32_t recovered_zones[RE_RECOVERY_STAGE_COUNT];  // Zones healthy after each stage
+    uint32_t failed_zones[RE_RECOVERY_STAGE_COUNT];     // Zones that failed each stage
+    uint64_t total_ms;                                  // Wall time of the whole recovery
+} re_recovery_timing_t;
+
+/**
+ * @brief Install the health probe for a stage (NULL = action result only)
+ *
+ * @return RESPONSE_SUCCESS on success, error code on failure
+ */
+int32_t re_recovery_set_health_check(re_recovery_stage_t stage, re_health_check_fn check, void* user);
+
+/**
+ * @brief Bound the time a stage may take before unhealthy zones are given up
+ *
+ * @param timeout_ms Timeout in milliseconds (0 = RE_RECOVERY_DEFAULT_TIMEOUT_MS)
+ * @return RESPONSE_SUCCESS on success, error code on failure
+ */
+int32_t re_recovery_set_stage_timeout(re_recovery_stage_t stage, uint32_t timeout_ms);
+
+/**
+ * @brief Run the stages in order over the given zones
+ *
+ * @param zones Bitmask of zones to recover
+ * @param actions Restore action per stage (NULL entries are skipped)
+ * @param user Passed to the actions
+ * @param timing Receives stage timings (may be NULL)
+ * @return RESPONSE_SUCCESS if every zone recovered, RESPONSE_ERROR_TIMEOUT
+ *         if some zone failed to restore or did not become healthy in time
+ */
+int32_t re_recovery_run(uint32_t zones, const re_recovery_action_fn actions[RE_RECOVERY_STAGE_COUNT],
+                        void* user, re_recovery_timing_t* timing);
+
+/**
+ * @brief Timings of the most recent recovery in the process
+ *
+ * Shared by all callers; to report one run, pass a timing struct to
+ * re_recovery_run() instead.
+ */
+void re_recovery_last_timing(re_recovery_timing_t* timing);
+
+#endif // RE_RECOVERY_H
@@ -0,0 +1,585 @@
+#define _GNU_SOURCE
+#include "re_service.h"
+#include "response_executor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+
+#define CPU_MAX_PERIOD_US      100000     // cpu.max 周期
+#define FREEZE_SETTLE_MS       200        // 等待冻结生效的上限
+#define COLD_START_DELAY_US    500000     // 冷切换后等待备份服务启动
+
+typedef struct {
+    bool in_use;
+    re_service_config_t config;
+    int dirfd;                        // cgroup 目录（O_PATH），首次使用时打开
+    int backup_dirfd;                 // 备份实例的 cgroup 目录
+    bool frozen;
+    bool throttled;
+    bool killed;
+    bool failed_over;                 // 流量已切到备份
+    bool prewarmed;                   // 温备实例已预先解冻，空转待命
+} service_entry_t;
+
+// === 服务注册表状态 ===
+static struct {
+    service_entry_t services[RE_SERVICE_MAX];
+    char cgroup_root[RE_SERVICE_CGROUP_MAX];
+    re_service_status_t adopted[RE_SERVICE_MAX];   // 尚未注册服务的接管状态
+    int adopted_count;
+    pthread_mutex_t lock;
+} service_state = { .cgroup_root = RE_SERVICE_DEFAULT_CGROUP_ROOT, .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static uint64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000ull + (uint64_t)ts.tv_nsec / 1000000ull;
+}
+
+static void cg_close(int* dirfd) {
+    if (*dirfd >= 0) close(*dirfd);
+    *dirfd = -1;
+}
+
+static int cg_open(int* dirfd, const char* cgroup) {
+    if (*dirfd < 0) {
+        char path[2 * RE_SERVICE_CGROUP_MAX + 2];
+        snprintf(path, sizeof(path), "%s/%s", service_state.cgroup_root, cgroup);
+        *dirfd = open(path, O_PATH | O_DIRECTORY | O_CLOEXEC);
+    }
+    return *dirfd;
+}
+
+// 写 cgroup 接口文件；cgroup 被重建时重新打开目录重试一次
+static int cg_write_at(int* dirfd, const char* cgroup, const char* file, const char* value) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        int dir = cg_open(dirfd, cgroup);
+        if (dir < 0) return -errno;
+
+        int fd = openat(dir, file, O_WRONLY | O_CLOEXEC);
+        if (fd < 0) {
+            int err = errno;
+            if (err == ENOENT && attempt == 0) {
+                cg_close(dirfd);
+                continue;
+            }
+            return -err;
+        }
+        size_t len = strlen(value);
+        ssize_t n = write(fd, value, len);
+        int err = errno;
+        close(fd);
+        return n == (ssize_t)len ? 0 : -err;
+    }
+    return -ENOENT;
+}
+
+static int cg_write(service_entry_t* svc, const char* file, const char* value) {
+    return cg_write_at(&svc->dirfd, svc->config.cgroup, file, value);
+}
+
+static int cg_write_backup(service_entry_t* svc, const char* file, const char* value) {
+    return cg_write_at(&svc->backup_dirfd, svc->config.backup_cgroup, file, value);
+}
+
+static bool cg_frozen(int events_fd) {
+    char buf[256];
+    ssize_t n = pread(events_fd, buf, sizeof(buf) - 1, 0);
+    if (n <= 0) return false;
+    buf[n] = '\0';
+    return strstr(buf, "frozen 1") != NULL;
+}
+
+// 等待单个 cgroup 到达指定冻结状态，cgroup.events 变化时内核以 POLLPRI 通知
+static bool cg_wait_frozen(int dirfd, bool frozen, int timeout_ms) {
+    int fd = openat(dirfd, "cgroup.events", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    uint64_t deadline = monotonic_ms() + (uint64_t)timeout_ms;
+    bool reached;
+    for (;;) {
+        reached = cg_frozen(fd) == frozen;
+        uint64_t now = monotonic_ms();
+        if (reached || now >= deadline) break;
+        struct pollfd pfd = { .fd = fd, .events = POLLPRI };
+        poll(&pfd, 1, (int)(deadline - now));
+    }
+    close(fd);
+    return reached;
+}
+
+static int service_throttle(service_entry_t* svc, bool release) {
+    const re_service_config_t* cfg = &svc->config;
+    char value[96];
+    int rc = 0;
+
+    if (cfg->cpu_max_percent) {
+        if (release) {
+            snprintf(value, sizeof(value), "max %d", CPU_MAX_PERIOD_US);
+        } else {
+            snprintf(value, sizeof(value), "%u %d",
+                     cfg->cpu_max_percent * (CPU_MAX_PERIOD_US / 100), CPU_MAX_PERIOD_US);
+        }
+        rc = cg_write(svc, "cpu.max", value);
+    }
+    if (rc == 0 && cfg->io_device[0]) {
+        if (release) {
+            snprintf(value, sizeof(value), "%s rbps=max wbps=max", cfg->io_device);
+        } else {
+            snprintf(value, sizeof(value), "%s rbps=%llu wbps=%llu", cfg->io_device,
+                     (unsigned long long)cfg->io_max_bps, (unsigned long long)cfg->io_max_bps);
+        }
+        rc = cg_write(svc, "io.max", value);
+    }
+    return rc;
+}
+
+static void service_entry_close(service_entry_t* svc) {
+    cg_close(&svc->dirfd);
+    cg_close(&svc->backup_dirfd);
+}
+
+static bool service_contained(const service_entry_t* svc) {
+    return svc->frozen || svc->throttled || svc->killed;
+}
+
+static uint8_t service_flags(const service_entry_t* svc) {
+    return (svc->frozen ? RE_SERVICE_FROZEN : 0) |
+           (svc->throttled ? RE_SERVICE_THROTTLED : 0) |
+           (svc->killed ? RE_SERVICE_KILLED : 0) |
+           (svc->failed_over ? RE_SERVICE_FAILED_OVER : 0);
+}
+
+static void service_apply_flags(service_entry_t* svc, uint8_t flags) {
+    svc->frozen = flags & RE_SERVICE_FROZEN;
+    svc->throttled = flags & RE_SERVICE_THROTTLED;
+    svc->killed = flags & RE_SERVICE_KILLED;
+    svc->failed_over = flags & RE_SERVICE_FAILED_OVER;
+}
+
+// 取出某服务待接管的状态，没有则返回 0
+static uint8_t adopted_take_locked(const char* name) {
+    for (int i = 0; i < service_state.adopted_count; i++) {
+        if (strcmp(service_state.adopted[i].name, name) == 0) {
+            uint8_t flags = service_state.adopted[i].flags;
+            service_state.adopted[i] = service_state.adopted[--service_state.adopted_count];
+            return flags;
+        }
+    }
+    return 0;
+}
+
+// 名称会拼入 systemctl 命令行，只允许 systemd 单元名字符且不以 '-' 开头
+static bool unit_name_valid(const char* name) {
+    size_t len = strnlen(name, RE_SERVICE_NAME_MAX);
+    if (len == 0 || len >= RE_SERVICE_NAME_MAX || name[0] == '-') return false;
+    for (size_t i = 0; i < len; i++) {
+        char c = name[i];
+        if (!isalnum((unsigned char)c) && !strchr(":_.@-", c)) return false;
+    }
+    return true;
+}
+
+// === 公开API实现 ===
+
+int32_t re_service_set_cgroup_root(const char* path) {
+    if (!path || strlen(path) >= RE_SERVICE_CGROUP_MAX) return RESPONSE_ERROR_INVALID_PARAM;
+
+    pthread_mutex_lock(&service_state.lock);
+    snprintf(service_state.cgroup_root, sizeof(service_state.cgroup_root), "%s", path);
+    for (int i = 0; i < RE_SERVICE_MAX; i++) {
+        if (service_state.services[i].in_use) service_entry_close(&service_state.services[i]);
+    }
+    pthread_mutex_unlock(&service_state.lock);
+    return RESPONSE_SUCCESS;
+}
+
+int32_t re_service_register(const re_service_config_t* config) {
+    if (!config || !unit_name_valid(config->name) || config->cgroup[0] == '\0' ||
+        config->contain_action > RE_CONTAIN_KILL || config->cpu_max_percent > 100 * 1024 ||
+        config->failover_mode > RE_FAILOVER_HOT ||
+        (config->failover_mode != RE_FAILOVER_COLD && config->backup_cgroup[0] == '\0')) {
+        return RESPONSE_ERROR_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&service_state.lock);
+    service_entry_t* slot = NULL;
+    for (int i = 0; i < RE_SERVICE_MAX; i++) {
+        service_entry_t* svc = &service_state.services[i];
+        if (svc->in_use && strcmp(svc->config.name, config->name) == 0) {
+            slot = svc;
+            break;
+        }
+        if (!svc->in_use && !slot) slot = svc;
+    }
+    if (!slot) {
+        pthread_mutex_unlock(&service_state.lock);
+        return RESPONSE_ERROR_INVALID_PARAM;   // 注册表已满
+    }
+
+    if (slot->in_use) service_entry_close(slot);
+    memset(slot, 0, sizeof(*slot));
+    slot->in_use = true;
+    slot->config = *config;
+    slot->config.name[RE_SERVICE_NAME_MAX - 1] = '\0';
+    slot->config.cgroup[RE_SERVICE_CGROUP_MAX - 1] = '\0';
+    slot->config.backup_cgroup[RE_SERVICE_CGROUP_MAX - 1] = '\0';
+    slot->dirfd = -1;
+    slot->backup_dirfd = -1;
+    service_apply_flags(slot, adopted_take_locked(slot->config.name));
+
+    // 温备实例预先启动后冻结待命，切换时只需解冻
+    if (slot->config.failover_mode == RE_FAILOVER_WARM && !slot->failed_over) {
+        int rc = cg_write_backup(slot, "cgroup.freeze", "1");
+        if (rc != 0) {
+            printf("[SERVICE] 冻结 %s 的温备实例失败: %s\n", config->name, strerror(-rc));
+        }
+    }
+    pthread_mutex_unlock(&service_state.lock);
+
+    printf("[SERVICE] 注册服务 %s，cgroup: %s，区域: 0x%08X\n",
+           config->name, config->cgroup, config->zones);
+    return RESPONSE_SUCCESS;
+}
+
+void re_service_clear(void) {
+    pthread_mutex_lock(&service_state.lock);
+    for (int i = 0; i < RE_SERVICE_MAX; i++) {
+        if (service_state.services[i].in_use) service_entry_close(&service_state.services[i]);
+        service_state.services[i].in_use = false;
+    }
+    service_state.adopted_count = 0;
+    pthread_mutex_unlock(&service_state.lock);
+}
+
+int32_t re_service_contain(uint32_t zones) {
+    struct pollfd waits[RE_SERVICE_MAX];
+    service_entry_t* waiting[RE_SERVICE_MAX];
+    int nwait = 0;
+    int failures = 0;
+    int applied = 0;
+
+    pthread_mutex_lock(&service_state.lock);
+
+    // 第一阶段：连续发出本次响应的全部写操作
+    for (int i = 0; i < RE_SERVICE_MAX; i++) {
+        service_entry_t* svc = &service_state.services[i];
+        if (!svc->in_use || !(svc->config.zones & zones) || service_contained(svc)) continue;
+
+        int rc = 0;
+        switch (svc->config.contain_action) {
+            case RE_CONTAIN_FREEZE:
+                rc = cg_write(svc, "cgroup.freeze", "1");
+                if (rc == 0) {
+                    svc->frozen = true;
+                    int fd = openat(svc->dirfd, "cgroup.events", O_RDONLY | O_CLOEXEC);
+                    if (fd >= 0) {
+                        waits[nwait] = (struct pollfd){ .fd = fd, .events = POLLPRI };
+                        waiting[nwait++] = svc;
+                    }
+                }
+                break;
+            case RE_CONTAIN_THROTTLE:
+                rc = service_throttle(svc, false);
+                if (rc == 0) svc->throttled = true;
+                break;
+            case RE_CONTAIN_KILL:
+                rc = cg_write(svc, "cgroup.kill", "1");
+                if (rc == 0) svc->killed = true;
+                break;
+        }
+
+        if (rc != 0) {
+            failures++;
+            printf("[CONTAINMENT] 服务 %s 控制失败: %s\n", svc->config.name, strerror(-rc));
+        } else {
+            applied++;
+        }
+    }
+
+    // 第二阶段：统一等待冻结完成（进程需在内核中到达安全点）
+    uint64_t deadline = monotonic_ms() + FREEZE_SETTLE_MS;
+    int pending = nwait;
+    while (pending > 0) {
+        for (int i = 0; i < nwait; i++) {
+            if (waits[i].fd >= 0 && cg_frozen(waits[i].fd)) {
+                close(waits[i].fd);
+                waits[i].fd = -1;       // poll 忽略负数 fd
+                pending--;
+            }
+        }
+        uint64_t now = monotonic_ms();
+        if (pending == 0 || now >= deadline) break;
+        poll(waits, (nfds_t)nwait, (int)(deadline - now));
+    }
+    for (int i = 0; i < nwait; i++) {
+        if (waits[i].fd >= 0) {
+            printf("[CONTAINMENT] 服务 %s 冻结未在 %dms 内完成\n", waiting[i]->config.name, FREEZE_SETTLE_MS);
+            close(waits[i].fd);
+        }
+    }
+
+    pthread_mutex_unlock(&service_state.lock);
+
+    printf("[CONTAINMENT] 控制措施已生效 %d 项，失败 %d 项，区域: 0x%08X\n", applied, failures, zones);
+    return failures ? RESPONSE_ERROR_HARDWARE_UNAVAILABLE : RESPONSE_SUCCESS;
+}
+
+int32_t re_service_release(uint32_t zones) {
+    int failures = 0;
+
+    pthread_mutex_lock(&service_state.lock);
+    for (int i = 0; i < RE_SERVICE_MAX; i++) {
+        service_entry_t* svc = &service_state.services[i];
+        if (!svc->in_use || !(svc->config.zones & zones)) continue;
+
+        if (svc->frozen) {
+            if (cg_write(svc, "cgroup.freeze", "0") == 0) svc->frozen = false;
+            else failures++;
+        }
+        if (svc->throttled) {
+            if (service_throttle(svc, true) == 0) svc->throttled = false;
+            else failures++;
+        }
+        svc->killed = false;
+    }
+    pthread_mutex_unlock(&service_state.lock);
+
+    if (failures) printf("[CONTAINMENT] %d 项控制措施解除失败\n", failures);
+    return failures ? RESPONSE_ERROR_HARDWARE_UNAVAILABLE : RESPONSE_SUCCESS;
+}
+
+uint32_t re_service_contained_zones(void) {
+    uint32_t zones = 0;
+    pthread_mutex_lock(&service_state.lock);
+    for (int i = 0; i < RE_SERVICE_MAX; i++) {
+        const service_entry_t* svc = &service_state.services[i];
+        if (svc->in_use && service_contained(svc)) zones |= svc->config.zones;
+    }
+    pthread_mutex_unlock(&service_state.lock);
+    return zones;
+}
+
+static service_entry_t* service_find_locked(const char* name) {
+    for (int i = 0; i < RE_SERVICE_MAX; i++) {
+        service_entry_t* svc = &service_state.services[i];
+        if (svc->in_use && strcmp(svc->config.name, name) == 0) return svc;
+    }
+    return NULL;
+}
+
+// 冷切换：停止主服务并启动备份单元
+static int32_t failover_cold(const char* name) {
+    char command[192];
+    int32_t result = RESPONSE_SUCCESS;
+
+    snprintf(command, sizeof(command), "systemctl stop %s", name);
+    if (system(command) == 0) {
+        printf("[SERVICE] 主服务 %s 已停止\n", name);
+    } else {
+        printf("[SERVICE] 主服务 %s 停止失败\n", name);
+        result = RESPONSE_ERROR_HARDWARE_UNAVAILABLE;
+    }
+
+    snprintf(command, sizeof(command), "systemctl start %s-backup", name);
+    if (system(command) == 0) {
+        printf("[SERVICE] 备份服务 %s 已启动\n", name);
+    } else {
+        printf("[SERVICE] 备份服务 %s 启动失败\n", name);
+        result = RESPONSE_ERROR_HARDWARE_UNAVAILABLE;
+    }
+
+    usleep(COLD_START_DELAY_US);
+    return result;
+}
+
+static int failover_switch_traffic(service_entry_t* svc, bool to_backup) {
+    if (!svc->config.traffic_switch) return 0;
+    return svc->config.traffic_switch(svc->config.name, to_backup, svc->config.traffic_ctx) == 0 ? 0 : -EIO;
+}
+
+int32_t re_service_failover(const char* name) {
+    if (!name || !unit_name_valid(name)) return RESPONSE_ERROR_INVALID_PARAM;
+
+    pthread_mutex_lock(&service_state.lock);
+    service_entry_t* svc = service_find_locked(name);
+    if (!svc || svc->config.failover_mode == RE_FAILOVER_COLD) {
+        bool already = svc && svc->failed_over;
+        pthread_mutex_unlock(&service_state.lock);
+        if (already) return RESPONSE_SUCCESS;
+
+        // 只有备份单元确已接管才记为已切换，失败时保持原状态以便重试
+        int32_t result = failover_cold(name);
+        if (result == RESPONSE_SUCCESS) {
+            pthread_mutex_lock(&service_state.lock);
+            svc = service_find_locked(name);
+            if (svc) svc->failed_over = true;
+            pthread_mutex_unlock(&service_state.lock);
+        }
+        return result;
+    }
+    if (svc->failed_over) {
+        pthread_mutex_unlock(&service_state.lock);
+        return RESPONSE_SUCCESS;
+    }
+
+    uint64_t start = monotonic_ms();
+    bool warm = svc->config.failover_mode == RE_FAILOVER_WARM;
+    bool thaw = warm && !svc->prewarmed;
+    int rc = 0;
+
+    // 温备：先解冻备份并确认其已恢复运行（已预热的备份无需再等待）
+    if (thaw) {
+        rc = cg_write_backup(svc, "cgroup.freeze", "0");
+        if (rc == 0 && !cg_wait_frozen(svc->backup_dirfd, false, FREEZE_SETTLE_MS)) rc = -ETIMEDOUT;
+    }
+    if (rc == 0) rc = failover_switch_traffic(svc, true);
+    if (rc == 0) {
+        // 主服务冻结而非停止，保留状态以便回切
+        int frc = cg_write(svc, "cgroup.freeze", "1");
+        if (frc != 0) printf("[SERVICE] 冻结主服务 %s 失败: %s\n", name, strerror(-frc));
+        svc->failed_over = true;
+        svc->prewarmed = false;
+    } else if (thaw) {
+        cg_write_backup(svc, "cgroup.freeze", "1");
+    }
+    pthread_mutex_unlock(&service_state.lock);
+
+    if (rc != 0) {
+        printf("[SERVICE] 服务 %s 切换失败: %s\n", name, strerror(-rc));
+        return RESPONSE_ERROR_HARDWARE_UNAVAILABLE;
+    }
+    printf("[SERVICE] 服务 %s 已%s切换到备份，耗时 %llums\n", name, warm ? "温备" : "热备",
+           (unsigned long long)(monotonic_ms() - start));
+    return RESPONSE_SUCCESS;
+}
+
+int32_t re_service_prewarm(bool enable) {
+    int changed = 0;
+    int failures = 0;
+
+    pthread_mutex_lock(&service_state.lock);
+    for (int i = 0; i < RE_SERVICE_MAX; i++) {
+        service_entry_t* svc = &service_state.services[i];
+        if (!svc->in_use || svc->failed_over || svc->config.failover_mode == RE_FAILOVER_COLD) continue;
+
+        if (enable) {
+            // 预先打开 cgroup 目录，切换时不再解析路径
+            cg_open(&svc->dirfd, svc->config.cgroup);
+            cg_open(&svc->backup_dirfd, svc->config.backup_cgroup);
+            if (svc->config.failover_mode != RE_FAILOVER_WARM || svc->prewarmed) continue;
+            // 解冻后备份只空转，流量仍在主实例
+            int rc = cg_write_backup(svc, "cgroup.freeze", "0");
+            if (rc == 0 && !cg_wait_frozen(svc->backup_dirfd, false, FREEZE_SETTLE_MS)) rc = -ETIMEDOUT;
+            if (rc != 0) {
+                cg_write_backup(svc, "cgroup.freeze", "1");
+                printf("[SERVICE] 预热 %s 的温备实例失败: %s\n", svc->config.name, strerror(-rc));
+                failures++;
+                continue;
+            }
+            svc->prewarmed = true;
+            changed++;
+        } else if (svc->prewarmed) {
+            int rc = cg_write_backup(svc, "cgroup.freeze", "1");
+            if (rc != 0) {
+                printf("[SERVICE] 重新冻结 %s 的温备实例失败: %s\n", svc->config.name, strerror(-rc));
+                failures++;
+            }
+            svc->prewarmed = false;
+            changed++;
+        }
+    }
+    pthread_mutex_unlock(&service_state.lock);
+
+    if (changed) printf("[SERVICE] %s %d 个温备实例\n", enable ? "已预热" : "已重新冻结", changed);
+    return failures ? RESPONSE_ERROR_HARDWARE_UNAVAILABLE : RESPONSE_SUCCESS;
+}
+
+int32_t re_service_failback(void) {
+    int failures = 0;
+
+    pthread_mutex_lock(&service_state.lock);
+    for (int i = 0; i < RE_SERVICE_MAX; i++) {
+        service_entry_t* svc = &service_state.services[i];
+        if (!svc->in_use || !svc->failed_over) continue;
+
+        const char* name = svc->config.name;
+        int rc = 0;
+        if (svc->config.failover_mode == RE_FAILOVER_COLD) {
+            char command[192];
+            snprintf(command, sizeof(command), "systemctl start %s && systemctl stop %s-backup", name, name);
+            rc = system(command) == 0 ? 0 : -EIO;
+        } else {
+            rc = cg_write(svc, "cgroup.freeze", "0");
+            if (rc == 0 && !cg_wait_frozen(svc->dirfd, false, FREEZE_SETTLE_MS)) rc = -ETIMEDOUT;
+            if (rc == 0) rc = failover_switch_traffic(svc, false);
+            if (rc == 0 && svc->config.failover_mode == RE_FAILOVER_WARM) {
+                rc = cg_write_backup(svc, "cgroup.freeze", "1");
+            }
+        }
+
+        if (rc == 0) {
+            svc->failed_over = false;
+            printf("[SERVICE] 服务 %s 已回切到主实例\n", name);
+        } else {
+            failures++;
+            printf("[SERVICE] 服务 %s 回切失败: %s\n", name, strerror(-rc));
+        }
+    }
+    pthread_mutex_unlock(&service_state.lock);
+
+    return failures ? RESPONSE_ERROR_HARDWARE_UNAVAILABLE : RESPONSE_SUCCESS;
+}
+
+int re_service_export(re_service_status_t* out, int max) {
+    if (!out || max <= 0) return 0;
+
+    int count = 0;
+    pthread_mutex_lock(&service_state.lock);
+    for (int i = 0; i < RE_SERVICE_MAX && count < max; i++) {
+        const service_entry_t* svc = &service_state.services[i];
+        if (!svc->in_use) continue;
+        snprintf(out[count].name, sizeof(out[count].name), "%s", svc->config.name);
+        out[count].flags = service_flags(svc);
+        count++;
+    }
+    pthread_mutex_unlock(&service_state.lock);
+    return count;
+}
+
+int32_t re_service_adopt(const re_service_status_t* status, int count) {
+    if (count < 0 || (count > 0 && !status)) return RESPONSE_ERROR_INVALID_PARAM;
+
+    int32_t rc = RESPONSE_SUCCESS;
+    pthread_mutex_lock(&service_state.lock);
+    for (int i = 0; i < count; i++) {
+        char name[RE_SERVICE_NAME_MAX];
+        snprintf(name, sizeof(name), "%.*s", RE_SERVICE_NAME_MAX - 1, status[i].name);
+
+        service_entry_t* svc = service_find_locked(name);
+        if (svc) {
+            service_apply_flags(svc, status[i].flags);
+            continue;
+        }
+        adopted_take_locked(name);
+        if (!status[i].flags) continue;
+        if (service_state.adopted_count == RE_SERVICE_MAX) {
+            rc = RESPONSE_ERROR_INVALID_PARAM;
+            continue;
+        }
+        re_service_status_t* pending = &service_state.adopted[service_state.adopted_count++];
+        snprintf(pending->name, sizeof(pending->name), "%s", name);
+        pending->flags = status[i].flags;
+    }
+    pthread_mutex_unlock(&service_state.lock);
+
+    if (count) printf("[SERVICE] 接管 %d 个服务的先前状态\n", count);
+    return rc;
+}
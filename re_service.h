@@ -0,0 +1,190 @@
+#ifndef RE_SERVICE_H
+#define RE_SERVICE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @file re_service.h
+ * @brief Service registry and cgroup v2 based containment
+ *
+ * Each registered service is mapped to a cgroup v2 directory and to the
+ * zones it serves. RESPONSE_PARTIAL_CONTAIN applies the service's
+ * containment action by writing the cgroup interface files directly:
+ * freezing keeps process state in memory so recovery resumes the service
+ * instantly, throttling caps CPU and block I/O, killing terminates every
+ * process in the cgroup. All writes of one response are issued back to
+ * back and the freezes are then awaited together.
+ *
+ * Failover is chosen per service. Cold failover stops the primary unit and
+ * starts "<name>-backup". Warm and hot standbys keep the backup started in
+ * its own cgroup (warm: parked frozen, hot: running idle), so failover
+ * only thaws the backup, moves traffic and freezes the primary, which
+ * completes in milliseconds and keeps the primary ready for failback.
+ */
+
+#define RE_SERVICE_MAX             64
+#define RE_SERVICE_NAME_MAX        64
+#define RE_SERVICE_CGROUP_MAX      256
+#define RE_SERVICE_DEFAULT_CGROUP_ROOT  "/sys/fs/cgroup"
+
+typedef enum {
+    RE_CONTAIN_FREEZE = 0,           // cgroup.freeze = 1
+    RE_CONTAIN_THROTTLE,             // cpu.max / io.max limits
+    RE_CONTAIN_KILL                  // cgroup.kill = 1
+} re_contain_action_t;
+
+typedef enum {
+    RE_FAILOVER_COLD = 0,            // systemctl stop primary / start backup
+    RE_FAILOVER_WARM,                // Backup pre-started, parked frozen
+    RE_FAILOVER_HOT                  // Backup pre-started, running idle
+} re_failover_mode_t;
+
+/**
+ * @brief Moves a service's traffic between primary and backup
+ *
+ * Typically updates a load balancer pool, a VIP or a reuseport map.
+ * Returns 0 on success.
+ */
+typedef int (*re_traffic_switch_fn)(const char* service, bool to_backup, void* user);
+
+typedef struct {
+    char name[RE_SERVICE_NAME_MAX];       // Service name (systemd unit without suffix)
+    char cgroup[RE_SERVICE_CGROUP_MAX];   // cgroup path relative to the cgroup root
+    uint32_t zones;                       // Bitmask of zones served
+    re_contain_action_t contain_action;   // Action taken by partial containment
+    uint32_t cpu_max_percent;             // Throttle: CPU cap in percent of one CPU (0 = no cap)
+    char io_device[16];                   // Throttle: "major:minor" for io.max (empty = no cap)
+    uint64_t io_max_bps;                  // Throttle: read/write bytes per second
+    re_failover_mode_t failover_mode;     // How failover reaches the backup
+    char backup_cgroup[RE_SERVICE_CGROUP_MAX]; // Warm/hot: cgroup of the pre-started backup
+    re_traffic_switch_fn traffic_switch;  // Warm/hot: traffic flip (NULL = backup shares the endpoint)
+    void* traffic_ctx;                    // Passed to traffic_switch
+} re_service_config_t;
+
+// Per-service state flags, as persisted across executor restarts
+#define RE_SERVICE_FROZEN          0x01
+#define RE_SERVICE_THROTTLED       0x02
+#define RE_SERVICE_KILLED          0x04
+#define RE_SERVICE_FAILED_OVER     0x08
+
+typedef struct {
+    char name[RE_SERVICE_NAME_MAX];
+    uint8_t flags;                        // RE_SERVICE_* flags
+} re_service_status_t;
+
+/**
+ * @brief Set the mount point of the cgroup v2 hierarchy
+ *
+ * @param path Mount point (default RE_SERVICE_DEFAULT_CGROUP_ROOT)
+ * @return RESPONSE_SUCCESS on success, error code on failure
+ */
+int32_t re_service_set_cgroup_root(const char* path);
+
+/**
+ * @brief Register a service or replace the entry with the same name
+ *
+ * The name must consist of systemd unit-name characters
+ * ([A-Za-z0-9:_.@-]) and must not start with '-'.
+ *
+ * @param config Service configuration
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_INVALID_PARAM if the
+ *         configuration is invalid or the registry is full
+ */
+int32_t re_service_register(const re_service_config_t* config);
+
+/**
+ * @brief Remove every registered service
+ */
+void re_service_clear(void);
+
+/**
+ * @brief Contain the services mapped to the given zones
+ *
+ * Services already contained are skipped.
+ *
+ * @param zones Bitmask of target zones
+ * @return RESPONSE_SUCCESS if every action took effect,
+ *         RESPONSE_ERROR_HARDWARE_UNAVAILABLE if a cgroup write failed
+ */
+int32_t re_service_contain(uint32_t zones);
+
+/**
+ * @brief Thaw and lift throttles on contained services of the given zones
+ *
+ * Killed services are only marked released; restarting them is left to
+ * the service manager.
+ *
+ * @param zones Bitmask of zones to release
+ * @return RESPONSE_SUCCESS on success, error code on failure
+ */
+int32_t re_service_release(uint32_t zones);
+
+/**
+ * @brief Bitmask of zones with at least one contained service
+ */
+uint32_t re_service_contained_zones(void);
+
+/**
+ * @brief Fail a service over to its backup
+ *
+ * Uses the registered failover mode; unregistered services fail over
+ * cold. A service already failed over is left alone.
+ *
+ * @param name Service name
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_INVALID_PARAM if the
+ *         name is not a valid unit name,
+ *         RESPONSE_ERROR_HARDWARE_UNAVAILABLE if the switch failed
+ */
+int32_t re_service_failover(const char* name);
+
+/**
+ * @brief Pre-warm or re-park warm standbys
+ *
+ * With `enable` the backups of warm services that have not failed over are
+ * thawed and left running idle (traffic stays on the primary), and the
+ * cgroup directories of warm and hot services are opened, so a following
+ * failover only moves traffic. Without `enable` the pre-warmed backups
+ * are frozen again. Cold services are not touched: their backup unit may
+ * contend with the primary for its endpoint.
+ *
+ * @param enable true to pre-warm, false to park again
+ * @return RESPONSE_SUCCESS on success,
+ *         RESPONSE_ERROR_HARDWARE_UNAVAILABLE if a cgroup write failed
+ */
+int32_t re_service_prewarm(bool enable);
+
+/**
+ * @brief Return every failed-over registered service to its primary
+ *
+ * Warm backups are parked frozen again.
+ *
+ * @return RESPONSE_SUCCESS on success, error code on failure
+ */
+int32_t re_service_failback(void);
+
+/**
+ * @brief Copy the state flags of every registered service
+ *
+ * @param out Receives one entry per service
+ * @param max Capacity of out
+ * @return Number of entries written
+ */
+int re_service_export(re_service_status_t* out, int max);
+
+/**
+ * @brief Take over state recorded by a previous executor instance
+ *
+ * Only the bookkeeping is restored; cgroups and traffic are assumed to be
+ * still in the recorded state. Entries for services not yet registered
+ * are applied when they register, and a warm backup that is carrying
+ * traffic is then not parked.
+ *
+ * @param status Recorded entries
+ * @param count Number of entries
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_INVALID_PARAM if
+ *         more entries are pending than the registry can hold
+ */
+int32_t re_service_adopt(const re_service_status_t* status, int count);
+
+#endif // RE_SERVICE_H
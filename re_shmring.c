@@ -0,0 +1,316 @@
+#include "re_shmring.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#define SHMRING_IDLE_WAIT_MS  100          // 空闲等待上限，防止生产者异常退出时丢失唤醒
+#define SHMRING_SPIN_POLLS    4096         // 声明空闲前的轮询次数，连续提交时省去唤醒
+
+struct re_shmring {
+    char name[RE_SHMRING_NAME_MAX];
+    char shm_name[RE_SHMRING_NAME_MAX + 16];
+    bool owner;                       // 执行端创建的 ring
+    re_shmring_header_t* hdr;
+    re_shmring_entry_t* sq;
+    re_shmring_completion_t* cq;
+    size_t map_len;
+    uint64_t mask;
+    // 生产者本地位置，不与执行端共享
+    uint64_t sq_head;                 // 下一个提交位置
+    uint64_t cq_tail;                 // 已取走的完成项
+    // 执行端
+    re_ctx_t* ctx;
+    pthread_t consumer;
+    _Atomic bool running;
+    _Atomic uint64_t served;
+};
+
+// === 共享内存布局 ===
+
+static size_t ring_map_len(uint32_t capacity) {
+    return sizeof(re_shmring_header_t) +
+           (size_t)capacity * (sizeof(re_shmring_entry_t) + sizeof(re_shmring_completion_t));
+}
+
+static void ring_bind(re_shmring_t* ring, void* map, uint32_t capacity) {
+    ring->hdr = map;
+    ring->sq = (re_shmring_entry_t*)((uint8_t*)map + sizeof(re_shmring_header_t));
+    ring->cq = (re_shmring_completion_t*)(ring->sq + capacity);
+    ring->map_len = ring_map_len(capacity);
+    ring->mask = capacity - 1;
+}
+
+static bool ring_name_set(re_shmring_t* ring, const char* name) {
+    size_t len = strlen(name);
+    if (len == 0 || len >= RE_SHMRING_NAME_MAX) return false;
+    // 名称用作共享内存对象名，只允许安全字符
+    for (size_t i = 0; i < len; i++) {
+        char c = name[i];
+        if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-')) {
+            return false;
+        }
+    }
+    snprintf(ring->name, sizeof(ring->name), "%s", name);
+    snprintf(ring->shm_name, sizeof(ring->shm_name), "/re_ring_%s", name);
+    return true;
+}
+
+// === futex 唤醒 ===
+
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// 共享映射跨进程使用，不能加 FUTEX_PRIVATE_FLAG
+static void futex_wait(_Atomic uint32_t* word, uint32_t expected, uint32_t timeout_ms) {
+    struct timespec ts = { .tv_sec = timeout_ms / 1000, .tv_nsec = (long)(timeout_ms % 1000) * 1000000L };
+    syscall(SYS_futex, word, FUTEX_WAIT, expected, &ts, NULL, 0);
+}
+
+static void futex_wake(_Atomic uint32_t* word) {
+    syscall(SYS_futex, word, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+static void consumer_wake(re_shmring_header_t* hdr) {
+    atomic_fetch_add(&hdr->wake_seq, 1);
+    futex_wake(&hdr->wake_seq);
+}
+
+// === 执行端 ===
+
+/*
+ * 每个 ring 一个消费线程，按提交顺序执行并回写结果。
+ * 空闲时先声明 consumer_idle 再复查 sq_head，与生产者“先发布 sq_head
+ * 再读 consumer_idle”构成 Dekker 式配对（均为顺序一致操作）：
+ * 两者至少有一方看到对方的写入，生产者因此只在消费者可能睡眠时才唤醒。
+ */
+static void* consumer_thread(void* arg) {
+    re_shmring_t* ring = arg;
+    re_shmring_header_t* hdr = ring->hdr;
+    uint64_t capacity = ring->mask + 1;
+    uint64_t tail = 0;
+    uint64_t cq_head = 0;
+
+    while (atomic_load_explicit(&ring->running, memory_order_acquire)) {
+        uint64_t head = atomic_load_explicit(&hdr->sq_head, memory_order_acquire);
+        for (int spin = 0; head == tail && spin < SHMRING_SPIN_POLLS; spin++) {
+            cpu_relax();
+            head = atomic_load_explicit(&hdr->sq_head, memory_order_acquire);
+        }
+        if (head == tail) {
+            uint32_t seq = atomic_load(&hdr->wake_seq);
+            atomic_store(&hdr->consumer_idle, 1);
+            head = atomic_load(&hdr->sq_head);
+            if (head == tail && atomic_load(&ring->running)) {
+                futex_wait(&hdr->wake_seq, seq, SHMRING_IDLE_WAIT_MS);
+            }
+            atomic_store(&hdr->consumer_idle, 0);
+            continue;
+        }
+        // 共享内存中的位置不可信：超出容量说明生产者写坏了 ring
+        if (head - tail > capacity) {
+            printf("[SHMRING] ring %s 提交位置异常，停止服务\n", ring->name);
+            break;
+        }
+
+        while (tail != head && atomic_load_explicit(&ring->running, memory_order_relaxed)) {
+            // 先复制出来再校验，生产者可能同时改写共享内存
+            re_shmring_entry_t entry = ring->sq[tail & ring->mask];
+            int32_t result = RESPONSE_ERROR_INVALID_PARAM;
+            if (re_validate_parameters(&entry.response)) {
+                result = ring->ctx ? re_ctx_execute(ring->ctx, &entry.response)
+                                   : re_execute_integrated(&entry.response);
+            }
+
+            re_shmring_completion_t* done = &ring->cq[cq_head & ring->mask];
+            done->cookie = entry.cookie;
+            done->result = result;
+            done->reserved = 0;
+            atomic_store_explicit(&hdr->cq_head, ++cq_head, memory_order_release);
+            tail++;
+            atomic_fetch_add_explicit(&ring->served, 1, memory_order_relaxed);
+        }
+    }
+
+    atomic_store(&hdr->closed, 1);
+    return NULL;
+}
+
+re_shmring_t* re_shmring_serve(const char* name, uint32_t slots, re_ctx_t* ctx) {
+    if (!name) return NULL;
+    uint32_t wanted = slots ? slots : RE_SHMRING_DEFAULT_SLOTS;
+    if (wanted > RE_SHMRING_MAX_SLOTS) return NULL;
+    uint32_t capacity = 1;
+    while (capacity < wanted) capacity <<= 1;
+
+    re_shmring_t* ring = calloc(1, sizeof(*ring));
+    if (!ring) return NULL;
+    if (!ring_name_set(ring, name)) {
+        free(ring);
+        return NULL;
+    }
+
+    // 替换上次执行端异常退出时遗留的同名 ring
+    shm_unlink(ring->shm_name);
+    int fd = shm_open(ring->shm_name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0660);
+    if (fd < 0) {
+        printf("[SHMRING] 无法创建共享内存 %s: %s\n", ring->shm_name, strerror(errno));
+        free(ring);
+        return NULL;
+    }
+    size_t len = ring_map_len(capacity);
+    void* map = MAP_FAILED;
+    if (ftruncate(fd, (off_t)len) == 0) {
+        map = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (map == MAP_FAILED) {
+        printf("[SHMRING] 无法映射共享内存 %s: %s\n", ring->shm_name, strerror(errno));
+        shm_unlink(ring->shm_name);
+        free(ring);
+        return NULL;
+    }
+
+    ring_bind(ring, map, capacity);
+    ring->owner = true;
+    ring->ctx = ctx;
+    re_shmring_header_t* hdr = ring->hdr;
+    hdr->capacity = capacity;
+    hdr->entry_size = sizeof(re_shmring_entry_t);
+    hdr->version = RE_SHMRING_VERSION;
+    atomic_init(&ring->running, true);
+    // magic 最后写入，生产者看到它时其余字段已就绪
+    atomic_thread_fence(memory_order_release);
+    hdr->magic = RE_SHMRING_MAGIC;
+
+    if (pthread_create(&ring->consumer, NULL, consumer_thread, ring) != 0) {
+        munmap(map, len);
+        shm_unlink(ring->shm_name);
+        free(ring);
+        return NULL;
+    }
+
+    printf("[SHMRING] 提交 ring %s 已就绪 (%u 槽位)\n", ring->shm_name, capacity);
+    return ring;
+}
+
+void re_shmring_close(re_shmring_t* ring) {
+    if (!ring || !ring->owner) return;
+
+    atomic_store(&ring->running, false);
+    consumer_wake(ring->hdr);
+    pthread_join(ring->consumer, NULL);
+
+    uint64_t pending = atomic_load(&ring->hdr->sq_head) - atomic_load(&ring->hdr->cq_head);
+    if (pending > 0 && pending <= ring->mask + 1) {
+        printf("[SHMRING] ring %s 关闭，未执行的提交 %llu 条\n", ring->name, (unsigned long long)pending);
+    }
+    munmap(ring->hdr, ring->map_len);
+    shm_unlink(ring->shm_name);
+    free(ring);
+}
+
+uint64_t re_shmring_served(re_shmring_t* ring) {
+    return ring ? atomic_load(&ring->served) : 0;
+}
+
+// === 生产端 ===
+
+re_shmring_t* re_shmring_attach(const char* name) {
+    if (!name) return NULL;
+
+    re_shmring_t* ring = calloc(1, sizeof(*ring));
+    if (!ring) return NULL;
+    if (!ring_name_set(ring, name)) {
+        free(ring);
+        return NULL;
+    }
+
+    int fd = shm_open(ring->shm_name, O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0) {
+        free(ring);
+        return NULL;
+    }
+    struct stat st;
+    void* map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(re_shmring_header_t)) {
+        map = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (map == MAP_FAILED) {
+        free(ring);
+        return NULL;
+    }
+
+    const re_shmring_header_t* hdr = map;
+    uint32_t magic = hdr->magic;
+    atomic_thread_fence(memory_order_acquire);
+    uint32_t capacity = hdr->capacity;
+    if (magic != RE_SHMRING_MAGIC || hdr->version != RE_SHMRING_VERSION ||
+        hdr->entry_size != sizeof(re_shmring_entry_t) || capacity == 0 ||
+        capacity > RE_SHMRING_MAX_SLOTS || (capacity & (capacity - 1)) != 0 ||
+        ring_map_len(capacity) != (size_t)st.st_size) {
+        printf("[SHMRING] %s 不是兼容的提交 ring\n", ring->shm_name);
+        munmap(map, (size_t)st.st_size);
+        free(ring);
+        return NULL;
+    }
+
+    ring_bind(ring, map, capacity);
+    // 接续前一个生产者留下的位置，其未取走的完成项由本生产者接收
+    ring->sq_head = atomic_load(&ring->hdr->sq_head);
+    ring->cq_tail = atomic_load(&ring->hdr->cq_head);
+    if (ring->sq_head - ring->cq_tail > capacity) ring->cq_tail = ring->sq_head - capacity;
+    return ring;
+}
+
+int32_t re_shmring_submit(re_shmring_t* ring, const integrated_response_t* response, uint64_t cookie) {
+    if (!ring || ring->owner || !response) return RESPONSE_ERROR_INVALID_PARAM;
+
+    re_shmring_header_t* hdr = ring->hdr;
+    if (atomic_load_explicit(&hdr->closed, memory_order_relaxed)) return RESPONSE_ERROR_SHUTDOWN;
+    // 未取走的完成项也占用名额，保证完成 ring 不会溢出
+    if (ring->sq_head - ring->cq_tail > ring->mask) return RESPONSE_ERROR_QUEUE_FULL;
+
+    re_shmring_entry_t* slot = &ring->sq[ring->sq_head & ring->mask];
+    slot->cookie = cookie;
+    slot->response = *response;
+    atomic_store(&hdr->sq_head, ++ring->sq_head);
+
+    // 消费者忙碌时不进入内核
+    if (atomic_load(&hdr->consumer_idle)) consumer_wake(hdr);
+    return RESPONSE_SUCCESS;
+}
+
+int re_shmring_reap(re_shmring_t* ring, re_shmring_completion_t* out, int max) {
+    if (!ring || ring->owner || !out || max <= 0) return 0;
+
+    uint64_t head = atomic_load_explicit(&ring->hdr->cq_head, memory_order_acquire);
+    int n = 0;
+    while (ring->cq_tail != head && n < max) {
+        out[n++] = ring->cq[ring->cq_tail & ring->mask];
+        ring->cq_tail++;
+    }
+    return n;
+}
+
+void re_shmring_detach(re_shmring_t* ring) {
+    if (!ring || ring->owner) return;
+
+    munmap(ring->hdr, ring->map_len);
+    free(ring);
+}
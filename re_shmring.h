@@ -0,0 +1,137 @@
+#ifndef RE_SHMRING_H
+#define RE_SHMRING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "response_executor.h"
+
+/**
+ * @file re_shmring.h
+ * @brief Shared-memory submission rings for co-located producers
+ *
+ * A producer on the same host (e.g. the detection agent) submits responses
+ * by writing them into a ring in POSIX shared memory instead of making a
+ * socket round-trip per request. Each producer gets its own ring, so every
+ * ring has exactly one writer and one reader and needs no locks:
+ *
+ *   submission ring : producer -> executor, one re_shmring_entry_t per response
+ *   completion ring : executor -> producer, one re_shmring_completion_t per response
+ *
+ * The executor serves each ring with one thread that checks every entry
+ * with re_validate_parameters(), executes it on an executor context and
+ * posts the result, in submission order. A submission is a copy into the
+ * ring plus one store; the producer makes a system call only when the
+ * executor thread is idle and has to be woken through the futex in the
+ * ring header. The producer may keep at most `capacity` responses
+ * outstanding (submitted and not yet reaped), which also guarantees the
+ * completion ring never overflows.
+ *
+ * The layout below is shared by both processes; they must run on the same
+ * machine with the same build of this header.
+ */
+
+#define RE_SHMRING_MAGIC          0x474E5253u  // "SRNG"
+#define RE_SHMRING_VERSION        1
+#define RE_SHMRING_NAME_MAX       32
+#define RE_SHMRING_DEFAULT_SLOTS  256
+#define RE_SHMRING_MAX_SLOTS      65536
+
+// Shared ring header; indices increase monotonically and wrap at capacity
+typedef struct {
+    uint32_t magic;                   // RE_SHMRING_MAGIC
+    uint16_t version;                 // RE_SHMRING_VERSION
+    uint16_t reserved;
+    uint32_t capacity;                // Slots per ring (power of two)
+    uint32_t entry_size;              // sizeof(re_shmring_entry_t)
+    _Alignas(64) _Atomic uint64_t sq_head;        // Written by the producer
+    _Alignas(64) _Atomic uint64_t cq_head;        // Written by the executor
+    _Alignas(64) _Atomic uint32_t consumer_idle;  // Executor thread is about to sleep
+    _Atomic uint32_t wake_seq;                    // Futex word, bumped to wake the executor
+    _Atomic uint32_t closed;                      // Executor stopped serving the ring
+} re_shmring_header_t;
+
+// Submission entry
+typedef struct {
+    uint64_t cookie;                  // Chosen by the producer, echoed in the completion
+    integrated_response_t response;
+} re_shmring_entry_t;
+
+// Completion entry
+typedef struct {
+    uint64_t cookie;
+    int32_t result;                   // response_error_t of the execution
+    uint32_t reserved;
+} re_shmring_completion_t;
+
+typedef struct re_shmring re_shmring_t;
+
+// === Executor side ===
+
+/**
+ * @brief Create a ring in shared memory and start serving it
+ *
+ * Creates "/re_ring_<name>" with mode 0660. An existing ring of the same
+ * name (left behind by a crashed executor) is replaced.
+ *
+ * @param name Producer name, 1-31 characters of [A-Za-z0-9_-]
+ * @param slots Ring capacity, rounded up to a power of two
+ *              (0 = RE_SHMRING_DEFAULT_SLOTS, at most RE_SHMRING_MAX_SLOTS)
+ * @param ctx Context the responses execute on (NULL = default context)
+ * @return Ring handle, NULL on failure
+ */
+re_shmring_t* re_shmring_serve(const char* name, uint32_t slots, re_ctx_t* ctx);
+
+/**
+ * @brief Stop serving a ring and remove it
+ *
+ * Waits for the response currently executing; entries still queued are
+ * not executed. Must be called before the context is destroyed.
+ */
+void re_shmring_close(re_shmring_t* ring);
+
+/**
+ * @brief Number of responses the executor has taken from the ring
+ */
+uint64_t re_shmring_served(re_shmring_t* ring);
+
+// === Producer side ===
+
+/**
+ * @brief Map a ring created by the executor
+ *
+ * @param name Producer name given to re_shmring_serve()
+ * @return Ring handle, NULL if the ring does not exist or is incompatible
+ */
+re_shmring_t* re_shmring_attach(const char* name);
+
+/**
+ * @brief Submit a response
+ *
+ * Never blocks. Wakes the executor thread only if it is idle.
+ *
+ * @param ring Ring handle from re_shmring_attach()
+ * @param response Response to execute
+ * @param cookie Returned with the completion
+ * @return RESPONSE_SUCCESS if queued, RESPONSE_ERROR_QUEUE_FULL if
+ *         `capacity` responses are outstanding, RESPONSE_ERROR_SHUTDOWN if
+ *         the executor closed the ring
+ */
+int32_t re_shmring_submit(re_shmring_t* ring, const integrated_response_t* response, uint64_t cookie);
+
+/**
+ * @brief Collect finished responses without blocking
+ *
+ * @param ring Ring handle from re_shmring_attach()
+ * @param out Receives completions in submission order
+ * @param max Capacity of out
+ * @return Number of completions stored
+ */
+int re_shmring_reap(re_shmring_t* ring, re_shmring_completion_t* out, int max);
+
+/**
+ * @brief Unmap a ring attached with re_shmring_attach()
+ */
+void re_shmring_detach(re_shmring_t* ring);
+
+#endif // RE_SHMRING_H
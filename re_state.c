@@ -0,0 +1,564 @@
+#include "re_state.h"
+#include "re_aio.h"
+#include "response_executor.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define JOURNAL_RECORD_SIZE   96
+
+enum {
+    JOURNAL_CORE = 1,                 // 上下文状态整体替换
+    JOURNAL_SERVICE                   // 单个服务的状态
+};
+
+typedef union {
+    re_state_core_t core;
+    re_service_status_t service;
+} journal_payload_t;
+
+// 日志记录：crc 覆盖其后的全部字节
+typedef struct {
+    uint32_t crc;
+    uint16_t kind;
+    uint16_t reserved;
+    uint64_t seq;
+    uint64_t time_ns;
+    journal_payload_t u;
+    uint8_t pad[JOURNAL_RECORD_SIZE - 24 - sizeof(journal_payload_t)];
+} journal_record_t;
+
+_Static_assert(sizeof(journal_record_t) == JOURNAL_RECORD_SIZE, "journal record size");
+
+struct re_state {
+    char dir[RE_STATE_PATH_MAX];
+    char snap_path[RE_STATE_PATH_MAX + RE_CTX_NAME_MAX + 8];
+    char journal_path[RE_STATE_PATH_MAX + RE_CTX_NAME_MAX + 16];
+    char old_path[RE_STATE_PATH_MAX + RE_CTX_NAME_MAX + 24];    // 检查点期间的旧日志段
+    char next_path[RE_STATE_PATH_MAX + RE_CTX_NAME_MAX + 24];   // 检查点期间的新日志段
+    int journal_fd;
+    off_t journal_off;                // 当前日志段的下一个写入位置
+    re_state_image_t image;           // 已记录的最新状态
+    bool dirty;                       // 自上次快照后有新记录
+    uint32_t segment_records;         // 当前日志段中的记录数
+    atomic_uint write_errors;         // 异步写入失败次数
+    bool old_pending;                 // 旧日志段待快照覆盖后删除（受 snap_lock 保护）
+    uint64_t checkpoints;             // 已完成的检查点数
+    bool running;
+    uint32_t interval_ms;
+    pthread_t writer;
+    pthread_mutex_t lock;
+    pthread_mutex_t snap_lock;        // 串行化快照写入
+    pthread_cond_t wakeup;
+};
+
+// === 全局配置 ===
+static struct {
+    char dir[RE_STATE_PATH_MAX];
+    uint32_t interval_ms;
+    pthread_mutex_t lock;
+} state_config = { .interval_ms = RE_STATE_DEFAULT_INTERVAL_MS, .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static uint64_t realtime_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint32_t crc32_update(uint32_t crc, const void* data, size_t len) {
+    const uint8_t* p = data;
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+        }
+    }
+    return ~crc;
+}
+
+static uint32_t record_crc(const journal_record_t* rec) {
+    return crc32_update(0, (const uint8_t*)rec + sizeof(rec->crc), sizeof(*rec) - sizeof(rec->crc));
+}
+
+static int write_all(int fd, const void* buf, size_t len) {
+    const uint8_t* p = buf;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// === 状态镜像操作 ===
+
+static void image_put_service(re_state_image_t* image, const re_service_status_t* status) {
+    for (int i = 0; i < image->service_count; i++) {
+        if (strncmp(image->services[i].name, status->name, RE_SERVICE_NAME_MAX) == 0) {
+            image->services[i].flags = status->flags;
+            return;
+        }
+    }
+    if (image->service_count < RE_SERVICE_MAX) {
+        image->services[image->service_count] = *status;
+        image->services[image->service_count].name[RE_SERVICE_NAME_MAX - 1] = '\0';
+        image->service_count++;
+    }
+}
+
+static const re_service_status_t* image_find_service(const re_state_image_t* image, const char* name) {
+    for (int i = 0; i < image->service_count; i++) {
+        if (strncmp(image->services[i].name, name, RE_SERVICE_NAME_MAX) == 0) return &image->services[i];
+    }
+    return NULL;
+}
+
+// === 加载 ===
+
+// 映射快照文件并校验，成功返回 0
+static int snapshot_load(const char* path, re_state_image_t* image) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(re_state_snapshot_header_t)) {
+        close(fd);
+        return -1;
+    }
+    size_t size = (size_t)st.st_size;
+    const uint8_t* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+
+    int rc = -1;
+    const re_state_snapshot_header_t* header = (const re_state_snapshot_header_t*)map;
+    size_t body = sizeof(re_state_core_t) + (size_t)header->service_count * sizeof(re_service_status_t);
+    if (header->magic == RE_STATE_SNAPSHOT_MAGIC && header->version == RE_STATE_VERSION &&
+        header->service_count <= RE_SERVICE_MAX && size == sizeof(*header) + body &&
+        crc32_update(0, map + sizeof(*header), body) == header->crc) {
+        image->seq = header->seq;
+        memcpy(&image->core, map + sizeof(*header), sizeof(image->core));
+        image->service_count = 0;
+        const re_service_status_t* services = (const re_service_status_t*)(map + sizeof(*header) + sizeof(re_state_core_t));
+        for (uint32_t i = 0; i < header->service_count; i++) {
+            image_put_service(image, &services[i]);
+        }
+        rc = 0;
+    }
+    munmap((void*)map, size);
+    return rc;
+}
+
+// 映射日志并重放快照之后的记录，返回有效数据的长度，出错返回 -1
+static off_t journal_replay(int fd, re_state_image_t* image, uint64_t* last_seq) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) return -1;
+    if (st.st_size == 0) return 0;
+    if ((size_t)st.st_size < sizeof(re_state_journal_header_t)) return -1;
+
+    size_t size = (size_t)st.st_size;
+    const uint8_t* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) return -1;
+
+    const re_state_journal_header_t* header = (const re_state_journal_header_t*)map;
+    if (header->magic != RE_STATE_JOURNAL_MAGIC || header->version != RE_STATE_VERSION) {
+        munmap((void*)map, size);
+        return -1;
+    }
+
+    size_t offset = sizeof(*header);
+    while (offset + JOURNAL_RECORD_SIZE <= size) {
+        journal_record_t rec;
+        memcpy(&rec, map + offset, sizeof(rec));
+        if (rec.crc != record_crc(&rec) || rec.seq <= *last_seq) break;   // 崩溃时写了一半的尾部
+        *last_seq = rec.seq;
+        offset += JOURNAL_RECORD_SIZE;
+
+        if (rec.seq <= image->seq) continue;   // 快照已包含
+        if (rec.kind == JOURNAL_CORE) {
+            image->core = rec.u.core;
+        } else if (rec.kind == JOURNAL_SERVICE) {
+            image_put_service(image, &rec.u.service);
+        }
+        image->seq = rec.seq;
+    }
+    munmap((void*)map, size);
+    return (off_t)offset;
+}
+
+// 重放一个日志段；文件不存在不算错误
+static int journal_replay_path(const char* path, re_state_image_t* image, uint64_t* last_seq) {
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return errno == ENOENT ? 0 : -1;
+
+    off_t valid = journal_replay(fd, image, last_seq);
+    close(fd);
+    if (valid < 0) {
+        printf("[STATE] %s 不是有效的状态日志\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+// 新建只含文件头的日志段并落盘
+static int journal_create(const char* path) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0640);
+    if (fd < 0) return -1;
+
+    re_state_journal_header_t header = {
+        .magic = RE_STATE_JOURNAL_MAGIC,
+        .version = RE_STATE_VERSION,
+        .created_ns = realtime_ns(),
+    };
+    if (write_all(fd, &header, sizeof(header)) != 0 || fdatasync(fd) != 0) {
+        close(fd);
+        unlink(path);
+        return -1;
+    }
+    return fd;
+}
+
+static void sync_dir(const char* dir) {
+    int dirfd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirfd >= 0) {
+        fsync(dirfd);
+        close(dirfd);
+    }
+}
+
+// === 快照写入 ===
+
+// 写临时文件后原子替换，崩溃时旧快照仍然完整
+static int snapshot_write_image(re_state_t* state, const re_state_image_t* image) {
+    size_t body_len = sizeof(re_state_core_t) + (size_t)image->service_count * sizeof(re_service_status_t);
+    uint8_t buf[sizeof(re_state_snapshot_header_t) + sizeof(re_state_core_t) + sizeof(image->services)];
+    re_state_snapshot_header_t header = {
+        .magic = RE_STATE_SNAPSHOT_MAGIC,
+        .version = RE_STATE_VERSION,
+        .service_count = (uint32_t)image->service_count,
+        .seq = image->seq,
+        .saved_ns = realtime_ns(),
+    };
+    uint8_t* body = buf + sizeof(header);
+    memcpy(body, &image->core, sizeof(image->core));
+    memcpy(body + sizeof(image->core), image->services, (size_t)image->service_count * sizeof(re_service_status_t));
+    header.crc = crc32_update(0, body, body_len);
+    memcpy(buf, &header, sizeof(header));
+
+    char tmp_path[sizeof(state->snap_path) + 4];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", state->snap_path);
+    int rc = -1;
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0640);
+    if (fd >= 0) {
+        if (write_all(fd, buf, sizeof(header) + body_len) == 0 && fdatasync(fd) == 0 &&
+            rename(tmp_path, state->snap_path) == 0) {
+            rc = 0;
+        }
+        close(fd);
+    }
+    if (rc != 0) {
+        printf("[STATE] 写入状态快照失败: %s\n", strerror(errno));
+        unlink(tmp_path);
+        return -1;
+    }
+    sync_dir(state->dir);
+    return 0;
+}
+
+/*
+ * 检查点：切换到新日志段，把切换时刻的状态写成快照，再删除旧日志段。
+ * 持锁期间只复制内存中的状态并交换文件描述符，文件操作都在锁外完成，
+ * 记录状态变化的线程不会被检查点阻塞。
+ *
+ * 崩溃时磁盘上可能同时存在 .journal.old、.journal 与 .journal.next，
+ * 加载时按此顺序重放，序号不大于快照的记录被跳过。
+ */
+static int checkpoint(re_state_t* state) {
+    pthread_mutex_lock(&state->snap_lock);
+
+    // 上次快照失败时旧日志段仍需保留，本次只补写快照
+    bool rotate = !state->old_pending;
+    int next_fd = -1;
+    if (rotate) {
+        next_fd = journal_create(state->next_path);
+        if (next_fd < 0) {
+            printf("[STATE] 无法创建新日志段 %s: %s\n", state->next_path, strerror(errno));
+            pthread_mutex_unlock(&state->snap_lock);
+            return -1;
+        }
+    }
+
+    pthread_mutex_lock(&state->lock);
+    re_state_image_t image = state->image;
+    int old_fd = state->journal_fd;
+    if (rotate) {
+        state->journal_fd = next_fd;
+        state->journal_off = (off_t)sizeof(re_state_journal_header_t);
+        state->segment_records = 0;
+    }
+    state->dirty = false;
+    pthread_mutex_unlock(&state->lock);
+
+    if (rotate) {
+        // 旧日志段上可能还有排队中的写入，关闭前等它们完成
+        re_aio_flush();
+        if (old_fd >= 0) close(old_fd);
+        if (rename(state->journal_path, state->old_path) != 0 && errno != ENOENT) {
+            printf("[STATE] 日志段轮换失败: %s\n", strerror(errno));
+        }
+        rename(state->next_path, state->journal_path);
+        sync_dir(state->dir);
+        state->old_pending = true;
+    }
+
+    int rc = snapshot_write_image(state, &image);
+    if (rc == 0) {
+        // 快照已覆盖旧日志段中的全部记录
+        unlink(state->old_path);
+        if (!rotate) unlink(state->next_path);
+        state->old_pending = false;
+        state->checkpoints++;
+    } else {
+        pthread_mutex_lock(&state->lock);
+        state->dirty = true;
+        pthread_mutex_unlock(&state->lock);
+    }
+
+    pthread_mutex_unlock(&state->snap_lock);
+    return rc;
+}
+
+static void* snapshot_thread(void* arg) {
+    re_state_t* state = arg;
+
+    pthread_mutex_lock(&state->lock);
+    while (state->running) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += state->interval_ms / 1000;
+        deadline.tv_nsec += (long)(state->interval_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        // 周期到达或日志段过长时做检查点
+        if (state->segment_records < RE_STATE_CHECKPOINT_RECORDS &&
+            atomic_load(&state->write_errors) == 0) {
+            pthread_cond_timedwait(&state->wakeup, &state->lock, &deadline);
+        }
+
+        bool write_failed = atomic_exchange(&state->write_errors, 0) > 0;
+        if (state->running && (state->dirty || write_failed)) {
+            pthread_mutex_unlock(&state->lock);
+            checkpoint(state);
+            pthread_mutex_lock(&state->lock);
+        }
+    }
+    pthread_mutex_unlock(&state->lock);
+    return NULL;
+}
+
+// === 公开API实现 ===
+
+int32_t re_state_set_directory(const char* path, uint32_t interval_ms) {
+    if (path && strlen(path) >= RE_STATE_PATH_MAX) return RESPONSE_ERROR_INVALID_PARAM;
+
+    pthread_mutex_lock(&state_config.lock);
+    snprintf(state_config.dir, sizeof(state_config.dir), "%s", path ? path : "");
+    state_config.interval_ms = interval_ms ? interval_ms : RE_STATE_DEFAULT_INTERVAL_MS;
+    pthread_mutex_unlock(&state_config.lock);
+    return RESPONSE_SUCCESS;
+}
+
+re_state_t* re_state_open(const char* name, re_state_image_t* image) {
+    if (!name || !image) return NULL;
+    memset(image, 0, sizeof(*image));
+
+    re_state_t* state = calloc(1, sizeof(*state));
+    if (!state) return NULL;
+
+    pthread_mutex_lock(&state_config.lock);
+    bool enabled = state_config.dir[0] != '\0';
+    snprintf(state->dir, sizeof(state->dir), "%s", state_config.dir);
+    state->interval_ms = state_config.interval_ms;
+    pthread_mutex_unlock(&state_config.lock);
+    if (!enabled) {
+        free(state);
+        return NULL;
+    }
+    snprintf(state->snap_path, sizeof(state->snap_path), "%s/%s.snap", state->dir, name);
+    snprintf(state->journal_path, sizeof(state->journal_path), "%s/%s.journal", state->dir, name);
+    snprintf(state->old_path, sizeof(state->old_path), "%s.old", state->journal_path);
+    snprintf(state->next_path, sizeof(state->next_path), "%s.next", state->journal_path);
+    state->journal_fd = -1;
+
+    // 先载入快照，再按先后顺序重放其后的日志段
+    bool have_snapshot = snapshot_load(state->snap_path, &state->image) == 0;
+    uint64_t last_seq = 0;
+    const char* segments[] = { state->old_path, state->journal_path, state->next_path };
+    for (size_t i = 0; i < sizeof(segments) / sizeof(segments[0]); i++) {
+        if (journal_replay_path(segments[i], &state->image, &last_seq) != 0) {
+            free(state);
+            return NULL;
+        }
+    }
+    // 序号从快照与日志中较大者继续
+    if (last_seq > state->image.seq) state->image.seq = last_seq;
+
+    pthread_mutex_init(&state->lock, NULL);
+    pthread_mutex_init(&state->snap_lock, NULL);
+    pthread_cond_init(&state->wakeup, NULL);
+
+    // 启动时立即做一次检查点：丢弃已重放的日志与损坏的尾部，从空日志段开始
+    state->old_pending = access(state->old_path, F_OK) == 0 || access(state->next_path, F_OK) == 0;
+    if (state->old_pending) {
+        // 上次检查点中断：先补写快照清掉残留的日志段，再轮换
+        checkpoint(state);
+    }
+    if (checkpoint(state) != 0 || state->journal_fd < 0) {
+        printf("[STATE] 无法建立状态日志 %s\n", state->journal_path);
+        if (state->journal_fd >= 0) close(state->journal_fd);
+        pthread_cond_destroy(&state->wakeup);
+        pthread_mutex_destroy(&state->snap_lock);
+        pthread_mutex_destroy(&state->lock);
+        free(state);
+        return NULL;
+    }
+
+    state->running = true;
+    if (pthread_create(&state->writer, NULL, snapshot_thread, state) != 0) {
+        state->running = false;
+    }
+
+    *image = state->image;
+    printf("[STATE] 载入状态 %s（快照: %s，序号: %llu）\n", name, have_snapshot ? "有" : "无",
+           (unsigned long long)image->seq);
+    return state;
+}
+
+/*
+ * 异步日志写入完成回调（在完成线程上运行）。
+ * 写入失败时日志段尾部可能残缺，重放会停在该处；
+ * 因此立即安排一次检查点，由快照覆盖内存中的状态并换用新日志段。
+ */
+static void journal_write_done(int result, void* user) {
+    re_state_t* state = user;
+    if (result >= 0) return;
+
+    printf("[STATE] 写入状态日志失败: %s\n", strerror(-result));
+    // 不取 state->lock：记录线程可能正持锁等待队列空间
+    atomic_fetch_add(&state->write_errors, 1);
+    pthread_cond_signal(&state->wakeup);
+}
+
+int32_t re_state_record(re_state_t* state, const re_state_core_t* core,
+                        const re_service_status_t* services, int count) {
+    if (!state || !core || count < 0 || (count > 0 && !services)) return RESPONSE_ERROR_INVALID_PARAM;
+
+    journal_record_t records[1 + RE_SERVICE_MAX];
+    int n = 0;
+    uint64_t now = realtime_ns();
+
+    pthread_mutex_lock(&state->lock);
+    // 只追加与已记录状态不同的部分
+    if (memcmp(core, &state->image.core, sizeof(*core)) != 0) {
+        memset(&records[n], 0, sizeof(records[n]));
+        records[n].kind = JOURNAL_CORE;
+        records[n].u.core = *core;
+        n++;
+    }
+    for (int i = 0; i < count && n < 1 + RE_SERVICE_MAX; i++) {
+        const re_service_status_t* known = image_find_service(&state->image, services[i].name);
+        if (known ? known->flags == services[i].flags : services[i].flags == 0) continue;
+        memset(&records[n], 0, sizeof(records[n]));
+        records[n].kind = JOURNAL_SERVICE;
+        records[n].u.service = services[i];
+        records[n].u.service.name[RE_SERVICE_NAME_MAX - 1] = '\0';
+        n++;
+    }
+    if (n == 0) {
+        pthread_mutex_unlock(&state->lock);
+        return RESPONSE_SUCCESS;
+    }
+
+    uint64_t seq = state->image.seq;
+    for (int i = 0; i < n; i++) {
+        records[i].seq = ++seq;
+        records[i].time_ns = now;
+        records[i].crc = record_crc(&records[i]);
+    }
+
+    // 交给 io_uring 追加并链接 fdatasync，调用者不等待磁盘
+    size_t len = (size_t)n * sizeof(records[0]);
+    int32_t rc = re_aio_write(state->journal_fd, records, len, state->journal_off,
+                              RE_AIO_DATASYNC, journal_write_done, state);
+    if (rc != RESPONSE_SUCCESS) {
+        printf("[STATE] 写入状态日志失败: %s\n", strerror(errno));
+        rc = RESPONSE_ERROR_CRITICAL_FAILURE;
+    } else {
+        for (int i = 0; i < n; i++) {
+            if (records[i].kind == JOURNAL_CORE) {
+                state->image.core = records[i].u.core;
+            } else {
+                image_put_service(&state->image, &records[i].u.service);
+            }
+        }
+        state->image.seq = seq;
+        state->journal_off += (off_t)len;
+        state->dirty = true;
+        state->segment_records += (uint32_t)n;
+        if (state->segment_records >= RE_STATE_CHECKPOINT_RECORDS) {
+            pthread_cond_signal(&state->wakeup);
+        }
+    }
+    pthread_mutex_unlock(&state->lock);
+    return rc;
+}
+
+int32_t re_state_snapshot(re_state_t* state) {
+    if (!state) return RESPONSE_ERROR_INVALID_PARAM;
+    return checkpoint(state) == 0 ? RESPONSE_SUCCESS : RESPONSE_ERROR_CRITICAL_FAILURE;
+}
+
+uint64_t re_state_checkpoints(re_state_t* state) {
+    if (!state) return 0;
+
+    pthread_mutex_lock(&state->snap_lock);
+    uint64_t count = state->checkpoints;
+    pthread_mutex_unlock(&state->snap_lock);
+    return count;
+}
+
+void re_state_close(re_state_t* state) {
+    if (!state) return;
+
+    pthread_mutex_lock(&state->lock);
+    bool started = state->running;
+    state->running = false;
+    pthread_cond_signal(&state->wakeup);
+    bool dirty = state->dirty;
+    pthread_mutex_unlock(&state->lock);
+    if (started) pthread_join(state->writer, NULL);
+
+    // 等待排队中的日志写入与回调结束，之后才能释放 state
+    re_aio_flush();
+    if (dirty || atomic_exchange(&state->write_errors, 0) > 0) checkpoint(state);
+    close(state->journal_fd);
+    pthread_cond_destroy(&state->wakeup);
+    pthread_mutex_destroy(&state->snap_lock);
+    pthread_mutex_destroy(&state->lock);
+    free(state);
+}
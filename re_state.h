@@ -0,0 +1,153 @@
+#ifndef RE_STATE_H
+#define RE_STATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "re_service.h"
+
+/**
+ * @file re_state.h
+ * @brief Persisted executor state for warm restarts
+ *
+ * Every state change of an executor context (zones locked, isolated,
+ * contained, services failed over, mode and emergency level) is appended
+ * to a journal as a fixed-size record. At startup the snapshot and the
+ * journal are mapped with mmap and the records newer than the snapshot
+ * are replayed, so a restarted executor knows what is in effect without
+ * probing any device.
+ *
+ * A background thread checkpoints periodically, or early once the journal
+ * holds RE_STATE_CHECKPOINT_RECORDS records: it switches appends to a fresh
+ * journal segment, writes the state as of the switch as a snapshot and
+ * then deletes the old segment. Recording only waits for the in-memory
+ * copy and the descriptor swap, never for the snapshot I/O. The journal
+ * therefore never holds much more than one checkpoint's worth of records
+ * and replay time at startup stays bounded regardless of uptime.
+ *
+ * Files live in the state directory as "<context>.snap" and
+ * "<context>.journal"; "<context>.journal.old" and ".journal.next" exist
+ * only while a checkpoint is in progress and are replayed too if a crash
+ * leaves them behind. All use host byte order; they are meant for a
+ * restart on the same machine, not for exchange.
+ *
+ * Snapshot layout:
+ *   header : re_state_snapshot_header_t (32 bytes)
+ *   body   : re_state_core_t, then service_count re_service_status_t
+ * Journal layout:
+ *   header : re_state_journal_header_t (16 bytes)
+ *   records: 96-byte records, each protected by a CRC-32; replay stops at
+ *            the first damaged record (torn write at crash time)
+ */
+
+#define RE_STATE_SNAPSHOT_MAGIC       0x504E5352u  // "RSNP"
+#define RE_STATE_JOURNAL_MAGIC        0x4E4A5352u  // "RSJN"
+#define RE_STATE_VERSION              1
+#define RE_STATE_PATH_MAX             256
+#define RE_STATE_DEFAULT_INTERVAL_MS  10000
+#define RE_STATE_CHECKPOINT_RECORDS   1024         // Journal length that triggers an early checkpoint
+
+#define RE_STATE_EMERGENCY            0x01         // Emergency sequence in effect
+#define RE_STATE_CHAIN_INSTALLED      0x02         // iptables emergency chain present
+
+// Executor context state
+typedef struct {
+    uint8_t mode;                     // system_mode_t
+    uint8_t emergency_level;          // Highest emergency level in effect
+    uint8_t flags;                    // RE_STATE_* flags
+    uint8_t reserved;
+    uint32_t locked;                  // Zone bitmasks as tracked by the executor
+    uint32_t isolated;
+    uint32_t services_stopped;
+    uint32_t surveillance;
+    uint32_t evacuating;
+    uint32_t contained;
+} re_state_core_t;
+
+// Snapshot file header
+typedef struct {
+    uint32_t magic;                   // RE_STATE_SNAPSHOT_MAGIC
+    uint16_t version;                 // RE_STATE_VERSION
+    uint16_t reserved;
+    uint32_t crc;                     // CRC-32 of the body
+    uint32_t service_count;
+    uint64_t seq;                     // Last journal record reflected
+    uint64_t saved_ns;                // CLOCK_REALTIME when written
+} re_state_snapshot_header_t;
+
+// Journal file header
+typedef struct {
+    uint32_t magic;                   // RE_STATE_JOURNAL_MAGIC
+    uint16_t version;                 // RE_STATE_VERSION
+    uint16_t reserved;
+    uint64_t created_ns;              // CLOCK_REALTIME when created
+} re_state_journal_header_t;
+
+// Recovered state
+typedef struct {
+    uint64_t seq;                     // Last journal sequence applied (0 = nothing recorded)
+    re_state_core_t core;
+    re_service_status_t services[RE_SERVICE_MAX];
+    int service_count;
+} re_state_image_t;
+
+typedef struct re_state re_state_t;
+
+/**
+ * @brief Set the directory holding state files
+ *
+ * Must be called before contexts are initialized. NULL or "" disables
+ * persistence (the default).
+ *
+ * @param path Existing directory
+ * @param interval_ms Snapshot period (0 = RE_STATE_DEFAULT_INTERVAL_MS)
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_INVALID_PARAM if the
+ *         path is too long
+ */
+int32_t re_state_set_directory(const char* path, uint32_t interval_ms);
+
+/**
+ * @brief Open the state files of a context and load what they record
+ *
+ * @param name Context name
+ * @param image Receives the recovered state (zeroed if nothing recorded)
+ * @return State handle, NULL if persistence is disabled or the files
+ *         cannot be opened
+ */
+re_state_t* re_state_open(const char* name, re_state_image_t* image);
+
+/**
+ * @brief Journal the current state
+ *
+ * Only the parts that changed since the previous call are appended. The
+ * records are queued through re_aio with a linked fdatasync and the call
+ * returns without waiting for the disk; re_aio_flush() waits for them. If
+ * a queued write fails, the snapshot thread checkpoints right away so the
+ * state still reaches disk.
+ *
+ * @param state State handle
+ * @param core Context state
+ * @param services Current service flags
+ * @param count Number of services
+ * @return RESPONSE_SUCCESS on success, error code on failure
+ */
+int32_t re_state_record(re_state_t* state, const re_state_core_t* core,
+                        const re_service_status_t* services, int count);
+
+/**
+ * @brief Checkpoint now instead of waiting for the next period
+ *
+ * @return RESPONSE_SUCCESS on success, error code on failure
+ */
+int32_t re_state_snapshot(re_state_t* state);
+
+/**
+ * @brief Number of checkpoints completed since the state was opened
+ */
+uint64_t re_state_checkpoints(re_state_t* state);
+
+/**
+ * @brief Write a final checkpoint, stop the snapshot thread and close the files
+ */
+void re_state_close(re_state_t* state);
+
+#endif // RE_STATE_H
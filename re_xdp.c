@@ -0,0 +1,340 @@
+#include "re_xdp.h"
+#include "re_netlink.h"
+#include "response_executor.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <net/if.h>
+#include <arpa/inet.h>
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+#include <linux/rtnetlink.h>
+
+// === BPF 指令编码 ===
+#define BPF_INSN(c, d, s, o, i) \
+    ((struct bpf_insn){ .code = (c), .dst_reg = (d), .src_reg = (s), .off = (o), .imm = (i) })
+#define MOV64_REG(d, s)         BPF_INSN(BPF_ALU64 | BPF_MOV | BPF_X, d, s, 0, 0)
+#define MOV64_IMM(d, i)         BPF_INSN(BPF_ALU64 | BPF_MOV | BPF_K, d, 0, 0, i)
+#define ADD64_IMM(d, i)         BPF_INSN(BPF_ALU64 | BPF_ADD | BPF_K, d, 0, 0, i)
+#define LDX_MEM(sz, d, s, o)    BPF_INSN(BPF_LDX | BPF_MEM | (sz), d, s, o, 0)
+#define STX_MEM(sz, d, s, o)    BPF_INSN(BPF_STX | BPF_MEM | (sz), d, s, o, 0)
+#define ST_MEM(sz, d, o, i)     BPF_INSN(BPF_ST | BPF_MEM | (sz), d, 0, o, i)
+#define JMP_REG(op, d, s, o)    BPF_INSN(BPF_JMP | (op) | BPF_X, d, s, o, 0)
+#define JMP_IMM(op, d, i, o)    BPF_INSN(BPF_JMP | (op) | BPF_K, d, 0, o, i)
+#define ATOMIC_ADD64(d, s, o)   BPF_INSN(BPF_STX | BPF_ATOMIC | BPF_DW, d, s, o, BPF_ADD)
+#define LD_MAP_FD(d, fd)        BPF_INSN(BPF_LD | BPF_DW | BPF_IMM, d, BPF_PSEUDO_MAP_FD, 0, fd), \
+                                BPF_INSN(0, 0, 0, 0, 0)
+#define CALL(fn)                BPF_INSN(BPF_JMP | BPF_CALL, 0, 0, 0, fn)
+#define EXIT()                  BPF_INSN(BPF_JMP | BPF_EXIT, 0, 0, 0, 0)
+
+#define ETH_HLEN_BYTES      14
+#define IPV4_MIN_HLEN       20
+#define ETH_P_IP_LE16       0x0008    // 0x0800 按网络序读入小端寄存器
+#define IPV4_SADDR_OFFSET   (ETH_HLEN_BYTES + 12)
+
+// LPM trie 键：前缀长度 + 网络序地址
+typedef struct {
+    uint32_t prefixlen;
+    uint32_t addr;
+} xdp_lpm_key_t;
+
+// 已安装前缀及引用计数，多个站点可隔离同一前缀
+typedef struct {
+    xdp_lpm_key_t key;
+    uint32_t refs;
+} xdp_prefix_t;
+
+// === XDP 后端状态 ===
+static struct {
+    int map_fd;
+    int prog_fd;
+    int ifindex;
+    char ifname[IF_NAMESIZE];
+    bool attached;
+    uint32_t generation;              // 每次丢弃前缀映射时递增
+    xdp_prefix_t prefixes[RE_XDP_MAX_PREFIXES];
+    uint32_t prefix_count;
+    pthread_mutex_t lock;
+} xdp_state = { .map_fd = -1, .prog_fd = -1, .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static long sys_bpf(int cmd, union bpf_attr* attr) {
+    return syscall(__NR_bpf, cmd, attr, sizeof(*attr));
+}
+
+static int xdp_create_map(void) {
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.map_type = BPF_MAP_TYPE_LPM_TRIE;
+    attr.key_size = sizeof(xdp_lpm_key_t);
+    attr.value_size = sizeof(uint64_t);       // 丢包计数
+    attr.max_entries = RE_XDP_MAX_PREFIXES;
+    attr.map_flags = BPF_F_NO_PREALLOC;
+    snprintf(attr.map_name, sizeof(attr.map_name), "cassie_isolate");
+    return (int)sys_bpf(BPF_MAP_CREATE, &attr);
+}
+
+/*
+ * 等价 C 逻辑：
+ *   if (data + 34 > data_end || eth->h_proto != htons(ETH_P_IP)) return XDP_PASS;
+ *   counter = lookup(map, {32, iph->saddr});
+ *   if (!counter) return XDP_PASS;
+ *   __sync_fetch_and_add(counter, 1);
+ *   return XDP_DROP;
+ */
+static int xdp_load_program(int map_fd) {
+    struct bpf_insn prog[] = {
+        MOV64_REG(BPF_REG_6, BPF_REG_1),
+        LDX_MEM(BPF_W, BPF_REG_2, BPF_REG_6, offsetof(struct xdp_md, data)),
+        LDX_MEM(BPF_W, BPF_REG_3, BPF_REG_6, offsetof(struct xdp_md, data_end)),
+        MOV64_REG(BPF_REG_4, BPF_REG_2),
+        ADD64_IMM(BPF_REG_4, ETH_HLEN_BYTES + IPV4_MIN_HLEN),
+        JMP_REG(BPF_JGT, BPF_REG_4, BPF_REG_3, 15),               // -> pass
+        LDX_MEM(BPF_H, BPF_REG_5, BPF_REG_2, 12),
+        JMP_IMM(BPF_JNE, BPF_REG_5, ETH_P_IP_LE16, 13),           // -> pass
+        LDX_MEM(BPF_W, BPF_REG_5, BPF_REG_2, IPV4_SADDR_OFFSET),
+        ST_MEM(BPF_W, BPF_REG_10, -8, 32),
+        STX_MEM(BPF_W, BPF_REG_10, BPF_REG_5, -4),
+        LD_MAP_FD(BPF_REG_1, map_fd),
+        MOV64_REG(BPF_REG_2, BPF_REG_10),
+        ADD64_IMM(BPF_REG_2, -8),
+        CALL(BPF_FUNC_map_lookup_elem),
+        JMP_IMM(BPF_JEQ, BPF_REG_0, 0, 4),                        // -> pass
+        MOV64_IMM(BPF_REG_1, 1),
+        ATOMIC_ADD64(BPF_REG_0, BPF_REG_1, 0),
+        MOV64_IMM(BPF_REG_0, XDP_DROP),
+        EXIT(),
+        MOV64_IMM(BPF_REG_0, XDP_PASS),                           // pass:
+        EXIT(),
+    };
+
+    static char log_buf[4096];
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.prog_type = BPF_PROG_TYPE_XDP;
+    attr.insns = (uint64_t)(uintptr_t)prog;
+    attr.insn_cnt = sizeof(prog) / sizeof(prog[0]);
+    attr.license = (uint64_t)(uintptr_t)"GPL";
+    attr.log_buf = (uint64_t)(uintptr_t)log_buf;
+    attr.log_size = sizeof(log_buf);
+    attr.log_level = 1;
+    snprintf(attr.prog_name, sizeof(attr.prog_name), "cassie_xdp");
+
+    log_buf[0] = '\0';
+    int fd = (int)sys_bpf(BPF_PROG_LOAD, &attr);
+    if (fd < 0 && log_buf[0]) {
+        printf("[NETWORK] XDP 程序校验失败:\n%s\n", log_buf);
+    }
+    return fd;
+}
+
+// 通过 rtnetlink 挂接/卸载 XDP 程序（prog_fd = -1 表示卸载）
+static int xdp_set_link(int ifindex, int prog_fd) {
+    int fd = re_nl_open(NETLINK_ROUTE);
+    if (fd < 0) return fd;
+
+    re_nl_batch_t batch;
+    re_nl_batch_init(&batch);
+    struct ifinfomsg ifi = { .ifi_family = AF_UNSPEC, .ifi_index = ifindex };
+    re_nl_msg_begin(&batch, RTM_SETLINK, 0, &ifi, sizeof(ifi));
+    size_t xdp = re_nl_nest_begin(&batch, IFLA_XDP);
+    re_nl_attr_put_u32(&batch, IFLA_XDP_FD, (uint32_t)prog_fd);
+    re_nl_nest_end(&batch, xdp);
+    re_nl_msg_end(&batch);
+
+    int rc = re_nl_batch_send(fd, &batch);
+    re_nl_batch_free(&batch);
+    close(fd);
+    return rc;
+}
+
+static void xdp_release_locked(void) {
+    if (xdp_state.attached) {
+        int rc = xdp_set_link(xdp_state.ifindex, -1);
+        if (rc != 0) printf("[NETWORK] 卸载 XDP 程序失败: %s\n", strerror(-rc));
+        printf("[NETWORK] XDP 隔离后端已从 %s 卸载\n", xdp_state.ifname);
+    }
+    if (xdp_state.prog_fd >= 0) close(xdp_state.prog_fd);
+    if (xdp_state.map_fd >= 0) {
+        // 映射中的前缀随之消失，调用者凭代次判断其隔离是否仍有效
+        close(xdp_state.map_fd);
+        xdp_state.generation++;
+        xdp_state.prefix_count = 0;
+    }
+    xdp_state.prog_fd = -1;
+    xdp_state.map_fd = -1;
+    xdp_state.attached = false;
+}
+
+static xdp_lpm_key_t xdp_make_key(uint32_t addr, uint8_t prefixlen) {
+    uint32_t mask = prefixlen ? 0xFFFFFFFFu << (32 - prefixlen) : 0;
+    xdp_lpm_key_t key = { .prefixlen = prefixlen, .addr = htonl(addr & mask) };
+    return key;
+}
+
+static xdp_prefix_t* xdp_find_prefix_locked(const xdp_lpm_key_t* key) {
+    for (uint32_t i = 0; i < xdp_state.prefix_count; i++) {
+        xdp_prefix_t* entry = &xdp_state.prefixes[i];
+        if (entry->key.prefixlen == key->prefixlen && entry->key.addr == key->addr) return entry;
+    }
+    return NULL;
+}
+
+// === 公开API实现 ===
+
+int32_t re_xdp_attach(const char* ifname) {
+    if (!ifname || strlen(ifname) >= IF_NAMESIZE) return RESPONSE_ERROR_INVALID_PARAM;
+
+    int ifindex = (int)if_nametoindex(ifname);
+    if (ifindex == 0) {
+        printf("[NETWORK] 接口 %s 不存在\n", ifname);
+        return RESPONSE_ERROR_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&xdp_state.lock);
+    if (xdp_state.prefix_count > 0) {
+        // 重新挂接会换掉前缀映射，已隔离的前缀不能悄然失效
+        printf("[NETWORK] 仍有 %u 个前缀处于隔离状态，拒绝重新挂接 XDP\n", xdp_state.prefix_count);
+        pthread_mutex_unlock(&xdp_state.lock);
+        return RESPONSE_ERROR_CONFLICT;
+    }
+    xdp_release_locked();
+
+    xdp_state.map_fd = xdp_create_map();
+    if (xdp_state.map_fd < 0) {
+        printf("[NETWORK] 创建 LPM 映射失败: %s\n", strerror(errno));
+        pthread_mutex_unlock(&xdp_state.lock);
+        return errno == EPERM ? RESPONSE_ERROR_ACCESS_DENIED : RESPONSE_ERROR_INIT_FAILED;
+    }
+
+    xdp_state.prog_fd = xdp_load_program(xdp_state.map_fd);
+    if (xdp_state.prog_fd < 0) {
+        int err = errno;
+        printf("[NETWORK] 加载 XDP 程序失败: %s\n", strerror(err));
+        xdp_release_locked();
+        pthread_mutex_unlock(&xdp_state.lock);
+        return err == EPERM ? RESPONSE_ERROR_ACCESS_DENIED : RESPONSE_ERROR_INIT_FAILED;
+    }
+
+    int rc = xdp_set_link(ifindex, xdp_state.prog_fd);
+    if (rc != 0) {
+        printf("[NETWORK] 挂接 XDP 程序到 %s 失败: %s\n", ifname, strerror(-rc));
+        xdp_release_locked();
+        pthread_mutex_unlock(&xdp_state.lock);
+        return RESPONSE_ERROR_NETWORK_FAILURE;
+    }
+
+    xdp_state.ifindex = ifindex;
+    snprintf(xdp_state.ifname, sizeof(xdp_state.ifname), "%s", ifname);
+    xdp_state.attached = true;
+    pthread_mutex_unlock(&xdp_state.lock);
+
+    printf("[NETWORK] XDP 隔离后端已挂接到 %s\n", ifname);
+    return RESPONSE_SUCCESS;
+}
+
+int32_t re_xdp_detach(bool force) {
+    pthread_mutex_lock(&xdp_state.lock);
+    if (xdp_state.prefix_count > 0 && !force) {
+        printf("[NETWORK] 仍有 %u 个前缀处于隔离状态，拒绝卸载 XDP\n", xdp_state.prefix_count);
+        pthread_mutex_unlock(&xdp_state.lock);
+        return RESPONSE_ERROR_CONFLICT;
+    }
+    xdp_release_locked();
+    pthread_mutex_unlock(&xdp_state.lock);
+    return RESPONSE_SUCCESS;
+}
+
+uint32_t re_xdp_generation(void) {
+    pthread_mutex_lock(&xdp_state.lock);
+    uint32_t generation = xdp_state.generation;
+    pthread_mutex_unlock(&xdp_state.lock);
+    return generation;
+}
+
+bool re_xdp_active(void) {
+    pthread_mutex_lock(&xdp_state.lock);
+    bool active = xdp_state.attached;
+    pthread_mutex_unlock(&xdp_state.lock);
+    return active;
+}
+
+int32_t re_xdp_isolate_prefix(uint32_t addr, uint8_t prefixlen) {
+    if (prefixlen > 32) return RESPONSE_ERROR_INVALID_PARAM;
+
+    xdp_lpm_key_t key = xdp_make_key(addr, prefixlen);
+    uint64_t drops = 0;
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.key = (uint64_t)(uintptr_t)&key;
+    attr.value = (uint64_t)(uintptr_t)&drops;
+    attr.flags = BPF_NOEXIST;                 // 已隔离的前缀保留原计数
+
+    pthread_mutex_lock(&xdp_state.lock);
+    int32_t result = RESPONSE_ERROR_INIT_FAILED;
+    if (xdp_state.attached) {
+        xdp_prefix_t* entry = xdp_find_prefix_locked(&key);
+        attr.map_fd = (uint32_t)xdp_state.map_fd;
+        if (entry) {
+            entry->refs++;
+            result = RESPONSE_SUCCESS;
+        } else if (xdp_state.prefix_count >= RE_XDP_MAX_PREFIXES) {
+            result = RESPONSE_ERROR_QUEUE_FULL;
+        } else if (sys_bpf(BPF_MAP_UPDATE_ELEM, &attr) == 0 || errno == EEXIST) {
+            xdp_state.prefixes[xdp_state.prefix_count++] = (xdp_prefix_t){ .key = key, .refs = 1 };
+            result = RESPONSE_SUCCESS;
+        } else {
+            result = RESPONSE_ERROR_NETWORK_FAILURE;
+        }
+    }
+    pthread_mutex_unlock(&xdp_state.lock);
+    return result;
+}
+
+int32_t re_xdp_release_prefix(uint32_t addr, uint8_t prefixlen) {
+    if (prefixlen > 32) return RESPONSE_ERROR_INVALID_PARAM;
+
+    xdp_lpm_key_t key = xdp_make_key(addr, prefixlen);
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.key = (uint64_t)(uintptr_t)&key;
+
+    pthread_mutex_lock(&xdp_state.lock);
+    int32_t result = RESPONSE_SUCCESS;
+    xdp_prefix_t* entry = xdp_find_prefix_locked(&key);
+    if (entry && entry->refs > 1) {
+        // 其他站点仍在隔离该前缀
+        entry->refs--;
+    } else if (entry) {
+        attr.map_fd = (uint32_t)xdp_state.map_fd;
+        if (sys_bpf(BPF_MAP_DELETE_ELEM, &attr) == 0 || errno == ENOENT) {
+            *entry = xdp_state.prefixes[--xdp_state.prefix_count];
+        } else {
+            result = RESPONSE_ERROR_NETWORK_FAILURE;
+        }
+    }
+    pthread_mutex_unlock(&xdp_state.lock);
+    return result;
+}
+
+uint64_t re_xdp_drop_count(uint32_t addr, uint8_t prefixlen) {
+    if (prefixlen > 32) return 0;
+
+    xdp_lpm_key_t key = xdp_make_key(addr, prefixlen);
+    uint64_t drops = 0;
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.key = (uint64_t)(uintptr_t)&key;
+    attr.value = (uint64_t)(uintptr_t)&drops;
+
+    pthread_mutex_lock(&xdp_state.lock);
+    if (xdp_state.attached) {
+        attr.map_fd = (uint32_t)xdp_state.map_fd;
+        // 注意：LPM 查找返回最长匹配前缀的计数
+        if (sys_bpf(BPF_MAP_LOOKUP_ELEM, &attr) != 0) drops = 0;
+    }
+    pthread_mutex_unlock(&xdp_state.lock);
+    return drops;
+}
@@ -0,0 +1,91 @@
+#ifndef RE_XDP_H
+#define RE_XDP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @file re_xdp.h
+ * @brief Optional XDP fast-drop backend for network isolation
+ *
+ * Attaches a small XDP program to a gateway interface that looks up each
+ * IPv4 source address in a BPF LPM-trie map of isolated prefixes and drops
+ * matches before the packet reaches the network stack. While the backend
+ * is attached, RESPONSE_NETWORK_ISOLATE only inserts map entries instead
+ * of appending iptables rules.
+ *
+ * Requires CAP_BPF/CAP_NET_ADMIN. No libbpf dependency: the program is
+ * assembled in place and loaded with the bpf() syscall.
+ */
+
+#define RE_XDP_MAX_PREFIXES  4096
+
+/**
+ * @brief Load the XDP program and attach it to an interface
+ *
+ * The driver (native) hook is used when the interface supports it,
+ * otherwise the kernel falls back to generic XDP. Attaching replaces a
+ * previous attachment made through this API, which is refused while
+ * prefixes are isolated since the new map would start empty.
+ *
+ * @param ifname Interface name (e.g. one end of a veth pair in a test netns)
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_CONFLICT if prefixes
+ *         are still isolated, other error code on failure
+ */
+int32_t re_xdp_attach(const char* ifname);
+
+/**
+ * @brief Detach the XDP program and release the prefix map
+ *
+ * @param force Drop isolated prefixes as well (shutdown); otherwise the
+ *              call is refused while any prefix is isolated
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_CONFLICT if prefixes
+ *         are still isolated and force is false
+ */
+int32_t re_xdp_detach(bool force);
+
+/**
+ * @brief Generation of the prefix map
+ *
+ * Incremented whenever the map is dropped. Prefixes isolated under an
+ * earlier generation are no longer in effect.
+ */
+uint32_t re_xdp_generation(void);
+
+/**
+ * @brief Whether isolation is currently served by the XDP backend
+ */
+bool re_xdp_active(void);
+
+/**
+ * @brief Drop all traffic sourced from a prefix
+ *
+ * Prefixes are reference counted: each successful call must be paired
+ * with one re_xdp_release_prefix() before the prefix stops being dropped.
+ *
+ * @param addr IPv4 network address (host byte order)
+ * @param prefixlen Prefix length (0-32)
+ * @return RESPONSE_SUCCESS on success, error code on failure
+ */
+int32_t re_xdp_isolate_prefix(uint32_t addr, uint8_t prefixlen);
+
+/**
+ * @brief Drop one reference to an isolated prefix
+ *
+ * The prefix is removed from the map when its last reference goes.
+ * Releasing a prefix that is not isolated succeeds.
+ *
+ * @param addr IPv4 network address (host byte order)
+ * @param prefixlen Prefix length (0-32)
+ * @return RESPONSE_SUCCESS on success, error code on failure
+ */
+int32_t re_xdp_release_prefix(uint32_t addr, uint8_t prefixlen);
+
+/**
+ * @brief Packets dropped so far for an isolated prefix
+ *
+ * @return Drop count, 0 if the prefix is not isolated
+ */
+uint64_t re_xdp_drop_count(uint32_t addr, uint8_t prefixlen);
+
+#endif // RE_XDP_H
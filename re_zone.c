@@ -0,0 +1,210 @@
+#include "re_zone.h"
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#define ZONE_NO_GROUP   0xFFFF
+#define ZONE_HASH_SIZE  (RE_ZONE_MAX_NAMES * 2)
+
+typedef struct {
+    char name[RE_ZONE_NAME_LEN];
+    uint16_t parent;
+    uint16_t first_child;
+    uint16_t next_sibling;
+    uint32_t own_zones;               // 本组直接拥有的区域
+    uint32_t expanded_zones;          // 本组及全部子孙的区域（预计算）
+} zone_group_t;
+
+typedef struct {
+    char name[RE_ZONE_NAME_LEN];
+    uint16_t group;                   // ZONE_NO_GROUP 表示空槽
+} zone_name_entry_t;
+
+// === 区域树状态 ===
+static struct {
+    zone_group_t groups[RE_ZONE_MAX_GROUPS];
+    uint16_t group_count;
+    zone_name_entry_t names[ZONE_HASH_SIZE];
+    uint16_t name_count;
+    bool ready;
+    pthread_rwlock_t lock;
+} zone_state = { .lock = PTHREAD_RWLOCK_INITIALIZER };
+
+static uint32_t zone_name_hash(const char* name) {
+    uint32_t h = 2166136261u;
+    for (; *name; name++) {
+        h ^= (uint8_t)*name;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void zone_reset_locked(void) {
+    memset(zone_state.groups, 0, sizeof(zone_state.groups));
+    for (int i = 0; i < ZONE_HASH_SIZE; i++) {
+        zone_state.names[i].name[0] = '\0';
+        zone_state.names[i].group = ZONE_NO_GROUP;
+    }
+    zone_state.group_count = 0;
+    zone_state.name_count = 0;
+    zone_state.ready = true;
+}
+
+// 开放寻址查找：返回名称所在槽位或可插入的空槽
+static zone_name_entry_t* zone_name_slot(const char* name) {
+    uint32_t idx = zone_name_hash(name) & (ZONE_HASH_SIZE - 1);
+    for (;;) {
+        zone_name_entry_t* entry = &zone_state.names[idx];
+        if (entry->group == ZONE_NO_GROUP || strcmp(entry->name, name) == 0) {
+            return entry;
+        }
+        idx = (idx + 1) & (ZONE_HASH_SIZE - 1);
+    }
+}
+
+static uint16_t zone_lookup(const char* name) {
+    if (!zone_state.ready) return ZONE_NO_GROUP;
+    return zone_name_slot(name)->group;
+}
+
+// 重新计算 group 及其所有祖先的展开位图
+static void zone_recompute_upwards(uint16_t group) {
+    while (group != ZONE_NO_GROUP) {
+        zone_group_t* node = &zone_state.groups[group];
+        uint32_t zones = node->own_zones;
+        for (uint16_t c = node->first_child; c != ZONE_NO_GROUP; c = zone_state.groups[c].next_sibling) {
+            zones |= zone_state.groups[c].expanded_zones;
+        }
+        node->expanded_zones = zones;
+        group = node->parent;
+    }
+}
+
+static bool zone_name_valid(const char* name) {
+    return name && name[0] != '\0' && strlen(name) < RE_ZONE_NAME_LEN;
+}
+
+// === 公开API实现 ===
+
+int32_t re_zone_group_define(const char* name, const char* parent, uint32_t zones) {
+    if (!zone_name_valid(name) || (parent && !zone_name_valid(parent))) {
+        return RESPONSE_ERROR_INVALID_PARAM;
+    }
+
+    pthread_rwlock_wrlock(&zone_state.lock);
+    if (!zone_state.ready) zone_reset_locked();
+
+    uint16_t existing = zone_lookup(name);
+    if (existing != ZONE_NO_GROUP) {
+        zone_state.groups[existing].own_zones = zones;
+        zone_recompute_upwards(existing);
+        pthread_rwlock_unlock(&zone_state.lock);
+        return RESPONSE_SUCCESS;
+    }
+
+    uint16_t parent_idx = ZONE_NO_GROUP;
+    if (parent) {
+        parent_idx = zone_lookup(parent);
+        if (parent_idx == ZONE_NO_GROUP) {
+            pthread_rwlock_unlock(&zone_state.lock);
+            printf("[ZONE] 父区域组不存在: %s\n", parent);
+            return RESPONSE_ERROR_INVALID_PARAM;
+        }
+    }
+    if (zone_state.group_count >= RE_ZONE_MAX_GROUPS || zone_state.name_count >= RE_ZONE_MAX_NAMES) {
+        pthread_rwlock_unlock(&zone_state.lock);
+        return RESPONSE_ERROR_INVALID_PARAM;
+    }
+
+    uint16_t idx = zone_state.group_count++;
+    zone_group_t* node = &zone_state.groups[idx];
+    snprintf(node->name, sizeof(node->name), "%s", name);
+    node->parent = parent_idx;
+    node->first_child = ZONE_NO_GROUP;
+    node->next_sibling = ZONE_NO_GROUP;
+    node->own_zones = zones;
+    if (parent_idx != ZONE_NO_GROUP) {
+        node->next_sibling = zone_state.groups[parent_idx].first_child;
+        zone_state.groups[parent_idx].first_child = idx;
+    }
+
+    zone_name_entry_t* entry = zone_name_slot(name);
+    snprintf(entry->name, sizeof(entry->name), "%s", name);
+    entry->group = idx;
+    zone_state.name_count++;
+
+    zone_recompute_upwards(idx);
+    pthread_rwlock_unlock(&zone_state.lock);
+    return RESPONSE_SUCCESS;
+}
+
+int32_t re_zone_group_alias(const char* alias, const char* target) {
+    if (!zone_name_valid(alias) || !zone_name_valid(target)) {
+        return RESPONSE_ERROR_INVALID_PARAM;
+    }
+
+    pthread_rwlock_wrlock(&zone_state.lock);
+    uint16_t group = zone_lookup(target);
+    int32_t result = RESPONSE_ERROR_INVALID_PARAM;
+    if (group != ZONE_NO_GROUP) {
+        zone_name_entry_t* entry = zone_name_slot(alias);
+        if (entry->group == group) {
+            // 重复登记同一别名
+            result = RESPONSE_SUCCESS;
+        } else if (entry->group == ZONE_NO_GROUP && zone_state.name_count < RE_ZONE_MAX_NAMES) {
+            // 已被其他组或别名占用的名称不重新指向，避免解析结果悄然改变
+            snprintf(entry->name, sizeof(entry->name), "%s", alias);
+            entry->group = group;
+            zone_state.name_count++;
+            result = RESPONSE_SUCCESS;
+        }
+    }
+    pthread_rwlock_unlock(&zone_state.lock);
+    return result;
+}
+
+int32_t re_zone_group_resolve(const char* name, uint32_t* zones) {
+    return re_zone_groups_expand(&name, 1, zones);
+}
+
+int32_t re_zone_groups_expand(const char* const* names, size_t count, uint32_t* zones) {
+    if (!names || !zones) return RESPONSE_ERROR_INVALID_PARAM;
+
+    uint32_t merged = 0;
+    int32_t result = RESPONSE_SUCCESS;
+
+    pthread_rwlock_rdlock(&zone_state.lock);
+    for (size_t i = 0; i < count; i++) {
+        uint16_t group = zone_name_valid(names[i]) ? zone_lookup(names[i]) : ZONE_NO_GROUP;
+        if (group == ZONE_NO_GROUP) {
+            printf("[ZONE] 未知区域组: %s\n", names[i] ? names[i] : "(null)");
+            result = RESPONSE_ERROR_INVALID_PARAM;
+            break;
+        }
+        merged |= zone_state.groups[group].expanded_zones;
+    }
+    pthread_rwlock_unlock(&zone_state.lock);
+
+    if (result == RESPONSE_SUCCESS) *zones = merged;
+    return result;
+}
+
+int32_t re_execute_zone_groups(const integrated_response_t* response,
+                               const char* const* groups, size_t count) {
+    if (!response) return RESPONSE_ERROR_INVALID_PARAM;
+
+    uint32_t zones = 0;
+    int32_t result = re_zone_groups_expand(groups, count, &zones);
+    if (result != RESPONSE_SUCCESS) return result;
+
+    integrated_response_t merged = *response;
+    merged.target_zones |= zones;
+    printf("[ZONE] %zu 个区域组合并为区域: 0x%08X\n", count, merged.target_zones);
+    return re_execute_integrated(&merged);
+}
+
+void re_zone_groups_clear(void) {
+    pthread_rwlock_wrlock(&zone_state.lock);
+    zone_reset_locked();
+    pthread_rwlock_unlock(&zone_state.lock);
+}
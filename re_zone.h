@@ -0,0 +1,84 @@
+#ifndef RE_ZONE_H
+#define RE_ZONE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "response_executor.h"
+
+/**
+ * @file re_zone.h
+ * @brief Hierarchical zone groups (buildings, floors, wings)
+ *
+ * Groups form a tree. Each group owns a set of zones and its expanded
+ * bitmap (own zones plus those of all descendants) is precomputed when the
+ * tree changes, so resolving a group or alias name is a single hash lookup.
+ */
+
+#define RE_ZONE_MAX_GROUPS    256     // Maximum number of groups
+#define RE_ZONE_MAX_NAMES     512     // Maximum number of group names + aliases
+#define RE_ZONE_NAME_LEN      32      // Maximum group name length (incl. NUL)
+
+/**
+ * @brief Define a zone group or update the zones it owns
+ *
+ * Redefining an existing group replaces its own zones; its parent is
+ * left unchanged. Ancestor bitmaps are recomputed immediately.
+ *
+ * @param name Group name, e.g. "Building B"
+ * @param parent Parent group name, NULL for a top-level group
+ * @param zones Bitmask of zones owned directly by this group
+ * @return RESPONSE_SUCCESS on success, error code on failure
+ */
+int32_t re_zone_group_define(const char* name, const char* parent, uint32_t zones);
+
+/**
+ * @brief Register an alternative name for an existing group
+ *
+ * @param alias New name (e.g. "B楼")
+ * @param target Name of an existing group or alias
+ * @return RESPONSE_SUCCESS on success (also when the alias already names
+ *         the same group), RESPONSE_ERROR_INVALID_PARAM if the alias
+ *         already names another group or the target is unknown
+ */
+int32_t re_zone_group_alias(const char* alias, const char* target);
+
+/**
+ * @brief Resolve a group or alias to its expanded zone bitmask
+ *
+ * @param name Group or alias name
+ * @param zones Receives the bitmask of the group and all its descendants
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_INVALID_PARAM if unknown
+ */
+int32_t re_zone_group_resolve(const char* name, uint32_t* zones);
+
+/**
+ * @brief Resolve several groups and merge the result into one bitmask
+ *
+ * @param names Array of group or alias names
+ * @param count Number of names
+ * @param zones Receives the union of all expanded bitmasks
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_INVALID_PARAM if any
+ *         name is unknown
+ */
+int32_t re_zone_groups_expand(const char* const* names, size_t count, uint32_t* zones);
+
+/**
+ * @brief Execute one response against a batch of zone groups
+ *
+ * The expansions of all groups are merged with the response's own
+ * target_zones before execution, so overlapping groups are acted upon once.
+ *
+ * @param response Response template
+ * @param groups Array of group or alias names
+ * @param count Number of names
+ * @return Result of re_execute_integrated, or RESPONSE_ERROR_INVALID_PARAM
+ */
+int32_t re_execute_zone_groups(const integrated_response_t* response,
+                               const char* const* groups, size_t count);
+
+/**
+ * @brief Remove all zone groups and aliases
+ */
+void re_zone_groups_clear(void);
+
+#endif // RE_ZONE_H
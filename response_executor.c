@@ -1,23 +1,119 @@
 #include "response_executor.h"
+#include "re_evlog.h"
+#include "re_actuator.h"
+#include "re_comms.h"
+#include "re_quarantine.h"
+#include "re_xdp.h"
+#include "re_service.h"
+#include "re_backup.h"
+#include "re_recovery.h"
+#include "re_init.h"
+#include "re_state.h"
+#include "re_aio.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 #include <pthread.h>
 #include <time.h>
+#include <stdatomic.h>
+#include <errno.h>
 
-// === 子系统状态 ===
-static struct {
+// === 冲突检测 ===
+// 响应计划占用的资源类别
+typedef enum {
+    RES_DOORS = 0,
+    RES_NETWORK,
+    RES_SERVICES,
+    RES_POWER,
+    RES_BACKUP,
+    RES_COMMS,
+    RES_COUNT
+} plan_resource_t;
+
+// 对资源的动作；同一区域上动作不同即视为矛盾
+typedef enum {
+    ACT_NONE = 0,
+    ACT_LOCK,
+    ACT_UNLOCK,
+    ACT_ISOLATE,
+    ACT_STOP,
+    ACT_FAILOVER,                     // 独占动作，与任何动作冲突
+    ACT_POWER_OFF,
+    ACT_ACTIVATE,                     // 独占动作，与任何动作冲突
+    ACT_PRIORITIZE,
+    ACT_RESTORE
+} plan_action_t;
+
+typedef struct response_plan {
+    uint64_t seq;                     // 登记顺序
+    uint32_t priority;
+    uint32_t zones;                   // 冲突消解后的目标区域
+    struct {
+        uint8_t action;
+        uint32_t zones;
+    } claims[RES_COUNT];
+    struct response_plan* next;
+} response_plan_t;
+
+// === 执行器上下文 ===
+// 每个上下文对应一个站点，状态与锁互不共享
+struct re_ctx {
+    char name[RE_CTX_NAME_MAX];
+    char chain[32];                   // 本站点的 iptables 紧急规则链
     bool initialized;
     bool emergency_mode;
     uint8_t current_level;
+    system_mode_t mode;
+    // 当前已生效的区域状态，用于增量执行
+    // 并发执行的响应按位原子更新
+    struct {
+        _Atomic uint32_t locked;              // 门禁已锁定
+        _Atomic uint32_t isolated;            // 网络已隔离
+        _Atomic uint32_t isolated_xdp;        // 其中由 XDP 隔离的区域，其余为 iptables 规则
+        _Atomic uint32_t xdp_generation;      // isolated_xdp 所属的 XDP 前缀映射代次
+        _Atomic uint32_t services_stopped;    // 非核心服务已停止
+        _Atomic uint32_t surveillance;        // 监控已强化
+        _Atomic uint32_t evacuating;          // 疏散路线已解锁
+        _Atomic uint32_t contained;           // 服务 cgroup 已冻结/限流
+    } active;
+    re_init_graph_t init;             // 子系统初始化依赖图
+    re_state_t* state;                // 持久化状态，未配置状态目录时为 NULL
+    response_plan_t* inflight;        // 执行中/等待中的计划，按登记顺序
+    uint64_t plan_seq;
     execution_report_t last_report;
-    pthread_mutex_t lock;
-} subsystem_state = {0};
+    pthread_mutex_t lock;             // 保护计划表、报告与规则链状态，不在执行期间持有
+    pthread_cond_t plan_done;
+    uint32_t detached;                // 仍在运行的紧急序列线程
+    bool closing;                     // 正在关闭，不再接收新响应
+    // 强化警戒期间预先准备的升级动作，由 lock 保护
+    struct {
+        uint8_t state;                        // STAGE_*
+        char rules[32][80];                   // 各区域的 iptables-restore 规则行
+    } stage;
+};
+
+static re_ctx_t default_ctx;
+
+// === 紧急级别响应层级 ===
+typedef struct {
+    response_type_t type;
+    system_mode_t mode;
+    uint32_t duration;
+    const char* name;
+} emergency_tier_t;
+
+static const emergency_tier_t emergency_tiers[] = {
+    { RESPONSE_HEIGHTENED_SURVEILLANCE, MODE_HEIGHTENED_SECURITY, 0,    "强化监控" },
+    { RESPONSE_NETWORK_ISOLATE,         MODE_EMERGENCY,           1800, "区域隔离" },
+    { RESPONSE_LOCKDOWN,                MODE_LOCKDOWN,            3600, "全面封锁" },
+};
+
+// 紧急级别 0-10 对应的层级
+static const uint8_t level_tier[11] = { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2 };
 
 // 添加缺失的函数声明
 static int lockdown_physical_access(uint32_t zones, uint32_t duration);
-static int isolate_network_segments(uint32_t zones, uint8_t severity);
 static int stop_non_critical_services(uint32_t zones);
 static int enhance_surveillance(uint32_t zones);
 static int unlock_evacuation_routes(uint32_t zones);
@@ -25,24 +121,43 @@ static void activate_evacuation_lights(uint32_t zones);
 static void power_down_non_essential(uint32_t zones);
 static void enable_emergency_comms(void);
 static int activate_emergency_backups(uint8_t severity);
-static int execute_partial_containment(const integrated_response_t* response);
-static int execute_recovery_sequence(const integrated_response_t* response);
+static int execute_partial_containment(re_ctx_t* ctx, const integrated_response_t* response);
+static int execute_recovery_sequence(re_ctx_t* ctx, const integrated_response_t* response,
+                                     re_recovery_timing_t* timing);
 static bool check_hardware_readiness(void);
-static int init_network_subsystem(void);
-static int init_access_control(void);
+static int init_hardware(void* user);
+static int init_network_subsystem(void* user);
+static int init_access_control(void* user);
+static int init_isolation_chain(void* user);
 static void restore_normal_access(void);
-static void cleanup_network_rules(void);
+static void cleanup_network_rules(re_ctx_t* ctx);
 static void stop_emergency_services(void);
+static bool stage_commit_isolation(re_ctx_t* ctx, uint32_t zones);
+static uint32_t zones_delta(uint32_t target, uint32_t active, const char* what);
+static void xdp_sync_zones(re_ctx_t* ctx);
+
+// === 子系统初始化依赖图 ===
+// 网络与门禁只依赖硬件检查，二者并行初始化；
+// 紧急规则链只在首次网络隔离时建立
+enum {
+    INIT_HARDWARE = 0,
+    INIT_NETWORK,
+    INIT_ACCESS,
+    INIT_ISOLATION_CHAIN,
+    INIT_NODE_COUNT
+};
+
+static const re_init_node_t init_nodes[INIT_NODE_COUNT] = {
+    [INIT_HARDWARE]        = { "hardware", 0, init_hardware, false },
+    [INIT_NETWORK]         = { "network", 1u << INIT_HARDWARE, init_network_subsystem, false },
+    [INIT_ACCESS]          = { "access", 1u << INIT_HARDWARE, init_access_control, false },
+    [INIT_ISOLATION_CHAIN] = { "isolation-chain", 1u << INIT_NETWORK, init_isolation_chain, true },
+};
 
 // === 缺失函数的存根实现 ===
 static int lockdown_physical_access(uint32_t zones, uint32_t duration) {
     printf("[HARDWARE] 锁定物理门禁，区域: 0x%08X, 持续时间: %d秒\n", zones, duration);
-    return 0;
-}
-
-static int isolate_network_segments(uint32_t zones, uint8_t severity) {
-    printf("[NETWORK] 隔离网络段，区域: 0x%08X, 级别: %d\n", zones, severity);
-    return 0;
+    return re_actuator_command(RE_ACT_DOOR_LOCK, zones) == RESPONSE_SUCCESS ? 0 : -1;
 }
 
 static int stop_non_critical_services(uint32_t zones) {
@@ -57,7 +172,7 @@ static int enhance_surveillance(uint32_t zones) {
 
 static int unlock_evacuation_routes(uint32_t zones) {
     printf("[EVACUATION] 解锁疏散路线，区域: 0x%08X\n", zones);
-    return 0;
+    return re_actuator_command(RE_ACT_DOOR_UNLOCK, zones) == RESPONSE_SUCCESS ? 0 : -1;
 }
 
 static void activate_evacuation_lights(uint32_t zones) {
@@ -74,17 +189,156 @@ static void enable_emergency_comms(void) {
 
 static int activate_emergency_backups(uint8_t severity) {
     printf("[BACKUP] 激活紧急备份，级别: %d\n", severity);
-    return 0;
+    
+    // 级别决定快照范围，各数据卷并行做写时复制快照
+    int32_t rc = re_backup_snapshot(severity);
+    re_evlog_emit(rc == RESPONSE_SUCCESS ? RE_EV_STEP_OK : RE_EV_STEP_FAIL, RE_SUB_BACKUP,
+                  0, 0, severity, "snapshot");
+    return rc == RESPONSE_SUCCESS ? 0 : -1;
 }
 
-static int execute_partial_containment(const integrated_response_t* response) {
+static int execute_partial_containment(re_ctx_t* ctx, const integrated_response_t* response) {
     printf("[CONTAINMENT] 执行局部控制\n");
-    return 0;
+    
+    uint32_t zones = zones_delta(response->target_zones, ctx->active.contained, "局部控制");
+    if (zones == 0) {
+        return 0;
+    }
+    
+    // 区域内服务的冻结、限流与终止在同一批次中完成
+    int32_t rc = re_service_contain(zones);
+    // 部分失败时只记录确有服务被控制的区域，其余区域留待重试与恢复判断
+    atomic_fetch_or(&ctx->active.contained, rc == RESPONSE_SUCCESS ? zones : zones & re_service_contained_zones());
+    re_evlog_emit(rc == RESPONSE_SUCCESS ? RE_EV_STEP_OK : RE_EV_STEP_FAIL, RE_SUB_CONTAINMENT,
+                  response->timestamp, zones, rc, "cgroup");
+    return rc == RESPONSE_SUCCESS ? 0 : -1;
+}
+
+// === 分阶段恢复 ===
+typedef struct {
+    re_ctx_t* ctx;
+    const integrated_response_t* response;
+} recovery_job_t;
+
+static int recover_network_zone(re_recovery_stage_t stage, int zone, void* user) {
+    const recovery_job_t* job = user;
+    re_ctx_t* ctx = job->ctx;
+    const integrated_response_t* response = job->response;
+    uint32_t bit = 1u << zone;
+    int rc = 0;
+    (void)stage;
+    
+    // 按隔离时使用的后端撤销，XDP 挂接前后隔离的区域可能并存
+    xdp_sync_zones(ctx);
+    if (atomic_load(&ctx->active.isolated) & bit) {
+        if (atomic_load(&ctx->active.isolated_xdp) & bit) {
+            // 只释放本站点持有的引用，其他站点隔离的同一前缀保持不变
+            rc = re_xdp_release_prefix(0x0A000000u | ((uint32_t)zone << 8), 24) == RESPONSE_SUCCESS ? 0 : -1;
+        } else {
+            char command[128];
+            snprintf(command, sizeof(command),
+                    "iptables -w -D %s -s 10.0.%d.0/24 -j DROP", ctx->chain, zone);
+            if (system(command) != 0) {
+                // 删除失败时确认规则是否仍在，已不存在即视为已恢复
+                snprintf(command, sizeof(command),
+                        "iptables -w -C %s -s 10.0.%d.0/24 -j DROP 2>/dev/null", ctx->chain, zone);
+                rc = system(command) == 0 ? -1 : 0;
+            }
+        }
+        if (rc == 0) {
+            atomic_fetch_and(&ctx->active.isolated, ~bit);
+            atomic_fetch_and(&ctx->active.isolated_xdp, ~bit);
+        }
+    }
+    re_evlog_emit(rc == 0 ? RE_EV_STEP_OK : RE_EV_STEP_FAIL, RE_SUB_RECOVERY, response->timestamp, bit, rc, "network");
+    return rc;
 }
 
-static int execute_recovery_sequence(const integrated_response_t* response) {
+static int recover_access_zone(re_recovery_stage_t stage, int zone, void* user) {
+    const recovery_job_t* job = user;
+    re_ctx_t* ctx = job->ctx;
+    const integrated_response_t* response = job->response;
+    uint32_t bit = 1u << zone;
+    int rc = 0;
+    (void)stage;
+    
+    // 并发的单区域命令由执行器合并为批次下发
+    if ((atomic_load(&ctx->active.locked) | atomic_load(&ctx->active.evacuating)) & bit) {
+        rc = re_actuator_command(RE_ACT_DOOR_RESTORE, bit) == RESPONSE_SUCCESS ? 0 : -1;
+    }
+    if (rc == 0) {
+        atomic_fetch_and(&ctx->active.locked, ~bit);
+        atomic_fetch_and(&ctx->active.evacuating, ~bit);
+        atomic_fetch_and(&ctx->active.surveillance, ~bit);
+    }
+    re_evlog_emit(rc == 0 ? RE_EV_STEP_OK : RE_EV_STEP_FAIL, RE_SUB_RECOVERY, response->timestamp, bit, rc, "access");
+    return rc;
+}
+
+static int recover_service_zone(re_recovery_stage_t stage, int zone, void* user) {
+    const recovery_job_t* job = user;
+    re_ctx_t* ctx = job->ctx;
+    const integrated_response_t* response = job->response;
+    uint32_t bit = 1u << zone;
+    (void)stage;
+    
+    // 被冻结的服务直接解冻，进程状态保留在内存中
+    // 服务注册表为进程级，只解冻本站点控制过的区域
+    int rc = 0;
+    if (atomic_load(&ctx->active.contained) & bit) {
+        rc = re_service_release(bit) == RESPONSE_SUCCESS ? 0 : -1;
+    }
+    if (rc == 0) {
+        atomic_fetch_and(&ctx->active.contained, ~bit);
+        atomic_fetch_and(&ctx->active.services_stopped, ~bit);
+    }
+    re_evlog_emit(rc == 0 ? RE_EV_STEP_OK : RE_EV_STEP_FAIL, RE_SUB_RECOVERY, response->timestamp, bit, rc, "services");
+    return rc;
+}
+
+static uint32_t affected_zones(re_ctx_t* ctx) {
+    return atomic_load(&ctx->active.locked) |
+           atomic_load(&ctx->active.isolated) |
+           atomic_load(&ctx->active.services_stopped) |
+           atomic_load(&ctx->active.surveillance) |
+           atomic_load(&ctx->active.evacuating) |
+           atomic_load(&ctx->active.contained);
+}
+
+// 各阶段耗时写入调用者提供的 timing，并发的恢复互不覆盖
+static int execute_recovery_sequence(re_ctx_t* ctx, const integrated_response_t* response,
+                                     re_recovery_timing_t* timing) {
     printf("[RECOVERY] 执行恢复序列\n");
-    return 0;
+    
+    // 目标为 0 的全区域恢复已在登记前展开
+    uint32_t target = response->target_zones;
+    uint32_t zones = target & affected_zones(ctx);
+    
+    // 通信优先级与主机隔离不按区域拆分，覆盖全部生效区域时整体撤销
+    // 二者为进程级资源，与撤销步骤一致只由默认上下文处理
+    bool process_wide = ctx == &default_ctx;
+    uint32_t comms = process_wide ? re_comms_active_zones() : 0;
+    if (comms && (comms & ~target) == 0) {
+        re_comms_clear();
+    }
+    if (process_wide && target == 0xFFFFFFFF) {
+        re_quarantine_flush();
+    }
+    
+    // 网络 -> 门禁 -> 服务，各阶段内按区域并行，以健康检查放行下一阶段
+    static const re_recovery_action_fn actions[RE_RECOVERY_STAGE_COUNT] = {
+        [RE_RECOVERY_NETWORK] = recover_network_zone,
+        [RE_RECOVERY_ACCESS] = recover_access_zone,
+        [RE_RECOVERY_SERVICES] = recover_service_zone,
+    };
+    recovery_job_t job = { .ctx = ctx, .response = response };
+    int32_t rc = re_recovery_run(zones, actions, &job, timing);
+    
+    // 切换到备份的关键服务最后回切
+    if (rc == RESPONSE_SUCCESS && process_wide && re_service_failback() != RESPONSE_SUCCESS) {
+        rc = RESPONSE_ERROR_HARDWARE_UNAVAILABLE;
+    }
+    return rc == RESPONSE_SUCCESS ? 0 : -1;
 }
 
 static bool check_hardware_readiness(void) {
@@ -92,22 +346,56 @@ static bool check_hardware_readiness(void) {
     return true;
 }
 
-static int init_network_subsystem(void) {
+static int init_hardware(void* user) {
+    (void)user;
+    return check_hardware_readiness() ? 0 : -1;
+}
+
+static int init_network_subsystem(void* user) {
+    (void)user;
     printf("[NETWORK] 初始化网络子系统\n");
     return 0;
 }
 
-static int init_access_control(void) {
+static int init_access_control(void* user) {
+    (void)user;
     printf("[ACCESS] 初始化门禁控制\n");
     return 0;
 }
 
+// 建立本站点的紧急规则链并挂入 FORWARD
+static int init_isolation_chain(void* user) {
+    re_ctx_t* ctx = user;
+    char command[192];
+    
+    snprintf(command, sizeof(command), "iptables -N %s", ctx->chain);
+    system(command);
+    
+    snprintf(command, sizeof(command), "iptables -F %s", ctx->chain);
+    system(command);
+    
+    // 应用紧急规则链
+    snprintf(command, sizeof(command),
+            "iptables -C FORWARD -j %s 2>/dev/null || iptables -I FORWARD -j %s",
+            ctx->chain, ctx->chain);
+    return system(command) == 0 ? 0 : -1;
+}
+
 static void restore_normal_access(void) {
     printf("[ACCESS] 恢复正常门禁状态\n");
+    re_actuator_command(RE_ACT_DOOR_RESTORE, 0xFFFFFFFF);
 }
 
-static void cleanup_network_rules(void) {
+static void cleanup_network_rules(re_ctx_t* ctx) {
     printf("[NETWORK] 清理网络规则\n");
+    
+    if (!re_init_ready(&ctx->init, INIT_ISOLATION_CHAIN)) return;
+    char command[192];
+    snprintf(command, sizeof(command),
+            "iptables -D FORWARD -j %s 2>/dev/null; iptables -F %s; iptables -X %s",
+            ctx->chain, ctx->chain, ctx->chain);
+    system(command);
+    re_init_reset(&ctx->init, INIT_ISOLATION_CHAIN);
 }
 
 static void stop_emergency_services(void) {
@@ -115,33 +403,150 @@ static void stop_emergency_services(void) {
 }
 
 // 添加缺失的线程函数声明
+typedef struct {
+    re_ctx_t* ctx;
+    integrated_response_t response;
+} emergency_job_t;
+
+// 注销一个紧急序列线程，关闭流程据此判断是否排空
+static void emergency_job_release(re_ctx_t* ctx) {
+    pthread_mutex_lock(&ctx->lock);
+    ctx->detached--;
+    pthread_cond_broadcast(&ctx->plan_done);
+    pthread_mutex_unlock(&ctx->lock);
+}
+
 static void* emergency_thread_wrapper(void* arg) {
-    integrated_response_t* response = (integrated_response_t*)arg;
-    re_execute_integrated(response);
+    emergency_job_t* job = (emergency_job_t*)arg;
+    re_ctx_execute(job->ctx, &job->response);
+    
+    re_ctx_t* ctx = job->ctx;
+    free(job);
+    emergency_job_release(ctx);
     return NULL;
 }
 
 // === 核心响应函数实现 ===
-static int32_t execute_lockdown_sequence(const integrated_response_t* response) {
+static void reset_active_zones(re_ctx_t* ctx) {
+    atomic_store(&ctx->active.locked, 0);
+    atomic_store(&ctx->active.isolated, 0);
+    atomic_store(&ctx->active.isolated_xdp, 0);
+    atomic_store(&ctx->active.services_stopped, 0);
+    atomic_store(&ctx->active.surveillance, 0);
+    atomic_store(&ctx->active.evacuating, 0);
+    atomic_store(&ctx->active.contained, 0);
+}
+
+// XDP 前缀映射被丢弃后，其中的隔离已失效，清除对应区域以便重新隔离
+static void xdp_sync_zones(re_ctx_t* ctx) {
+    uint32_t generation = re_xdp_generation();
+    if (atomic_exchange(&ctx->active.xdp_generation, generation) == generation) return;
+
+    uint32_t stale = atomic_exchange(&ctx->active.isolated_xdp, 0);
+    if (stale) {
+        atomic_fetch_and(&ctx->active.isolated, ~stale);
+        printf("[NETWORK] XDP 前缀映射已更换，区域 0x%08X 的隔离已失效\n", stale);
+    }
+}
+
+// 计算尚未生效的区域，已生效区域直接复用
+static uint32_t zones_delta(uint32_t target, uint32_t active, const char* what) {
+    uint32_t delta = target & ~active;
+    if ((target & active) != 0) {
+        printf("[DIFF] %s 已生效区域: 0x%08X，仅处理新增区域: 0x%08X\n", what, target & active, delta);
+    }
+    return delta;
+}
+
+// 为区域安装隔离规则，只有规则已生效的区域计入 isolated
+static int isolate_zones(re_ctx_t* ctx, uint32_t zones, uint64_t timestamp) {
+    char command[256];
+    int result = 0;
+    
+    // XDP 后端已挂接时只需向 LPM 映射插入前缀，报文在驱动层被丢弃
+    if (re_xdp_active()) {
+        for (int i = 0; i < 32; i++) {
+            if (zones & (1u << i)) {
+                if (re_xdp_isolate_prefix(0x0A000000u | ((uint32_t)i << 8), 24) != RESPONSE_SUCCESS) {
+                    result = -1;
+                    printf("[NETWORK] 区域 %d 隔离失败\n", i);
+                    re_evlog_emit(RE_EV_STEP_FAIL, RE_SUB_NETWORK, timestamp, 1u << i, -1, "xdp");
+                } else {
+                    if (atomic_fetch_or(&ctx->active.isolated_xdp, 1u << i) & (1u << i)) {
+                        // 并发执行已为本站点隔离该区域，只保留一份引用
+                        re_xdp_release_prefix(0x0A000000u | ((uint32_t)i << 8), 24);
+                    }
+                    atomic_fetch_or(&ctx->active.isolated, 1u << i);
+                    re_evlog_emit(RE_EV_STEP_OK, RE_SUB_NETWORK, timestamp, 1u << i, 0, "xdp");
+                }
+            }
+        }
+        printf("[NETWORK] 网络隔离完成（XDP）\n");
+        return result;
+    }
+    
+    // 首次隔离时建立紧急规则链，之后只追加新增区域的规则
+    if (re_init_ensure(&ctx->init, INIT_ISOLATION_CHAIN) != RESPONSE_SUCCESS) {
+        printf("[NETWORK] 紧急规则链建立失败\n");
+        re_evlog_emit(RE_EV_STEP_FAIL, RE_SUB_NETWORK, timestamp, zones, -1, "iptables");
+        return -1;
+    }
+    
+    // 已预先渲染规则时一次提交全部新增区域
+    if (stage_commit_isolation(ctx, zones)) {
+        atomic_fetch_or(&ctx->active.isolated, zones);
+        re_evlog_emit(RE_EV_STEP_OK, RE_SUB_NETWORK, timestamp, zones, 0, "iptables-restore");
+        printf("[NETWORK] 网络隔离完成（预备规则）\n");
+        return 0;
+    }
+    
+    // 根据新增区域设置隔离规则
+    for (int i = 0; i < 32; i++) {
+        if (zones & (1u << i)) {
+            snprintf(command, sizeof(command),
+                    "iptables -A %s -s 10.0.%d.0/24 -j DROP", ctx->chain, i);
+            if (system(command) != 0) {
+                result = -1;
+                printf("[NETWORK] 区域 %d 隔离失败\n", i);
+                re_evlog_emit(RE_EV_STEP_FAIL, RE_SUB_NETWORK, timestamp, 1u << i, -1, "iptables");
+            } else {
+                atomic_fetch_or(&ctx->active.isolated, 1u << i);
+                re_evlog_emit(RE_EV_STEP_OK, RE_SUB_NETWORK, timestamp, 1u << i, 0, "iptables");
+            }
+        }
+    }
+    
+    return result;
+}
+
+static int32_t execute_lockdown_sequence(re_ctx_t* ctx, const integrated_response_t* response) {
     printf("[RESPONSE] 执行全面封锁序列，严重级别: %d\n", response->severity);
     
     int32_t result = 0;
     uint32_t success_ops = 0;
     uint32_t total_ops = 0;
+    uint32_t zones;
     
     // 1. 门禁系统锁定
     total_ops++;
-    if (lockdown_physical_access(response->target_zones, response->duration) == 0) {
+    zones = zones_delta(response->target_zones, ctx->active.locked, "门禁锁定");
+    if (zones == 0 || lockdown_physical_access(zones, response->duration) == 0) {
         success_ops++;
+        atomic_fetch_or(&ctx->active.locked, zones);
+        atomic_fetch_and(&ctx->active.evacuating, ~zones);
         printf("[DOOR] 物理门禁锁定成功，区域: 0x%08X\n", response->target_zones);
+        re_evlog_emit(RE_EV_STEP_OK, RE_SUB_ACCESS, response->timestamp, zones, 0, "lockdown");
     } else {
         result = -1;
         printf("[DOOR] 物理门禁锁定失败\n");
+        re_evlog_emit(RE_EV_STEP_FAIL, RE_SUB_ACCESS, response->timestamp, zones, -1, "lockdown");
     }
     
-    // 2. 网络隔离
+    // 2. 网络隔离，与单独的网络隔离响应安装同样的规则
     total_ops++;
-    if (isolate_network_segments(response->target_zones, response->severity) == 0) {
+    xdp_sync_zones(ctx);
+    zones = zones_delta(response->target_zones, ctx->active.isolated, "网络隔离");
+    if (zones == 0 || isolate_zones(ctx, zones, response->timestamp) == 0) {
         success_ops++;
         printf("[NETWORK] 网络隔离成功\n");
     } else {
@@ -151,54 +556,43 @@ static int32_t execute_lockdown_sequence(const integrated_response_t* response)
     
     // 3. 非核心服务停止
     total_ops++;
-    if (stop_non_critical_services(response->target_zones) == 0) {
+    zones = zones_delta(response->target_zones, ctx->active.services_stopped, "服务停止");
+    if (zones == 0 || stop_non_critical_services(zones) == 0) {
         success_ops++;
+        atomic_fetch_or(&ctx->active.services_stopped, zones);
         printf("[SERVICE] 非核心服务停止成功\n");
+        re_evlog_emit(RE_EV_STEP_OK, RE_SUB_SERVICE, response->timestamp, zones, 0, "stop_non_critical");
     } else {
         result = -3;
         printf("[SERVICE] 服务停止失败\n");
+        re_evlog_emit(RE_EV_STEP_FAIL, RE_SUB_SERVICE, response->timestamp, zones, -3, "stop_non_critical");
     }
     
     // 4. 监控系统强化
     total_ops++;
-    if (enhance_surveillance(response->target_zones) == 0) {
+    zones = zones_delta(response->target_zones, ctx->active.surveillance, "监控强化");
+    if (zones == 0 || enhance_surveillance(zones) == 0) {
         success_ops++;
+        atomic_fetch_or(&ctx->active.surveillance, zones);
         printf("[SURVEILLANCE] 监控强化成功\n");
+        re_evlog_emit(RE_EV_STEP_OK, RE_SUB_SURVEILLANCE, response->timestamp, zones, 0, "enhance");
     }
     
     printf("[RESPONSE] 封锁序列完成: %d/%d 操作成功\n", success_ops, total_ops);
     return result;
 }
 
-static int32_t execute_network_isolation(const integrated_response_t* response) {
+static int32_t execute_network_isolation(re_ctx_t* ctx, const integrated_response_t* response) {
     printf("[RESPONSE] 执行网络隔离，目标区域: 0x%08X\n", response->target_zones);
     
-    // 集成网络隔离操作
-    char command[256];
-    int32_t result = 0;
-    
-    // 防火墙规则更新
-    snprintf(command, sizeof(command), "iptables -F CASSIE_EMERGENCY");
-    system(command);
-    
-    snprintf(command, sizeof(command), "iptables -N CASSIE_EMERGENCY");
-    system(command);
-    
-    // 根据目标区域设置隔离规则
-    for (int i = 0; i < 32; i++) {
-        if (response->target_zones & (1 << i)) {
-            snprintf(command, sizeof(command),
-                    "iptables -A CASSIE_EMERGENCY -s 10.0.%d.0/24 -j DROP", i);
-            if (system(command) != 0) {
-                result = -1;
-                printf("[NETWORK] 区域 %d 隔离失败\n", i);
-            }
-        }
+    xdp_sync_zones(ctx);
+    uint32_t zones = zones_delta(response->target_zones, ctx->active.isolated, "网络隔离");
+    if (zones == 0) {
+        printf("[RESPONSE] 网络隔离完成（无新增区域）\n");
+        return 0;
     }
     
-    // 应用紧急规则链
-    system("iptables -I FORWARD -j CASSIE_EMERGENCY");
-    
+    int32_t result = isolate_zones(ctx, zones, response->timestamp);
     printf("[RESPONSE] 网络隔离完成\n");
     return result;
 }
@@ -213,129 +607,815 @@ static int32_t execute_service_failover(const integrated_response_t* response) {
     int32_t result = 0;
     
     for (int i = 0; critical_services[i] != NULL; i++) {
-        char stop_cmd[128];
-        snprintf(stop_cmd, sizeof(stop_cmd), "systemctl stop %s", critical_services[i]);
-        
-        if (system(stop_cmd) == 0) {
-            printf("[SERVICE] 主服务 %s 已停止\n", critical_services[i]);
+        // 切换方式由服务注册表决定：热备/温备只翻转流量与冻结状态，冷备重启服务
+        if (re_service_failover(critical_services[i]) == RESPONSE_SUCCESS) {
+            re_evlog_emit(RE_EV_STEP_OK, RE_SUB_SERVICE, response->timestamp, response->target_zones, 0, critical_services[i]);
         } else {
-            printf("[SERVICE] 主服务 %s 停止失败\n", critical_services[i]);
+            re_evlog_emit(RE_EV_STEP_FAIL, RE_SUB_SERVICE, response->timestamp, response->target_zones, -1, critical_services[i]);
             result = -1;
         }
-        
-        char start_cmd[128];
-        snprintf(start_cmd, sizeof(start_cmd), "systemctl start %s-backup", critical_services[i]);
-        
-        if (system(start_cmd) == 0) {
-            printf("[SERVICE] 备份服务 %s 已启动\n", critical_services[i]);
-        } else {
-            printf("[SERVICE] 备份服务 %s 启动失败\n", critical_services[i]);
-            result = -2;
-        }
-        
-        usleep(500000); // 500ms延迟
     }
     
     return result;
 }
 
-static int32_t execute_evacuation_protocol(const integrated_response_t* response) {
+static int32_t execute_evacuation_protocol(re_ctx_t* ctx, const integrated_response_t* response) {
     printf("[RESPONSE] 执行紧急疏散协议\n");
     
     int32_t result = 0;
+    uint32_t zones = zones_delta(response->target_zones, ctx->active.evacuating, "疏散");
+    
+    if (zones == 0) {
+        printf("[EVACUATION] 疏散协议执行完成（无新增区域）\n");
+        return 0;
+    }
     
-    if (unlock_evacuation_routes(response->target_zones) != 0) {
+    if (unlock_evacuation_routes(zones) != 0) {
         result = -1;
         printf("[EVACUATION] 疏散路线解锁失败\n");
+        re_evlog_emit(RE_EV_STEP_FAIL, RE_SUB_EVACUATION, response->timestamp, zones, -1, "unlock_routes");
+    } else {
+        atomic_fetch_or(&ctx->active.evacuating, zones);
+        atomic_fetch_and(&ctx->active.locked, ~zones);
+        re_evlog_emit(RE_EV_STEP_OK, RE_SUB_EVACUATION, response->timestamp, zones, 0, "unlock_routes");
     }
     
-    activate_evacuation_lights(response->target_zones);
-    power_down_non_essential(response->target_zones);
+    activate_evacuation_lights(zones);
+    power_down_non_essential(zones);
     enable_emergency_comms();
     
     printf("[EVACUATION] 疏散协议执行完成\n");
     return result;
 }
 
+// === 升级预备 ===
+// 进入强化警戒后，后台预先完成升级时最慢且不影响现状的准备：建立空的
+// 紧急规则链并渲染各区域规则，打开控制器会话，解冻温备实例。升级时
+// 直接提交；恢复正常或关闭时撤销，规则链为空不影响流量，保留到关闭。
+enum {
+    STAGE_NONE = 0,
+    STAGE_BUSY,                       // 预备线程运行中
+    STAGE_CANCELLED,                  // 已要求撤销，等待预备线程或撤销完成
+    STAGE_READY
+};
+
+static uint64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+// 控制器与服务注册表为进程级资源，只由默认上下文预备
+static void stage_undo(re_ctx_t* ctx) {
+    if (ctx != &default_ctx) return;
+    re_actuator_prepare(false);
+    re_service_prewarm(false);
+}
+
+static void* stage_worker(void* arg) {
+    re_ctx_t* ctx = arg;
+    uint64_t start = monotonic_ms();
+    
+    if (!re_xdp_active() && re_init_ensure(&ctx->init, INIT_ISOLATION_CHAIN) == RESPONSE_SUCCESS) {
+        for (int i = 0; i < 32; i++) {
+            snprintf(ctx->stage.rules[i], sizeof(ctx->stage.rules[i]),
+                    "-A %s -s 10.0.%d.0/24 -j DROP\n", ctx->chain, i);
+        }
+    } else {
+        ctx->stage.rules[0][0] = '\0';
+    }
+    if (ctx == &default_ctx) {
+        re_actuator_prepare(true);
+        re_service_prewarm(true);
+    }
+    
+    pthread_mutex_lock(&ctx->lock);
+    bool cancelled = ctx->stage.state == STAGE_CANCELLED;
+    if (!cancelled) ctx->stage.state = STAGE_READY;
+    pthread_mutex_unlock(&ctx->lock);
+    
+    if (cancelled) {
+        stage_undo(ctx);
+        printf("[STAGE] 升级预备已撤销\n");
+    } else {
+        printf("[STAGE] 升级预备完成，耗时 %llums\n",
+               (unsigned long long)(monotonic_ms() - start));
+    }
+    
+    pthread_mutex_lock(&ctx->lock);
+    if (cancelled) ctx->stage.state = STAGE_NONE;
+    ctx->detached--;
+    pthread_cond_broadcast(&ctx->plan_done);
+    pthread_mutex_unlock(&ctx->lock);
+    return NULL;
+}
+
+// 调用者持有 ctx->lock
+static void stage_begin_locked(re_ctx_t* ctx) {
+    if (ctx->stage.state != STAGE_NONE || ctx->closing) return;
+    
+    pthread_t thread;
+    ctx->stage.state = STAGE_BUSY;
+    ctx->detached++;
+    if (pthread_create(&thread, NULL, stage_worker, ctx) != 0) {
+        ctx->stage.state = STAGE_NONE;
+        ctx->detached--;
+        return;
+    }
+    pthread_detach(thread);
+}
+
+static void stage_discard(re_ctx_t* ctx) {
+    pthread_mutex_lock(&ctx->lock);
+    uint8_t state = ctx->stage.state;
+    // 预备线程仍在运行时由它自行撤销
+    if (state == STAGE_BUSY || state == STAGE_READY) ctx->stage.state = STAGE_CANCELLED;
+    pthread_mutex_unlock(&ctx->lock);
+    if (state != STAGE_READY) return;
+    
+    stage_undo(ctx);
+    printf("[STAGE] 升级预备已撤销\n");
+    pthread_mutex_lock(&ctx->lock);
+    ctx->stage.state = STAGE_NONE;
+    pthread_mutex_unlock(&ctx->lock);
+}
+
+// 用预先渲染的规则一次性追加全部区域，iptables-restore 整体生效或整体失败
+static bool stage_commit_isolation(re_ctx_t* ctx, uint32_t zones) {
+    char batch[sizeof(ctx->stage.rules) + 32];
+    size_t len = 0;
+    
+    pthread_mutex_lock(&ctx->lock);
+    bool ready = ctx->stage.state == STAGE_READY && ctx->stage.rules[0][0];
+    if (ready) {
+        len = (size_t)snprintf(batch, sizeof(batch), "*filter\n");
+        for (int i = 0; i < 32; i++) {
+            if (zones & (1u << i)) {
+                size_t n = strlen(ctx->stage.rules[i]);
+                memcpy(batch + len, ctx->stage.rules[i], n);
+                len += n;
+            }
+        }
+        len += (size_t)snprintf(batch + len, sizeof(batch) - len, "COMMIT\n");
+    }
+    pthread_mutex_unlock(&ctx->lock);
+    if (!ready) return false;
+    
+    FILE* restore = popen("iptables-restore -w --noflush", "w");
+    if (!restore) return false;
+    bool ok = fwrite(batch, 1, len, restore) == len;
+    ok = pclose(restore) == 0 && ok;
+    if (!ok) printf("[NETWORK] 预备规则提交失败，逐条追加\n");
+    return ok;
+}
+
+// === 冲突检测与优先级消解 ===
+
+// 优先级：生命安全 > 封锁/隔离 > 服务类 > 恢复，同类按严重程度
+static uint32_t plan_priority(const integrated_response_t* response) {
+    uint32_t base;
+    switch (response->type) {
+        case RESPONSE_EVACUATION:       base = 100; break;
+        case RESPONSE_LOCKDOWN:         base = 80;  break;
+        case RESPONSE_NETWORK_ISOLATE:  base = 60;  break;
+        case RESPONSE_PARTIAL_CONTAIN:  base = 50;  break;
+        case RESPONSE_COMMS_PRIORITY:   base = 70;  break;
+        case RESPONSE_SERVICE_FAILOVER: base = 40;  break;
+        case RESPONSE_BACKUP_ACTIVATE:  base = 30;  break;
+        case RESPONSE_HEIGHTENED_SURVEILLANCE: base = 20; break;
+        case RESPONSE_FULL_RECOVERY:    base = 10;  break;
+        default:                        base = 0;   break;
+    }
+    return base * 16 + response->severity;
+}
+
+static void plan_build_claims(response_plan_t* plan, response_type_t type) {
+    memset(plan->claims, 0, sizeof(plan->claims));
+    
+#define CLAIM(res, act, z) do { plan->claims[res].action = (act); plan->claims[res].zones = (z); } while (0)
+    switch (type) {
+        case RESPONSE_LOCKDOWN:
+            CLAIM(RES_DOORS, ACT_LOCK, plan->zones);
+            CLAIM(RES_NETWORK, ACT_ISOLATE, plan->zones);
+            CLAIM(RES_SERVICES, ACT_STOP, plan->zones);
+            break;
+        case RESPONSE_NETWORK_ISOLATE:
+            CLAIM(RES_NETWORK, ACT_ISOLATE, plan->zones);
+            break;
+        case RESPONSE_SERVICE_FAILOVER:
+            CLAIM(RES_SERVICES, ACT_FAILOVER, 0xFFFFFFFF);
+            break;
+        case RESPONSE_EVACUATION:
+            CLAIM(RES_DOORS, ACT_UNLOCK, plan->zones);
+            CLAIM(RES_POWER, ACT_POWER_OFF, plan->zones);
+            break;
+        case RESPONSE_BACKUP_ACTIVATE:
+            CLAIM(RES_BACKUP, ACT_ACTIVATE, 0xFFFFFFFF);
+            break;
+        case RESPONSE_PARTIAL_CONTAIN:
+            CLAIM(RES_SERVICES, ACT_STOP, plan->zones);
+            break;
+        case RESPONSE_COMMS_PRIORITY:
+            CLAIM(RES_COMMS, ACT_PRIORITIZE, plan->zones);
+            break;
+        case RESPONSE_FULL_RECOVERY:
+            CLAIM(RES_DOORS, ACT_RESTORE, plan->zones);
+            CLAIM(RES_NETWORK, ACT_RESTORE, plan->zones);
+            CLAIM(RES_SERVICES, ACT_RESTORE, plan->zones);
+            CLAIM(RES_POWER, ACT_RESTORE, plan->zones);
+            CLAIM(RES_COMMS, ACT_RESTORE, plan->zones);
+            break;
+        default:
+            break;
+    }
+#undef CLAIM
+}
+
+// 返回两个计划存在矛盾动作的区域，0 表示可并行
+static uint32_t plan_conflict_zones(const response_plan_t* a, const response_plan_t* b) {
+    uint32_t conflict = 0;
+    for (int r = 0; r < RES_COUNT; r++) {
+        uint8_t act_a = a->claims[r].action;
+        uint8_t act_b = b->claims[r].action;
+        if (act_a == ACT_NONE || act_b == ACT_NONE) continue;
+        
+        bool exclusive = act_a == ACT_FAILOVER || act_a == ACT_ACTIVATE ||
+                         act_b == ACT_FAILOVER || act_b == ACT_ACTIVATE;
+        if (act_a != act_b || exclusive) {
+            conflict |= a->claims[r].zones & b->claims[r].zones;
+        }
+    }
+    return conflict;
+}
+
+/*
+ * 登记计划并按优先级消解冲突，调用者持有 ctx->lock。
+ * 仅与先登记的计划比较：优先级更高则等待其完成（后执行者的状态生效），
+ * 否则让出冲突区域。无冲突的计划不等待，可并行执行。
+ * 返回 false 表示全部区域均被更高优先级计划占用。
+ */
+static int32_t plan_admit_locked(re_ctx_t* ctx, response_plan_t* plan, const integrated_response_t* response) {
+    plan->seq = ++ctx->plan_seq;
+    plan->priority = plan_priority(response);
+    plan->zones = response->target_zones;
+    plan->next = NULL;
+    plan_build_claims(plan, response->type);
+    
+    response_plan_t** tail = &ctx->inflight;
+    while (*tail) tail = &(*tail)->next;
+    *tail = plan;
+    
+    for (;;) {
+        bool must_wait = false;
+        
+        for (response_plan_t* other = ctx->inflight; other && other->seq < plan->seq; other = other->next) {
+            uint32_t conflict = plan_conflict_zones(plan, other);
+            if (conflict == 0) continue;
+            
+            if (plan->priority > other->priority) {
+                must_wait = true;
+            } else {
+                printf("[CONFLICT] 区域 0x%08X 与更高优先级响应冲突，已让出\n", conflict);
+                plan->zones &= ~conflict;
+                plan_build_claims(plan, response->type);
+            }
+        }
+        
+        if (plan->zones == 0 && response->target_zones != 0) return RESPONSE_ERROR_CONFLICT;
+        if (!must_wait) return RESPONSE_SUCCESS;
+        // 关闭期间尚未开始的响应直接取消
+        if (ctx->closing) return RESPONSE_ERROR_SHUTDOWN;
+        
+        printf("[CONFLICT] 等待冲突的低优先级响应完成\n");
+        pthread_cond_wait(&ctx->plan_done, &ctx->lock);
+    }
+}
+
+static void plan_retire_locked(re_ctx_t* ctx, response_plan_t* plan) {
+    for (response_plan_t** it = &ctx->inflight; *it; it = &(*it)->next) {
+        if (*it == plan) {
+            *it = plan->next;
+            break;
+        }
+    }
+    pthread_cond_broadcast(&ctx->plan_done);
+}
+
+static int32_t execute_heightened_surveillance(re_ctx_t* ctx, const integrated_response_t* response) {
+    printf("[RESPONSE] 执行强化监控，目标区域: 0x%08X\n", response->target_zones);
+    
+    uint32_t zones = zones_delta(response->target_zones, ctx->active.surveillance, "监控强化");
+    if (zones == 0) {
+        return 0;
+    }
+    
+    int32_t result = enhance_surveillance(zones);
+    if (result == 0) {
+        atomic_fetch_or(&ctx->active.surveillance, zones);
+    }
+    re_evlog_emit(result == 0 ? RE_EV_STEP_OK : RE_EV_STEP_FAIL, RE_SUB_SURVEILLANCE,
+                  response->timestamp, zones, result, NULL);
+    return result;
+}
+
+static int32_t execute_comms_priority(const integrated_response_t* response) {
+    printf("[RESPONSE] 执行应急通信优先级，目标区域: 0x%08X\n", response->target_zones);
+    
+    int32_t result = re_comms_prioritize(response->target_zones);
+    if (result == RESPONSE_SUCCESS) {
+        re_evlog_emit(RE_EV_STEP_OK, RE_SUB_COMMS, response->timestamp, response->target_zones, 0, "tc_prio");
+    } else {
+        printf("[COMMS] 应急通信优先级配置失败\n");
+        re_evlog_emit(RE_EV_STEP_FAIL, RE_SUB_COMMS, response->timestamp, response->target_zones, result, "tc_prio");
+    }
+    return result;
+}
+
+// === 状态持久化 ===
+
+// 调用者持有 ctx->lock，保证日志按状态变化的先后写入
+static void ctx_persist_locked(re_ctx_t* ctx) {
+    if (!ctx->state) return;
+    
+    re_state_core_t core = {
+        .mode = (uint8_t)ctx->mode,
+        .emergency_level = ctx->current_level,
+        .flags = (ctx->emergency_mode ? RE_STATE_EMERGENCY : 0) |
+                 (re_init_ready(&ctx->init, INIT_ISOLATION_CHAIN) ? RE_STATE_CHAIN_INSTALLED : 0),
+        .locked = atomic_load(&ctx->active.locked),
+        .isolated = atomic_load(&ctx->active.isolated),
+        .services_stopped = atomic_load(&ctx->active.services_stopped),
+        .surveillance = atomic_load(&ctx->active.surveillance),
+        .evacuating = atomic_load(&ctx->active.evacuating),
+        .contained = atomic_load(&ctx->active.contained),
+    };
+    re_service_status_t services[RE_SERVICE_MAX];
+    int count = re_service_export(services, RE_SERVICE_MAX);
+    if (re_state_record(ctx->state, &core, services, count) != RESPONSE_SUCCESS) {
+        printf("[RESPONSE] 状态持久化失败\n");
+    }
+}
+
+static void ctx_restore(re_ctx_t* ctx, const re_state_image_t* image) {
+    const re_state_core_t* core = &image->core;
+    
+    ctx->mode = core->mode <= MODE_RECOVERY ? (system_mode_t)core->mode : MODE_NORMAL;
+    ctx->emergency_mode = core->flags & RE_STATE_EMERGENCY;
+    ctx->current_level = core->emergency_level;
+    atomic_store(&ctx->active.locked, core->locked);
+    // 快照不记录隔离后端，接管的隔离区域按 iptables 规则撤销
+    atomic_store(&ctx->active.isolated, core->isolated);
+    atomic_store(&ctx->active.services_stopped, core->services_stopped);
+    atomic_store(&ctx->active.surveillance, core->surveillance);
+    atomic_store(&ctx->active.evacuating, core->evacuating);
+    atomic_store(&ctx->active.contained, core->contained);
+    
+    // 规则链仍在内核中，不能重建（重建会清空已有隔离规则）
+    if (core->flags & RE_STATE_CHAIN_INSTALLED) {
+        re_init_mark_ready(&ctx->init, INIT_ISOLATION_CHAIN);
+    }
+    re_service_adopt(image->services, image->service_count);
+    
+    printf("[RESPONSE] 热重启恢复状态：模式 %d，紧急级别 %d，受影响区域 0x%08X\n",
+           ctx->mode, ctx->current_level, affected_zones(ctx));
+}
+
+// === 上下文管理 ===
+
+static bool ctx_name_valid(const char* name) {
+    size_t len = strlen(name);
+    if (len == 0 || len > RE_CTX_CHAIN_NAME_MAX) return false;
+    // 名称会拼入 iptables 命令，只允许安全字符
+    for (size_t i = 0; i < len; i++) {
+        char c = name[i];
+        if (!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '-')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int32_t ctx_init(re_ctx_t* ctx, const char* name) {
+    if (ctx->initialized) return 0;
+    
+    printf("[RESPONSE] 初始化集成响应系统...\n");
+    
+    if (name) {
+        snprintf(ctx->name, sizeof(ctx->name), "%s", name);
+        snprintf(ctx->chain, sizeof(ctx->chain), "CASSIE_%s", name);
+    } else {
+        snprintf(ctx->name, sizeof(ctx->name), "default");
+        snprintf(ctx->chain, sizeof(ctx->chain), "CASSIE_EMERGENCY");
+    }
+    
+    if (pthread_mutex_init(&ctx->lock, NULL) != 0) return -1;
+    // 关闭时按单调时钟计算排空期限
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    int cond_rc = pthread_cond_init(&ctx->plan_done, &attr);
+    pthread_condattr_destroy(&attr);
+    if (cond_rc != 0) {
+        pthread_mutex_destroy(&ctx->lock);
+        return -1;
+    }
+    if (re_init_graph_setup(&ctx->init, init_nodes, INIT_NODE_COUNT, ctx) != RESPONSE_SUCCESS) {
+        pthread_cond_destroy(&ctx->plan_done);
+        pthread_mutex_destroy(&ctx->lock);
+        return -1;
+    }
+    
+    // 按依赖图并行初始化，失败码与各子系统对应
+    uint32_t failed = re_init_run(&ctx->init);
+    int32_t rc = 0;
+    if (failed & (1u << INIT_HARDWARE)) {
+        printf("[RESPONSE] 硬件子系统检查失败\n");
+        rc = -2;
+    } else if (failed & (1u << INIT_NETWORK)) {
+        printf("[RESPONSE] 网络子系统初始化失败\n");
+        rc = -3;
+    } else if (failed & (1u << INIT_ACCESS)) {
+        printf("[RESPONSE] 门禁子系统初始化失败\n");
+        rc = -4;
+    }
+    if (rc != 0) {
+        re_init_graph_destroy(&ctx->init);
+        pthread_cond_destroy(&ctx->plan_done);
+        pthread_mutex_destroy(&ctx->lock);
+        return rc;
+    }
+    
+    ctx->emergency_mode = false;
+    ctx->current_level = 0;
+    ctx->mode = MODE_NORMAL;
+    ctx->closing = false;
+    
+    // 热重启：接管上次退出前生效的状态，不重新探测设备
+    re_state_image_t image;
+    ctx->state = re_state_open(ctx->name, &image);
+    if (ctx->state && image.seq) {
+        ctx_restore(ctx, &image);
+    }
+    ctx->initialized = true;
+    
+    re_evlog_emit(RE_EV_INIT, RE_SUB_CORE, 0, 0, 0, ctx->name);
+    printf("[RESPONSE] 集成响应系统初始化完成（站点: %s）\n", ctx->name);
+    return 0;
+}
+
+/*
+ * 停止接收新响应并排空在途工作。等待冲突的响应被取消；已开始执行的
+ * 响应不中断，等其完整执行完毕，避免留下执行一半的状态。
+ * deadline_ms 为 0 时不设期限。超时返回 -1，上下文保持关闭状态。
+ */
+static int ctx_drain(re_ctx_t* ctx, uint32_t deadline_ms) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += deadline_ms / 1000;
+    deadline.tv_nsec += (long)(deadline_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    
+    int rc = 0;
+    pthread_mutex_lock(&ctx->lock);
+    ctx->closing = true;
+    pthread_cond_broadcast(&ctx->plan_done);
+    while (ctx->inflight || ctx->detached) {
+        if (deadline_ms == 0) {
+            pthread_cond_wait(&ctx->plan_done, &ctx->lock);
+        } else if (pthread_cond_timedwait(&ctx->plan_done, &ctx->lock, &deadline) == ETIMEDOUT) {
+            rc = -1;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&ctx->lock);
+    return rc;
+}
+
+// === 并行撤销 ===
+
+static void teardown_access(re_ctx_t* ctx) {
+    if (ctx == &default_ctx) {
+        restore_normal_access();
+        return;
+    }
+    // 命名站点只恢复自己锁定或疏散的区域
+    uint32_t doors = atomic_load(&ctx->active.locked) | atomic_load(&ctx->active.evacuating);
+    if (doors) {
+        re_actuator_command(RE_ACT_DOOR_RESTORE, doors);
+    }
+}
+
+static void teardown_firewall(re_ctx_t* ctx) {
+    cleanup_network_rules(ctx);
+
+    // 归还本站点持有的 XDP 前缀引用
+    xdp_sync_zones(ctx);
+    uint32_t zones = atomic_exchange(&ctx->active.isolated_xdp, 0);
+    for (int i = 0; i < 32; i++) {
+        if (zones & (1u << i)) re_xdp_release_prefix(0x0A000000u | ((uint32_t)i << 8), 24);
+    }
+}
+
+static void teardown_xdp(re_ctx_t* ctx) {
+    (void)ctx;
+    re_xdp_detach(true);
+}
+
+static void teardown_quarantine(re_ctx_t* ctx) {
+    (void)ctx;
+    re_quarantine_flush();
+}
+
+static void teardown_comms(re_ctx_t* ctx) {
+    (void)ctx;
+    re_comms_clear();
+}
+
+static void teardown_services(re_ctx_t* ctx) {
+    (void)ctx;
+    re_service_release(0xFFFFFFFF);
+    re_service_failback();
+    stop_emergency_services();
+}
+
+typedef struct {
+    void (*run)(re_ctx_t* ctx);
+    bool process_wide;                // 进程级资源，只由默认上下文撤销
+} teardown_step_t;
+
+static const teardown_step_t teardown_steps[] = {
+    { teardown_access,     false },
+    { teardown_firewall,   false },
+    { teardown_xdp,        true },
+    { teardown_quarantine, true },
+    { teardown_comms,      true },
+    { teardown_services,   true },
+};
+
+#define TEARDOWN_STEP_COUNT (sizeof(teardown_steps) / sizeof(teardown_steps[0]))
+
+typedef struct {
+    re_ctx_t* ctx;
+    const teardown_step_t* step;
+} teardown_job_t;
+
+static void* teardown_worker(void* arg) {
+    teardown_job_t* job = arg;
+    job->step->run(job->ctx);
+    return NULL;
+}
+
+// 各子系统互不依赖，同时撤销
+static void ctx_teardown(re_ctx_t* ctx) {
+    teardown_job_t jobs[TEARDOWN_STEP_COUNT];
+    pthread_t threads[TEARDOWN_STEP_COUNT];
+    bool started[TEARDOWN_STEP_COUNT] = {false};
+    
+    stage_discard(ctx);
+    for (size_t i = 0; i < TEARDOWN_STEP_COUNT; i++) {
+        if (teardown_steps[i].process_wide && ctx != &default_ctx) continue;
+        jobs[i] = (teardown_job_t){ .ctx = ctx, .step = &teardown_steps[i] };
+        started[i] = pthread_create(&threads[i], NULL, teardown_worker, &jobs[i]) == 0;
+        if (!started[i]) teardown_steps[i].run(ctx);
+    }
+    for (size_t i = 0; i < TEARDOWN_STEP_COUNT; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+    }
+}
+
+// 排空后释放同步原语
+static void ctx_release(re_ctx_t* ctx) {
+    pthread_mutex_lock(&ctx->lock);
+    
+    // 资源已全部撤销，落盘干净状态后再关闭
+    reset_active_zones(ctx);
+    ctx->mode = MODE_NORMAL;
+    ctx->emergency_mode = false;
+    ctx->current_level = 0;
+    ctx_persist_locked(ctx);
+    pthread_mutex_unlock(&ctx->lock);
+    
+    re_state_close(ctx->state);
+    ctx->state = NULL;
+    re_init_graph_destroy(&ctx->init);
+    pthread_cond_destroy(&ctx->plan_done);
+    pthread_mutex_destroy(&ctx->lock);
+    ctx->initialized = false;
+}
+
 // === 公开API实现 ===
 
-int32_t re_execute_integrated(const integrated_response_t* response) {
-    if (!response || !subsystem_state.initialized) {
+re_ctx_t* re_ctx_create(const char* site_name) {
+    if (!site_name || !ctx_name_valid(site_name)) return NULL;
+    
+    re_ctx_t* ctx = calloc(1, sizeof(*ctx));
+    if (!ctx) return NULL;
+    if (ctx_init(ctx, site_name) != 0) {
+        free(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+void re_ctx_destroy(re_ctx_t* ctx) {
+    if (!ctx || ctx == &default_ctx) return;
+    
+    if (ctx->initialized) {
+        // 只撤销本站点生效的状态，进程级设备注册表保持不变
+        ctx_drain(ctx, 0);
+        ctx_teardown(ctx);
+        ctx_release(ctx);
+        re_evlog_emit(RE_EV_SHUTDOWN, RE_SUB_CORE, 0, 0, 0, ctx->name);
+    }
+    free(ctx);
+}
+
+int32_t re_ctx_execute(re_ctx_t* ctx, const integrated_response_t* response) {
+    if (!ctx || !response || !ctx->initialized) {
         return -1;
     }
     
-    pthread_mutex_lock(&subsystem_state.lock);
+    // 恢复响应的目标 0 表示全部区域，登记与执行使用同一范围
+    integrated_response_t normalized;
+    if (response->type == RESPONSE_FULL_RECOVERY && response->target_zones == 0) {
+        normalized = *response;
+        normalized.target_zones = 0xFFFFFFFF;
+        response = &normalized;
+    }
+    
+    // 登记计划，只与存在矛盾动作的在途计划串行
+    response_plan_t plan;
+    pthread_mutex_lock(&ctx->lock);
+    if (ctx->closing) {
+        pthread_mutex_unlock(&ctx->lock);
+        printf("[RESPONSE] 系统正在关闭，拒绝响应 %llu\n", (unsigned long long)response->timestamp);
+        return RESPONSE_ERROR_SHUTDOWN;
+    }
+    int32_t admitted = plan_admit_locked(ctx, &plan, response);
+    if (admitted != RESPONSE_SUCCESS) {
+        plan_retire_locked(ctx, &plan);
+        pthread_mutex_unlock(&ctx->lock);
+        if (admitted == RESPONSE_ERROR_CONFLICT) {
+            printf("[CONFLICT] 响应 %llu 的目标区域均被更高优先级响应占用，未执行\n",
+                   (unsigned long long)response->timestamp);
+        } else {
+            printf("[RESPONSE] 系统正在关闭，取消等待中的响应 %llu\n",
+                   (unsigned long long)response->timestamp);
+        }
+        re_evlog_emit(RE_EV_RESPONSE_END, RE_SUB_CORE, response->timestamp, response->target_zones,
+                      admitted, admitted == RESPONSE_ERROR_CONFLICT ? "superseded" : "cancelled");
+        return admitted;
+    }
+    pthread_mutex_unlock(&ctx->lock);
+    
+    integrated_response_t effective = *response;
+    effective.target_zones = plan.zones;
+    response = &effective;
     
     // 初始化执行报告
-    memset(&subsystem_state.last_report, 0, sizeof(execution_report_t));
-    subsystem_state.last_report.response_id = response->timestamp;
-    subsystem_state.last_report.start_time = time(NULL);
+    execution_report_t report;
+    memset(&report, 0, sizeof(execution_report_t));
+    report.response_id = response->timestamp;
+    report.start_time = time(NULL);
     
     printf("\n=== CASSIE 实时响应执行 ===\n");
     printf("事件: %s\n", response->trigger_event);
     printf("类型: %d, 严重程度: %d\n", response->type, response->severity);
     printf("目标区域: 0x%08X\n", response->target_zones);
-    printf("时间: %llu\n", response->timestamp);
+    printf("时间: %llu\n", (unsigned long long)response->timestamp);
+    re_evlog_emit(RE_EV_RESPONSE_BEGIN, RE_SUB_CORE, response->timestamp, response->target_zones,
+                  response->type, response->trigger_event);
     
     int32_t result = 0;
     
     // 根据响应类型执行集成操作序列
     switch (response->type) {
         case RESPONSE_LOCKDOWN:
-            result = execute_lockdown_sequence(response);
-            strcpy(subsystem_state.last_report.status_summary, "全面封锁序列执行完成");
+            result = execute_lockdown_sequence(ctx, response);
+            strcpy(report.status_summary, "全面封锁序列执行完成");
             break;
         case RESPONSE_NETWORK_ISOLATE:
-            result = execute_network_isolation(response);
-            strcpy(subsystem_state.last_report.status_summary, "网络隔离执行完成");
+            result = execute_network_isolation(ctx, response);
+            strcpy(report.status_summary, "网络隔离执行完成");
             break;
         case RESPONSE_SERVICE_FAILOVER:
             result = execute_service_failover(response);
-            strcpy(subsystem_state.last_report.status_summary, "服务切换执行完成");
+            strcpy(report.status_summary, "服务切换执行完成");
             break;
         case RESPONSE_EVACUATION:
-            result = execute_evacuation_protocol(response);
-            strcpy(subsystem_state.last_report.status_summary, "紧急疏散协议执行完成");
+            result = execute_evacuation_protocol(ctx, response);
+            strcpy(report.status_summary, "紧急疏散协议执行完成");
             break;
         case RESPONSE_BACKUP_ACTIVATE:
             result = activate_emergency_backups(response->severity);
-            strcpy(subsystem_state.last_report.status_summary, "紧急备份激活完成");
+            strcpy(report.status_summary, "紧急备份激活完成");
+            break;
+        case RESPONSE_COMMS_PRIORITY:
+            result = execute_comms_priority(response);
+            strcpy(report.status_summary, "应急通信优先级配置完成");
             break;
         case RESPONSE_PARTIAL_CONTAIN:
-            result = execute_partial_containment(response);
-            strcpy(subsystem_state.last_report.status_summary, "局部控制措施执行完成");
+            result = execute_partial_containment(ctx, response);
+            strcpy(report.status_summary, "局部控制措施执行完成");
             break;
-        case RESPONSE_FULL_RECOVERY:
-            result = execute_recovery_sequence(response);
-            strcpy(subsystem_state.last_report.status_summary, "全面恢复序列执行完成");
+        case RESPONSE_FULL_RECOVERY: {
+            re_recovery_timing_t timing = {0};
+            pthread_mutex_lock(&ctx->lock);
+            ctx->mode = MODE_RECOVERY;
+            pthread_mutex_unlock(&ctx->lock);
+            result = execute_recovery_sequence(ctx, response, &timing);
+            if (result == 0 && affected_zones(ctx) == 0) {
+                // 所有区域已恢复，解除紧急状态
+                pthread_mutex_lock(&ctx->lock);
+                ctx->mode = MODE_NORMAL;
+                ctx->emergency_mode = false;
+                ctx->current_level = 0;
+                pthread_mutex_unlock(&ctx->lock);
+                stage_discard(ctx);
+            }
+            snprintf(report.status_summary, sizeof(report.status_summary),
+                    "全面恢复序列执行完成（网络 %llums，门禁 %llums，服务 %llums）",
+                    (unsigned long long)timing.stage_ms[RE_RECOVERY_NETWORK],
+                    (unsigned long long)timing.stage_ms[RE_RECOVERY_ACCESS],
+                    (unsigned long long)timing.stage_ms[RE_RECOVERY_SERVICES]);
+            break;
+        }
+        case RESPONSE_HEIGHTENED_SURVEILLANCE:
+            result = execute_heightened_surveillance(ctx, response);
+            strcpy(report.status_summary, "强化监控执行完成");
             break;
         default:
             result = -99;
-            strcpy(subsystem_state.last_report.status_summary, "未知响应类型");
+            strcpy(report.status_summary, "未知响应类型");
     }
     
     // 更新执行报告
-    subsystem_state.last_report.end_time = time(NULL);
-    subsystem_state.last_report.overall_result = result;
-    subsystem_state.last_report.sub_operations = 4;
+    report.end_time = time(NULL);
+    report.overall_result = result;
+    report.sub_operations = 4;
     
     printf("=== 响应执行完成，结果: %d ===\n\n", result);
+    re_evlog_emit(RE_EV_RESPONSE_END, RE_SUB_CORE, response->timestamp, response->target_zones, result, NULL);
     
-    pthread_mutex_unlock(&subsystem_state.lock);
+    pthread_mutex_lock(&ctx->lock);
+    report.system_mode = ctx->mode;
+    ctx->last_report = report;
+    ctx_persist_locked(ctx);
+    plan_retire_locked(ctx, &plan);
+    pthread_mutex_unlock(&ctx->lock);
     return result;
 }
 
-void re_emergency_sequence(uint8_t emergency_level) {
+void re_ctx_emergency_sequence(re_ctx_t* ctx, uint8_t emergency_level) {
     printf("[EMERGENCY] 执行紧急序列，级别: %d\n", emergency_level);
     
-    subsystem_state.emergency_mode = true;
-    subsystem_state.current_level = emergency_level;
+    if (!ctx || !ctx->initialized) return;
+    if (emergency_level == 0) return;
+    if (emergency_level > 10) emergency_level = 10;
     
-    integrated_response_t emergency_response = {
-        .type = RESPONSE_LOCKDOWN,
-        .severity = 10,
+    const emergency_tier_t* tier = &emergency_tiers[level_tier[emergency_level]];
+    
+    pthread_mutex_lock(&ctx->lock);
+    if (ctx->closing) {
+        pthread_mutex_unlock(&ctx->lock);
+        printf("[EMERGENCY] 系统正在关闭，忽略紧急序列\n");
+        return;
+    }
+    uint8_t previous = ctx->emergency_mode ? ctx->current_level : 0;
+    bool escalate = previous == 0 || level_tier[emergency_level] > level_tier[previous];
+    ctx->emergency_mode = true;
+    if (emergency_level > previous) ctx->current_level = emergency_level;
+    if (escalate) ctx->mode = tier->mode;
+    // 强化警戒时后台预备下一层级，升级时只需提交
+    if (escalate && tier->mode == MODE_HEIGHTENED_SECURITY) stage_begin_locked(ctx);
+    // 与关闭检查在同一临界区内登记执行线程，关闭流程会等待它结束
+    if (escalate) ctx->detached++;
+    ctx_persist_locked(ctx);
+    pthread_mutex_unlock(&ctx->lock);
+    
+    re_evlog_emit(RE_EV_EMERGENCY, RE_SUB_CORE, 0, 0xFFFFFFFF, emergency_level, tier->name);
+    
+    if (!escalate) {
+        printf("[EMERGENCY] 当前级别 %d 的响应已覆盖级别 %d，不再重复执行\n", previous, emergency_level);
+        return;
+    }
+    printf("[EMERGENCY] 响应层级: %s\n", tier->name);
+    
+    // 响应参数交给执行线程持有，由线程释放
+    emergency_job_t* job = malloc(sizeof(*job));
+    if (!job) {
+        emergency_job_release(ctx);
+        return;
+    }
+    job->ctx = ctx;
+    job->response = (integrated_response_t){
+        .type = tier->type,
+        .severity = emergency_level,
         .target_zones = 0xFFFFFFFF,
-        .duration = 3600,
+        .duration = tier->duration,
         .auth_level = 5,
         .trigger_event = "手动紧急触发",
         .timestamp = (uint64_t)time(NULL)
@@ -343,55 +1423,109 @@ void re_emergency_sequence(uint8_t emergency_level) {
     
     // 在独立线程中立即执行
     pthread_t emergency_thread;
-    pthread_create(&emergency_thread, NULL, emergency_thread_wrapper, &emergency_response);
+    if (pthread_create(&emergency_thread, NULL, emergency_thread_wrapper, job) != 0) {
+        free(job);
+        emergency_job_release(ctx);
+        return;
+    }
     pthread_detach(emergency_thread);
 }
 
-int32_t re_init_integrated(void) {
-    if (subsystem_state.initialized) return 0;
-    
-    printf("[RESPONSE] 初始化集成响应系统...\n");
+re_ctx_t* re_ctx_default(void) {
+    return &default_ctx;
+}
+
+int32_t re_ctx_get_last_report(re_ctx_t* ctx, execution_report_t* report) {
+    if (!ctx || !report || !ctx->initialized) return RESPONSE_ERROR_INVALID_PARAM;
     
-    if (pthread_mutex_init(&subsystem_state.lock, NULL) != 0) return -1;
-    if (!check_hardware_readiness()) {
-        printf("[RESPONSE] 硬件子系统检查失败\n");
-        return -2;
-    }
-    if (init_network_subsystem() != 0) {
-        printf("[RESPONSE] 网络子系统初始化失败\n");
-        return -3;
-    }
-    if (init_access_control() != 0) {
-        printf("[RESPONSE] 门禁子系统初始化失败\n");
-        return -4;
-    }
+    pthread_mutex_lock(&ctx->lock);
+    *report = ctx->last_report;
+    pthread_mutex_unlock(&ctx->lock);
+    return RESPONSE_SUCCESS;
+}
+
+system_mode_t re_ctx_get_system_status(re_ctx_t* ctx) {
+    if (!ctx || !ctx->initialized) return MODE_NORMAL;
     
-    subsystem_state.initialized = true;
-    subsystem_state.emergency_mode = false;
-    subsystem_state.current_level = 0;
+    pthread_mutex_lock(&ctx->lock);
+    system_mode_t mode = ctx->mode;
+    pthread_mutex_unlock(&ctx->lock);
+    return mode;
+}
+
+bool re_ctx_staged(re_ctx_t* ctx) {
+    if (!ctx || !ctx->initialized) return false;
     
-    printf("[RESPONSE] 集成响应系统初始化完成\n");
-    return 0;
+    pthread_mutex_lock(&ctx->lock);
+    bool staged = ctx->stage.state == STAGE_READY;
+    pthread_mutex_unlock(&ctx->lock);
+    return staged;
+}
+
+// === 默认上下文兼容接口 ===
+
+int32_t re_init_integrated(void) {
+    return ctx_init(&default_ctx, NULL);
+}
+
+int32_t re_execute_integrated(const integrated_response_t* response) {
+    return re_ctx_execute(&default_ctx, response);
+}
+
+void re_emergency_sequence(uint8_t emergency_level) {
+    re_ctx_emergency_sequence(&default_ctx, emergency_level);
 }
 
 execution_report_t* re_get_last_report(void) {
-    return &subsystem_state.last_report;
+    return &default_ctx.last_report;
+}
+
+system_mode_t re_get_system_status(void) {
+    return re_ctx_get_system_status(&default_ctx);
+}
+
+bool re_validate_parameters(const integrated_response_t* response) {
+    if (!response) return false;
+    if (response->type < RESPONSE_LOCKDOWN || response->type >= RESPONSE_TYPE_COUNT) return false;
+    if (response->severity < 1 || response->severity > 10) return false;
+    if (response->auth_level < AUTH_LEVEL_1 || response->auth_level > AUTH_LEVEL_5) return false;
+    // 触发事件描述必须以 NUL 结尾
+    return memchr(response->trigger_event, '\0', sizeof(response->trigger_event)) != NULL;
 }
 
 bool re_subsystem_ready(void) {
-    return subsystem_state.initialized && !subsystem_state.emergency_mode && check_hardware_readiness();
+    return default_ctx.initialized && !default_ctx.emergency_mode && check_hardware_readiness();
+}
+
+int32_t re_shutdown(uint32_t deadline_ms) {
+    re_ctx_t* ctx = &default_ctx;
+    if (!ctx->initialized) return RESPONSE_SUCCESS;
+    
+    printf("[RESPONSE] 停止接收新响应，排空在途工作...\n");
+    if (ctx_drain(ctx, deadline_ms) != 0) {
+        // 不在执行中途撤销，保持关闭状态等待调用者重试
+        printf("[RESPONSE] 在途响应未在期限内完成，暂不撤销资源\n");
+        re_evlog_emit(RE_EV_STEP_FAIL, RE_SUB_CORE, 0, 0, RESPONSE_ERROR_TIMEOUT, "drain");
+        re_evlog_flush();
+        return RESPONSE_ERROR_TIMEOUT;
+    }
+    
+    ctx_teardown(ctx);
+    ctx_release(ctx);
+    re_evlog_emit(RE_EV_SHUTDOWN, RE_SUB_CORE, 0, 0, 0, NULL);
+    re_evlog_flush();
+    return RESPONSE_SUCCESS;
 }
 
 void re_cleanup_resources(void) {
     printf("[RESPONSE] 清理响应系统资源...\n");
     
-    if (subsystem_state.initialized) {
-        restore_normal_access();
-        cleanup_network_rules();
-        stop_emergency_services();
-        pthread_mutex_destroy(&subsystem_state.lock);
-        subsystem_state.initialized = false;
+    if (re_shutdown(RE_SHUTDOWN_DEFAULT_DEADLINE_MS) != RESPONSE_SUCCESS) {
+        printf("[RESPONSE] 资源清理未完成\n");
+        return;
     }
+    // 之后仍有写入时 re_aio 会重新建立 ring
+    re_aio_shutdown();
     
     printf("[RESPONSE] 资源清理完成\n");
-}
\ No newline at end of file
+}
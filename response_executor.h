@@ -25,7 +25,9 @@ typedef enum {
     RESPONSE_BACKUP_ACTIVATE,        // Backup system activation
     RESPONSE_COMMS_PRIORITY,         // Communication priority routing
     RESPONSE_PARTIAL_CONTAIN,        // Partial containment measures
-    RESPONSE_FULL_RECOVERY           // Full system recovery
+    RESPONSE_FULL_RECOVERY,          // Full system recovery
+    RESPONSE_HEIGHTENED_SURVEILLANCE, // Enhanced surveillance only
+    RESPONSE_TYPE_COUNT              // One past the last type, not a response
 } response_type_t;
 
 // System operation mode
@@ -46,6 +48,9 @@ typedef enum {
     RESPONSE_ERROR_NETWORK_FAILURE = -4, // Network operation failed
     RESPONSE_ERROR_ACCESS_DENIED = -5, // Insufficient permissions
     RESPONSE_ERROR_TIMEOUT = -6,     // Operation timed out
+    RESPONSE_ERROR_CONFLICT = -7,    // Superseded by a conflicting higher-priority response
+    RESPONSE_ERROR_SHUTDOWN = -8,    // Executor is shutting down
+    RESPONSE_ERROR_QUEUE_FULL = -9,  // Submission queue has no free slot
     RESPONSE_ERROR_CRITICAL_FAILURE = -99 // Critical system failure
 } response_error_t;
 
@@ -115,8 +120,17 @@ int32_t re_init_integrated(void);
  * Processes the provided response request and coordinates all required
  * subsystems to execute the emergency procedure.
  * 
+ * May be called concurrently. Each call is checked against in-flight
+ * responses for contradictory actions on the same resource and zones
+ * (e.g. locking doors that an evacuation is unlocking). A higher-priority
+ * response waits for the conflicting lower-priority ones to finish so its
+ * state is applied last; a lower-priority response gives up the
+ * conflicting zones. Non-conflicting responses run in parallel.
+ * 
  * @param response Pointer to the response parameters structure
- * @return RESPONSE_SUCCESS on success, error code on failure
+ * @return RESPONSE_SUCCESS on success, RESPONSE_ERROR_CONFLICT if every
+ *         target zone is held by a higher-priority response, error code
+ *         on failure
  */
 int32_t re_execute_integrated(const integrated_response_t* response);
 
@@ -136,6 +150,11 @@ execution_report_t* re_get_last_report(void);
  * Immediate execution of emergency procedures bypassing normal checks.
  * Used for critical situations requiring instant response.
  * 
+ * The level selects a response tier so lower levels disrupt less:
+ * 1-3 heightened surveillance, 4-7 network isolation, 8-10 full lockdown,
+ * all over every zone. A level whose tier is not above the tier already
+ * in effect is recorded but triggers nothing new. Runs asynchronously.
+ * 
  * @param emergency_level Emergency level (1-10, higher = more critical)
  */
 void re_emergency_sequence(uint8_t emergency_level);
@@ -173,10 +192,131 @@ system_mode_t re_get_system_status(void);
  * @brief Cleanup system resources
  * 
  * Safely shuts down all subsystems and releases allocated resources.
- * Should be called during system shutdown.
+ * Should be called during system shutdown. Equivalent to
+ * re_shutdown(RE_SHUTDOWN_DEFAULT_DEADLINE_MS); if in-flight work does
+ * not drain in time nothing is torn down and the call can be repeated.
  */
 void re_cleanup_resources(void);
 
+#define RE_SHUTDOWN_DEFAULT_DEADLINE_MS  5000
+
+/**
+ * @brief Drain in-flight work and shut down within a deadline
+ * 
+ * New responses and emergency sequences are refused with
+ * RESPONSE_ERROR_SHUTDOWN from the moment this is called. Responses still
+ * waiting on a conflict are cancelled; responses already executing run to
+ * completion so no response is left half-applied. Once drained, logs and
+ * the state journal are flushed and the subsystems are torn down in
+ * parallel.
+ * 
+ * @param deadline_ms Time allowed for draining, 0 to wait until every
+ *                    in-flight response has finished (pass
+ *                    RE_SHUTDOWN_DEFAULT_DEADLINE_MS for the default bound)
+ * @return RESPONSE_SUCCESS when shut down, RESPONSE_ERROR_TIMEOUT if work
+ *         was still executing at the deadline (nothing was torn down; the
+ *         executor stays closed and the call can be repeated)
+ */
+int32_t re_shutdown(uint32_t deadline_ms);
+
+// ============================================================================
+// EXECUTOR CONTEXTS
+// ============================================================================
+
+/**
+ * Independent executor instances, one per site. Each context has its own
+ * mode, emergency level, active zone state, in-flight plan table, report
+ * and iptables chain ("CASSIE_<site>"), so responses on one site never
+ * wait on another site's lock. The functions above operate on a built-in
+ * default context.
+ *
+ * Device registries (door controllers, services, backup volumes, comms,
+ * quarantine and the XDP filter) stay process-wide; sites sharing a
+ * process should use disjoint zones.
+ */
+
+#define RE_CTX_NAME_MAX        32
+#define RE_CTX_CHAIN_NAME_MAX  21    // Site names longer than this do not fit an iptables chain
+
+typedef struct re_ctx re_ctx_t;
+
+/**
+ * @brief Create and initialize an executor context
+ * 
+ * @param site_name Site name, 1-21 characters of [A-Za-z0-9_-]
+ * @return New context, NULL if the name is invalid or initialization failed
+ */
+re_ctx_t* re_ctx_create(const char* site_name);
+
+/**
+ * @brief The built-in context used by the functions without a context argument
+ * 
+ * @return Default context (initialized by re_init_integrated())
+ */
+re_ctx_t* re_ctx_default(void);
+
+/**
+ * @brief Execute an integrated response on a context
+ * 
+ * Same semantics as re_execute_integrated(), scoped to the context.
+ * 
+ * @param ctx Executor context
+ * @param response Pointer to the response parameters structure
+ * @return RESPONSE_SUCCESS on success, error code on failure
+ */
+int32_t re_ctx_execute(re_ctx_t* ctx, const integrated_response_t* response);
+
+/**
+ * @brief Run the emergency sequence on a context
+ * 
+ * @param ctx Executor context
+ * @param emergency_level Emergency level (1-10)
+ */
+void re_ctx_emergency_sequence(re_ctx_t* ctx, uint8_t emergency_level);
+
+/**
+ * @brief Copy the last execution report of a context
+ * 
+ * @param ctx Executor context
+ * @param report Receives the report
+ * @return RESPONSE_SUCCESS on success, error code on failure
+ */
+int32_t re_ctx_get_last_report(re_ctx_t* ctx, execution_report_t* report);
+
+/**
+ * @brief Get the current mode of a context
+ * 
+ * @param ctx Executor context
+ * @return Current system mode
+ */
+system_mode_t re_ctx_get_system_status(re_ctx_t* ctx);
+
+/**
+ * @brief Whether escalation work is staged for a context
+ *
+ * Entering MODE_HEIGHTENED_SECURITY stages the likely next steps in the
+ * background without side effects on traffic or doors: the isolation chain
+ * is created empty and its rules pre-rendered, controller sessions are
+ * opened and warm standbys thawed (default context only, as these are
+ * process-wide). An escalation then commits in one step; a return to
+ * MODE_NORMAL or a shutdown discards the staged work.
+ *
+ * @param ctx Executor context
+ * @return true once staging has completed and not yet been discarded
+ */
+bool re_ctx_staged(re_ctx_t* ctx);
+
+/**
+ * @brief Destroy a context created by re_ctx_create()
+ * 
+ * Refuses new work, cancels responses waiting on a conflict, waits for
+ * executing responses and emergency sequences of the context, then
+ * restores its doors, removes its iptables chain and frees it.
+ * 
+ * @param ctx Executor context (NULL is ignored)
+ */
+void re_ctx_destroy(re_ctx_t* ctx);
+
 /**
  * @brief Validate response parameters
  * 